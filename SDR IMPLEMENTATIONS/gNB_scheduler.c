@@ -47,6 +47,10 @@
 //#include "nru_lbt.h"
 #include "common/ran_context.h" // For MAX_NUM_CCs
 #include "common/utils/nru_lbt.h"
+#include "NR_MAC_gNB/nru_mac_stats.h"
+#include "NR_MAC_gNB/nru_ue_rate.h"
+#include "NR_MAC_gNB/nru_sched_prof.h"
+#include "common/utils/nru_clock.h"
 
 #ifndef MAX_NUM_CCs
 #define MAX_NUM_CCs 1
@@ -247,7 +251,11 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
   NR_COMMON_channels_t *cc = gNB->common_channels;
   NR_ServingCellConfigCommon_t *scc = cc->ServingCellConfigCommon;
 
+  // Stats formatter starts outside the lock (no-op after the first slot)
+  nru_mac_stats_init();
+  nru_sched_prof_slot_begin(frame, slot, 10000 / gNB->frame_structure.numb_slots_frame);
   NR_SCHED_LOCK(&gNB->sched_lock);
+  NRU_PROF_LAP(NRU_PROF_LOCK);
 
   /* ---------------------------------------------------------- */
   /*                NR-U Coexistence Integration                */
@@ -261,18 +269,19 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
         LOG_D(MAC, "[NRU][LBT] PRACH slot %d.%d → bypass sensing\n", frame, slot);
         channel_free = true;
     } else if (strcmp(cfg->mode, "LBE") == 0) {
-        int sense_result = nru_lbt_sense_and_acquire(module_idP, 1000);
+        int sense_result = nru_lbt_slot_acquire(module_idP, frame, slot, 1000);
         channel_free = (sense_result == 1);
     } else if (strcmp(cfg->mode, "FBE") == 0) {
         nru_fbe_heartbeat();
     }
 }
-
+  NRU_PROF_LAP(NRU_PROF_LBT);
 
   if (!channel_free) {
     LOG_I(MAC,
           "[NRU][SCHED] Frame %d Slot %d: Channel BUSY → skip DL/UL scheduling\n",
           frame, slot);
+    NRU_PROF_SLOT_END();
     NR_SCHED_UNLOCK(&gNB->sched_lock);
     return;
   }
@@ -280,21 +289,11 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
   int slots_frame = gNB->frame_structure.numb_slots_frame;
 
   /* ----------------------------------------------------------
- * NR-U: Trigger SSB/BCH scheduling with Listen-Before-Talk
- * ---------------------------------------------------------- */
-  if (IS_SA_MODE(get_softmodem_params())) {
-    if (nru_lbt_sense_and_acquire(module_idP, -1)) {
-        LOG_I(MAC,
-              "[NRU][SSB]  Channel free - scheduling BCH/SSB (frame=%d, slot=%d)\n",
-              frame, slot);
-        schedule_nr_mib(module_idP, frame, slot, &sched_info->DL_req);
-
-    } else {
-        LOG_I(MAC,
-              "[NRU][SSB]  Channel busy - skipping BCH/SSB (frame=%d, slot=%d)\n",
-              frame, slot);
-    }
-}
+   * NR-U discovery burst: SSB/SIB1 only inside the DRS window,
+   * gated by one Type 2A LBT per window (cached per slot)
+   * ---------------------------------------------------------- */
+  const bool drs_clear = nru_drs_acquire(module_idP, frame, slot, slots_frame);
+  NRU_PROF_LAP(NRU_PROF_SSB_LBT);
 
   clear_beam_information(&gNB->beam_info, frame, slot, slots_frame);
 
@@ -329,32 +328,40 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
                                &sched_info->TX_req,
                                &sched_info->UL_dci_req);
   }
+  NRU_PROF_LAP(NRU_PROF_CLEAR);
 
   bool wait_prach_completed =
       gNB->num_scheduled_prach_rx >= NUM_PRACH_RX_FOR_NOISE_ESTIMATE;
 
   if ((wait_prach_completed || get_softmodem_params()->phy_test) &&
       (slot == 0) && (frame & 127) == 0) {
-    char stats_output[32656] = {0};
-    dump_mac_stats(gNB, stats_output, sizeof(stats_output), true);
-    LOG_I(NR_MAC, "Frame.Slot %d.%d\n%s\n", frame, slot, stats_output);
+    // Counters only; formatting and logging run on the stats thread
+    nru_mac_stats_capture(gNB, frame, slot);
   }
+  NRU_PROF_LAP(NRU_PROF_STATS);
 
   nr_measgap_scheduling(gNB, frame, slot);
   nr_mac_update_timers(module_idP, frame, slot);
+  NRU_PROF_LAP(NRU_PROF_TIMERS);
 
   if ((wait_prach_completed || get_softmodem_params()->phy_test)) {
-    schedule_nr_mib(module_idP, frame, slot, &sched_info->DL_req);
+    if (drs_clear) {
+      schedule_nr_mib(module_idP, frame, slot, &sched_info->DL_req);
+      if (IS_SA_MODE(get_softmodem_params()))
+        schedule_nr_sib1(module_idP, frame, slot,
+                         &sched_info->DL_req, &sched_info->TX_req);
+    }
 
-    if (IS_SA_MODE(get_softmodem_params())) {
-      schedule_nr_sib1(module_idP, frame, slot,
-                       &sched_info->DL_req, &sched_info->TX_req);
+    if (IS_SA_MODE(get_softmodem_params()))
       schedule_nr_other_sib(module_idP, frame, slot,
                             &sched_info->DL_req, &sched_info->TX_req);
-    }
   }
+  NRU_PROF_LAP(NRU_PROF_MIB_SIB);
 
-  if (get_softmodem_params()->phy_test == 0) {
+  // NR-U: once noise estimation is done, only open PRACH occasions while
+  // the LBE channel has been stable (avoids occasions UEs cannot win)
+  if (get_softmodem_params()->phy_test == 0 &&
+      (!wait_prach_completed || nru_lbt_is_stable_for_ue_access())) {
     const int n_slots_ahead = slots_frame - cc->prach_len +
                               get_NTN_Koffset(scc);
     const frame_t f =
@@ -362,10 +369,14 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
     const slot_t s = (slot + n_slots_ahead) % slots_frame;
     schedule_nr_prach(module_idP, f, s);
   }
+  NRU_PROF_LAP(NRU_PROF_PRACH);
 
   nr_csirs_scheduling(module_idP, frame, slot, &sched_info->DL_req);
+  NRU_PROF_LAP(NRU_PROF_CSIRS);
   nr_csi_meas_reporting(module_idP, frame, slot);
+  NRU_PROF_LAP(NRU_PROF_CSI_REPORT);
   nr_schedule_srs(module_idP, frame, slot);
+  NRU_PROF_LAP(NRU_PROF_SRS);
 
   if (get_softmodem_params()->phy_test == 0) {
     nr_schedule_RA(module_idP, frame, slot,
@@ -373,37 +384,28 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
                    &sched_info->DL_req,
                    &sched_info->TX_req);
   }
+  NRU_PROF_LAP(NRU_PROF_RA);
 
   start_meas(&gNB->schedule_ulsch);
   nr_schedule_ulsch(module_idP, frame, slot, &sched_info->UL_dci_req);
   stop_meas(&gNB->schedule_ulsch);
+  NRU_PROF_LAP(NRU_PROF_ULSCH);
 
   start_meas(&gNB->schedule_dlsch);
   nr_schedule_ue_spec(module_idP, frame, slot,
                       &sched_info->DL_req, &sched_info->TX_req);
   stop_meas(&gNB->schedule_dlsch);
+  NRU_PROF_LAP(NRU_PROF_DLSCH);
 
   /* -------------------------------------------------------
-   * NR-U Throughput Logging (for adaptive coexistence)
+   * NR-U per-UE throughput (read by coexistence control/stats)
    * ------------------------------------------------------ */
-  NR_UEs_t *UE_info = &gNB->UE_info;
-  if (UE_info->connected_ue_list == NULL) {
-      LOG_I(MAC, "[NRU][THROUGHPUT] No active UEs — waiting for connection...\n");
-  }
-
-  UE_iterator(UE_info->connected_ue_list, UE) {
-    NR_UE_sched_ctrl_t *sched_ctrl = &UE->UE_sched_ctrl;
-    NR_mac_stats_t *stats = &UE->mac_stats;
-
-    LOG_I(MAC,
-          "[NRU][THROUGHPUT] Frame %d Slot %d UE RNTI=0x%04x: DL %.2f Mbit/s | UL %.2f Mbit/s\n",
-          frame, slot, UE->rnti,
-          (float)(stats->dl.current_bytes * 8e-6),
-          (float)(stats->ul.current_bytes * 8e-6));
-  }
+  nru_ue_rate_update(gNB, nru_clock_now_us());
+  NRU_PROF_LAP(NRU_PROF_UE_RATE);
 
   nr_sr_reporting(gNB, frame, slot);
   nr_schedule_pucch(gNB, frame, slot);
+  NRU_PROF_LAP(NRU_PROF_PUCCH);
 
   AssertFatal(MAX_NUM_CCs == 1, "only 1 CC supported\n");
   const int current_index =
@@ -411,6 +413,8 @@ void gNB_dlsch_ulsch_scheduler(module_id_t module_idP,
                       gNB->UL_tti_req_ahead_size);
   copy_ul_tti_req(&sched_info->UL_tti_req,
                   &gNB->UL_tti_req_ahead[0][current_index]);
+  NRU_PROF_LAP(NRU_PROF_UL_TTI);
+  NRU_PROF_SLOT_END();
 
   stop_meas(&gNB->gNB_scheduler);
   NR_SCHED_UNLOCK(&gNB->sched_lock);
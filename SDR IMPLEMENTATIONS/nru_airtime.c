@@ -0,0 +1,257 @@
+/*
+ * NR-U Airtime Accountant
+ * -----------------------
+ * The writer appends bursts to a ring of {start, end} and publishes the
+ * head; only the newest entry is still extended. The reader folds every
+ * closed entry into a running sum per window, and retires entries from
+ * each window's tail once they end before the window start. Used time is
+ *   sum - (part of the tail entry before the window) + (newest entry)
+ * so the result is exact, not bucketed. The writer never overwrites an
+ * entry a window still holds: when the ring is full it extends the newest
+ * burst instead (over-counts, never under-counts).
+ *
+ * Statistics are published behind a seqlock.
+ *
+ * Location: common/utils/nru_airtime.c
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#ifdef NRU_LBT_STANDALONE
+#include "nru_clock.h"
+#include "nru_seqlock.h"
+#include "nru_airtime.h"
+#else
+#include "common/utils/nru_clock.h"
+#include "common/utils/nru_seqlock.h"
+#include "common/utils/nru_airtime.h"
+#endif
+
+typedef struct {
+    atomic_ullong start_us;
+    atomic_ullong end_us;
+} air_burst_t;
+
+// Burst ring (writer appends, reader retires)
+static NRU_TLS air_burst_t air_log[NRU_AIRTIME_LOG];
+static NRU_TLS atomic_ullong air_head;
+static NRU_TLS atomic_ullong air_reader_tail;    // Oldest entry a window still holds
+static NRU_TLS atomic_bool air_enabled;          // Any window configured
+
+// Reader state
+static NRU_TLS nru_airtime_cfg_t air_cfg;
+static NRU_TLS int n_windows;
+static NRU_TLS uint64_t air_first;               // Entries before this are ignored (reset)
+static NRU_TLS uint64_t air_absorbed;            // Closed entries folded into the sums
+static NRU_TLS uint64_t win_tail[NRU_AIRTIME_MAX_HORIZONS];
+static NRU_TLS uint64_t win_sum_us[NRU_AIRTIME_MAX_HORIZONS];
+static NRU_TLS uint64_t n_granted, n_shortened, n_denied;
+
+// Published statistics
+static NRU_TLS uint32_t pub_seq;
+static NRU_TLS nru_airtime_t pub;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static inline air_burst_t *entry(uint64_t idx) {
+    return &air_log[idx & (NRU_AIRTIME_LOG - 1)];
+}
+
+static inline uint64_t entry_start(uint64_t idx) {
+    return atomic_load_explicit(&entry(idx)->start_us, memory_order_relaxed);
+}
+
+static inline uint64_t entry_end(uint64_t idx) {
+    return atomic_load_explicit(&entry(idx)->end_us, memory_order_acquire);
+}
+
+// Fold entries the writer has closed (all but the newest) into every window
+static void absorb_closed(uint64_t head) {
+    while (air_absorbed + 1 < head) {
+        const uint64_t d = entry_end(air_absorbed) - entry_start(air_absorbed);
+        for (int k = 0; k < n_windows; k++)
+            win_sum_us[k] += d;
+        air_absorbed++;
+    }
+}
+
+static uint64_t window_used(int k, uint64_t now_us, uint64_t head) {
+    const uint64_t horizon_us = (uint64_t)air_cfg.horizon_ms[k] * 1000ULL;
+    const uint64_t ws = now_us > horizon_us ? now_us - horizon_us : 0;
+
+    while (win_tail[k] < air_absorbed && entry_end(win_tail[k]) <= ws) {
+        win_sum_us[k] -= entry_end(win_tail[k]) - entry_start(win_tail[k]);
+        win_tail[k]++;
+    }
+
+    uint64_t used = win_sum_us[k];
+    if (win_tail[k] < air_absorbed && entry_start(win_tail[k]) < ws)
+        used -= ws - entry_start(win_tail[k]);
+    if (head > air_absorbed) {
+        const uint64_t s = entry_start(head - 1), e = entry_end(head - 1);
+        const uint64_t from = s > ws ? s : ws;
+        if (e > from)
+            used += e - from;
+    }
+    return used;
+}
+
+static void publish_tail(void) {
+    uint64_t tail = air_absorbed;
+    for (int k = 0; k < n_windows; k++)
+        if (win_tail[k] < tail)
+            tail = win_tail[k];
+    atomic_store_explicit(&air_reader_tail, tail, memory_order_release);
+}
+
+static void publish(uint64_t now_us, const uint64_t *used) {
+    nru_seq_write_begin(&pub_seq);
+    pub.n_horizons = (uint32_t)n_windows;
+    for (int k = 0; k < n_windows; k++) {
+        pub.horizon_ms[k] = air_cfg.horizon_ms[k];
+        pub.max_duty[k] = air_cfg.max_duty[k];
+        pub.duty[k] = used[k] / (air_cfg.horizon_ms[k] * 1000.0);
+    }
+    pub.updated_us = now_us;
+    pub.bursts = atomic_load_explicit(&air_head, memory_order_relaxed) - air_first;
+    pub.granted = n_granted;
+    pub.shortened = n_shortened;
+    pub.denied = n_denied;
+    nru_seq_write_end(&pub_seq);
+}
+
+// ---------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------
+void nru_airtime_record(uint64_t start_us, uint64_t end_us) {
+    if (end_us <= start_us || !atomic_load_explicit(&air_enabled, memory_order_relaxed))
+        return;
+
+    const uint64_t head = atomic_load_explicit(&air_head, memory_order_relaxed);
+    if (head > 0) {
+        air_burst_t *last = entry(head - 1);
+        const uint64_t last_start = atomic_load_explicit(&last->start_us, memory_order_relaxed);
+        const uint64_t last_end = atomic_load_explicit(&last->end_us, memory_order_relaxed);
+        const bool contiguous = start_us >= last_start && start_us <= last_end + NRU_AIRTIME_MERGE_GAP_US;
+        const bool full = head - atomic_load_explicit(&air_reader_tail, memory_order_acquire)
+                          >= NRU_AIRTIME_LOG - 1;
+        if (contiguous || full) {
+            if (end_us > last_end)
+                atomic_store_explicit(&last->end_us, end_us, memory_order_release);
+            return;
+        }
+    }
+    air_burst_t *b = entry(head);
+    atomic_store_explicit(&b->start_us, start_us, memory_order_relaxed);
+    atomic_store_explicit(&b->end_us, end_us, memory_order_relaxed);
+    atomic_store_explicit(&air_head, head + 1, memory_order_release);
+}
+
+// ---------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------
+void nru_airtime_configure(const nru_airtime_cfg_t *cfg) {
+    memset(&air_cfg, 0, sizeof(air_cfg));
+    n_windows = 0;
+    if (cfg) {
+        for (int k = 0; k < NRU_AIRTIME_MAX_HORIZONS && cfg->horizon_ms[k] > 0; k++) {
+            air_cfg.horizon_ms[k] = cfg->horizon_ms[k];
+            air_cfg.max_duty[k] = cfg->max_duty[k];
+            n_windows++;
+        }
+        air_cfg.min_grant_us = cfg->min_grant_us;
+    }
+    if (!air_cfg.min_grant_us)
+        air_cfg.min_grant_us = NRU_AIRTIME_DEFAULT_MIN_GRANT_US;
+
+    // Rebuild every window from the oldest entry still held
+    const uint64_t head = atomic_load_explicit(&air_head, memory_order_acquire);
+    if (air_absorbed < air_first)
+        air_absorbed = air_first;
+    const uint64_t tail = atomic_load_explicit(&air_reader_tail, memory_order_relaxed);
+    const uint64_t from = tail > air_first ? tail : air_first;
+    uint64_t sum = 0;
+    for (uint64_t i = from; i < air_absorbed; i++)
+        sum += entry_end(i) - entry_start(i);
+    for (int k = 0; k < n_windows; k++) {
+        win_tail[k] = from;
+        win_sum_us[k] = sum;
+    }
+    absorb_closed(head);
+    publish_tail();
+    atomic_store_explicit(&air_enabled, n_windows > 0, memory_order_relaxed);
+}
+
+uint64_t nru_airtime_used_us(int k, uint64_t now_us) {
+    if (k < 0 || k >= n_windows)
+        return 0;
+    const uint64_t head = atomic_load_explicit(&air_head, memory_order_acquire);
+    absorb_closed(head);
+    const uint64_t used = window_used(k, now_us, head);
+    publish_tail();
+    return used;
+}
+
+uint64_t nru_airtime_grant_us(uint64_t now_us, uint64_t committed_until_us, uint64_t want_us) {
+    if (n_windows == 0)
+        return want_us;
+
+    const uint64_t head = atomic_load_explicit(&air_head, memory_order_acquire);
+    absorb_closed(head);
+
+    // Granted but not yet on the books: from the newest booked end on
+    uint64_t booked_end = now_us;
+    if (head > air_first) {
+        const uint64_t e = entry_end(head - 1);
+        if (e > booked_end) booked_end = e;
+    }
+    const uint64_t pending = committed_until_us > booked_end ? committed_until_us - booked_end : 0;
+
+    uint64_t grant = want_us;
+    uint64_t used[NRU_AIRTIME_MAX_HORIZONS];
+    for (int k = 0; k < n_windows; k++) {
+        used[k] = window_used(k, now_us, head) + pending;
+        const double cap = air_cfg.max_duty[k];
+        if (cap <= 0.0 || cap >= 1.0)
+            continue;
+        const uint64_t allowed = (uint64_t)(cap * air_cfg.horizon_ms[k] * 1000.0);
+        const uint64_t left = allowed > used[k] ? allowed - used[k] : 0;
+        if (left < grant)
+            grant = left;
+    }
+    publish_tail();
+
+    if (grant < air_cfg.min_grant_us && grant < want_us) {
+        grant = 0;
+        n_denied++;
+    } else if (grant < want_us) {
+        n_shortened++;
+    } else {
+        n_granted++;
+    }
+    publish(now_us, used);
+    return grant;
+}
+
+void nru_airtime_get(nru_airtime_t *out) {
+    if (!out) return;
+    uint32_t seq;
+    do {
+        seq = nru_seq_read_begin(&pub_seq);
+        *out = pub;
+    } while (nru_seq_read_retry(&pub_seq, seq));
+}
+
+void nru_airtime_reset(void) {
+    air_first = atomic_load_explicit(&air_head, memory_order_acquire);
+    air_absorbed = air_first;
+    for (int k = 0; k < n_windows; k++) {
+        win_tail[k] = air_first;
+        win_sum_us[k] = 0;
+    }
+    n_granted = n_shortened = n_denied = 0;
+    publish_tail();
+    uint64_t used[NRU_AIRTIME_MAX_HORIZONS] = {0};
+    publish(nru_clock_now_us(), used);
+}
@@ -0,0 +1,109 @@
+/*
+ * NR-U Airtime Accountant Header
+ * ------------------------------
+ * Books the bursts we actually transmitted (from the TX path, radio time)
+ * and keeps the exact duty cycle over up to NRU_AIRTIME_MAX_HORIZONS
+ * sliding windows. The LBT core asks it for a grant before opening a COT:
+ * the grant is shortened or refused so that no window exceeds its cap,
+ * in LBE and FBE alike.
+ *
+ * One writer (the TX path, nru_airtime_record) and one reader (the LBT
+ * caller, nru_airtime_grant_us / nru_airtime_used_us; nru_lbt.c serializes
+ * its scheduler and async callers). Each query is O(1)
+ * amortized per window: every burst enters and leaves each window once.
+ * Published statistics are lock-free from any thread.
+ *
+ * Location: common/utils/nru_airtime.h
+ */
+
+#ifndef NRU_AIRTIME_H
+#define NRU_AIRTIME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_AIRTIME_MAX_HORIZONS     4
+#define NRU_AIRTIME_LOG              16384     // Bursts held (power of two)
+#define NRU_AIRTIME_MERGE_GAP_US     2         // Closer writes form one burst
+#define NRU_AIRTIME_DEFAULT_MIN_GRANT_US 500   // Shorter grants are refused
+
+/**
+ * Windows and caps (horizon_ms = 0 ends the list; max_duty <= 0 or >= 1
+ * tracks the window without capping it)
+ */
+typedef struct {
+    uint32_t horizon_ms[NRU_AIRTIME_MAX_HORIZONS];
+    double max_duty[NRU_AIRTIME_MAX_HORIZONS];
+    uint32_t min_grant_us;             // 0 = NRU_AIRTIME_DEFAULT_MIN_GRANT_US
+} nru_airtime_cfg_t;
+
+/**
+ * Published statistics (as of the latest reader query)
+ */
+typedef struct {
+    uint32_t n_horizons;
+    uint32_t horizon_ms[NRU_AIRTIME_MAX_HORIZONS];
+    double max_duty[NRU_AIRTIME_MAX_HORIZONS];
+    double duty[NRU_AIRTIME_MAX_HORIZONS];      // Used / horizon
+    uint64_t updated_us;
+    uint64_t bursts;                   // Bursts booked since reset
+    uint64_t granted;                  // Grants at the requested length
+    uint64_t shortened;                // Grants cut to the remaining budget
+    uint64_t denied;                   // Requests refused (budget < min grant)
+} nru_airtime_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Set windows and caps (reader thread; keeps the booked bursts)
+ */
+void nru_airtime_configure(const nru_airtime_cfg_t *cfg);
+
+/**
+ * Book one transmitted span (writer: the TX path)
+ * Contiguous spans extend the current burst.
+ * @param start_us, end_us: nru_clock time of the first sample and past the last
+ */
+void nru_airtime_record(uint64_t start_us, uint64_t end_us);
+
+/**
+ * Air time booked in window k from now_us - horizon on (future parts of
+ * booked bursts included)
+ */
+uint64_t nru_airtime_used_us(int k, uint64_t now_us);
+
+/**
+ * Length of COT the caps allow from now_us
+ * Air time between now_us and committed_until_us (a COT already granted,
+ * not yet booked by the TX path) counts as used.
+ * @param want_us: Requested COT length
+ * @return: want_us, less if a window is near its cap, 0 if below the
+ *          minimum grant
+ */
+uint64_t nru_airtime_grant_us(uint64_t now_us, uint64_t committed_until_us, uint64_t want_us);
+
+/**
+ * Read the latest statistics
+ */
+void nru_airtime_get(nru_airtime_t *out);
+
+/**
+ * Forget booked bursts and counters
+ */
+void nru_airtime_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_AIRTIME_H */
@@ -0,0 +1,188 @@
+/*
+ * NR-U Sensing Channelizer
+ * ------------------------
+ * Design: pass edge fp = 0.95 * bw/2, stop edge fs = 1.10 * bw/2 (Wi-Fi
+ * in the adjacent channel occupies from about 0.53 * bw off centre),
+ * Kaiser window for 60 dB, cutoff midway. The output rate is the highest
+ * integer decimation that still keeps aliases out of the passband
+ * (rate_out >= fp + fs). Only every decim-th output is computed, which is
+ * the polyphase decimator without the branch bookkeeping.
+ *
+ * Input is appended to a history of n_taps - 1 samples, so blocks can be
+ * fed in any size; the kernel is nru_fir_decim_fc32() (nru_dsp.cpp).
+ *
+ * The frequency shift rotates a unit phasor by a fixed step per sample
+ * instead of evaluating cos/sin; the phasor is pulled back to unit length
+ * every SHIFT_RENORM samples and re-seeded from the exact phase per block.
+ *
+ * Location: common/utils/nru_channelizer.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "common/utils/nru_channelizer.h"
+#include "common/utils/nru_dsp.h"
+
+static const size_t SHIFT_RENORM = 256;   // Samples between magnitude corrections
+
+struct nru_channelizer {
+    double in_rate_hz;
+    double out_rate_hz;
+    size_t decim;
+    size_t n_taps;                     // Multiple of 4 (zero-padded)
+    std::vector<float> taps2;          // Reversed, each tap duplicated for I and Q
+
+    // Frequency shift of an off-centre channel (phase in cycles)
+    bool shift;
+    double shift_step;
+    double shift_phase;
+    double step_re, step_im;           // exp(j 2 pi shift_step)
+
+    std::vector<float> buf;            // History + current block, interleaved
+    size_t have;                       // Valid samples in buf (history part)
+    size_t next;                       // Input index (in buf) of the next output
+};
+
+extern "C" {
+
+/* ============================================
+ *  DESIGN
+ * ============================================ */
+
+// Zeroth-order modified Bessel function (series)
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+nru_channelizer_t *nru_channelizer_create(double in_rate_hz, double channel_bw_hz, double offset_hz) {
+    if (in_rate_hz <= 0.0 || channel_bw_hz <= 0.0)
+        return nullptr;
+
+    const double fp = NRU_CHAN_PASS_FRAC * channel_bw_hz / 2.0;
+    const double fs = NRU_CHAN_STOP_FRAC * channel_bw_hz / 2.0;
+    if (std::fabs(offset_hz) + fs >= in_rate_hz / 2.0)
+        return nullptr;                 // Capture is (about) the channel already
+
+    // Kaiser design (Oppenheim & Schafer 7.6)
+    const double A = NRU_CHAN_ATTEN_DB;
+    const double beta = (A > 50.0) ? 0.1102 * (A - 8.7)
+                                   : 0.5842 * std::pow(A - 21.0, 0.4) + 0.07886 * (A - 21.0);
+    const double dw = 2.0 * M_PI * (fs - fp) / in_rate_hz;
+    size_t n = static_cast<size_t>(std::ceil((A - 8.0) / (2.285 * dw))) + 1;
+    n = std::min<size_t>(n, NRU_CHAN_MAX_TAPS);
+
+    const double fc = (fp + fs) / 2.0 / in_rate_hz;     // Cycles per sample
+    std::vector<double> h(n);
+    double dc = 0.0;
+    const double mid = (n - 1) / 2.0;
+    for (size_t k = 0; k < n; k++) {
+        const double t = k - mid;
+        const double sinc = (t == 0.0) ? 2.0 * fc : std::sin(2.0 * M_PI * fc * t) / (M_PI * t);
+        const double r = (n > 1) ? 2.0 * k / (n - 1) - 1.0 : 0.0;
+        h[k] = sinc * bessel_i0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / bessel_i0(beta);
+        dc += h[k];
+    }
+
+    auto *ch = new nru_channelizer();
+    ch->in_rate_hz = in_rate_hz;
+    ch->decim = std::max<size_t>(1, static_cast<size_t>(std::floor(in_rate_hz / (fp + fs))));
+    ch->out_rate_hz = in_rate_hz / ch->decim;
+    ch->n_taps = (n + 3) / 4 * 4;
+    ch->taps2.assign(2 * ch->n_taps, 0.0f);
+    for (size_t k = 0; k < n; k++) {
+        const float v = static_cast<float>(h[k] / dc);  // Unity DC gain
+        ch->taps2[2 * (ch->n_taps - 1 - k)] = v;
+        ch->taps2[2 * (ch->n_taps - 1 - k) + 1] = v;
+    }
+
+    ch->shift = (offset_hz != 0.0);
+    ch->shift_step = -offset_hz / in_rate_hz;
+    ch->shift_phase = 0.0;
+    ch->step_re = std::cos(2.0 * M_PI * ch->shift_step);
+    ch->step_im = std::sin(2.0 * M_PI * ch->shift_step);
+    nru_channelizer_reset(ch);
+    return ch;
+}
+
+void nru_channelizer_destroy(nru_channelizer_t *ch) {
+    delete ch;
+}
+
+void nru_channelizer_reset(nru_channelizer_t *ch) {
+    if (!ch) return;
+    ch->have = 0;
+    ch->next = ch->n_taps - 1;
+}
+
+/* ============================================
+ *  PROCESSING
+ * ============================================ */
+
+size_t nru_channelizer_process(nru_channelizer_t *ch, const float *iq, size_t n_samples, float *out) {
+    if (!ch || !iq || !out || n_samples == 0)
+        return 0;
+
+    const size_t total = ch->have + n_samples;
+    if (ch->buf.size() < 2 * total)
+        ch->buf.resize(2 * total);
+    float *dst = ch->buf.data() + 2 * ch->have;
+
+    if (ch->shift) {
+        // Move the channel to DC: x * exp(-j 2 pi f0 n / fs)
+        double c = std::cos(2.0 * M_PI * ch->shift_phase);
+        double s = std::sin(2.0 * M_PI * ch->shift_phase);
+        for (size_t k = 0; k < n_samples; k++) {
+            const float re = iq[2 * k], im = iq[2 * k + 1];
+            const float cf = static_cast<float>(c), sf = static_cast<float>(s);
+            dst[2 * k] = re * cf - im * sf;
+            dst[2 * k + 1] = re * sf + im * cf;
+            const double nc = c * ch->step_re - s * ch->step_im;
+            s = c * ch->step_im + s * ch->step_re;
+            c = nc;
+            if ((k + 1) % SHIFT_RENORM == 0) {
+                const double g = 1.5 - 0.5 * (c * c + s * s);   // ~1/|p| near 1
+                c *= g;
+                s *= g;
+            }
+        }
+        const double ph = ch->shift_phase + n_samples * ch->shift_step;
+        ch->shift_phase = ph - std::floor(ph);
+    } else {
+        std::copy(iq, iq + 2 * n_samples, dst);
+    }
+
+    size_t n_out = 0;
+    if (ch->next < total)
+        n_out = nru_fir_decim_fc32(ch->buf.data(), total, ch->taps2.data(), ch->n_taps,
+                                   ch->decim, ch->next, out);
+    ch->next += n_out * ch->decim;
+
+    // Keep the last n_taps - 1 samples as history
+    const size_t keep = std::min(total, ch->n_taps - 1);
+    const size_t drop = total - keep;
+    std::copy(ch->buf.begin() + 2 * drop, ch->buf.begin() + 2 * total, ch->buf.begin());
+    ch->have = keep;
+    ch->next -= drop;
+    return n_out;
+}
+
+double nru_channelizer_out_rate(const nru_channelizer_t *ch) {
+    return ch ? ch->out_rate_hz : 0.0;
+}
+
+int nru_channelizer_decimation(const nru_channelizer_t *ch) {
+    return ch ? static_cast<int>(ch->decim) : 1;
+}
+
+int nru_channelizer_taps(const nru_channelizer_t *ch) {
+    return ch ? static_cast<int>(ch->n_taps) : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,77 @@
+/*
+ * NR-U Sensing Channelizer Header
+ * -------------------------------
+ * Restricts energy detection to the LBT channel. The RX rate is usually
+ * wider than the 20 MHz channel, so adjacent-channel Wi-Fi would otherwise
+ * be integrated into the ED measurement. A Kaiser-window low-pass FIR,
+ * designed from the live RX rate, keeps the channel and rejects its
+ * neighbours, and a polyphase decimator brings the rate down to just
+ * above the channel bandwidth (fewer samples to buffer and to sum).
+ *
+ * Passband gain is unity, so in-channel power is unchanged (same dBm
+ * calibration); out-of-channel noise is removed, so the noise floor drops.
+ *
+ * Location: common/utils/nru_channelizer.h
+ */
+
+#ifndef NRU_CHANNELIZER_H
+#define NRU_CHANNELIZER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_CHAN_PASS_FRAC     0.95    // Passband edge / half the channel bandwidth
+#define NRU_CHAN_STOP_FRAC     1.10    // Stopband edge / half the channel bandwidth
+#define NRU_CHAN_ATTEN_DB      60.0    // Stopband attenuation
+#define NRU_CHAN_MAX_TAPS      512
+
+typedef struct nru_channelizer nru_channelizer_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Design a channelizer for one RX stream
+ * @param in_rate_hz: RX sample rate
+ * @param channel_bw_hz: LBT channel bandwidth (e.g. 20e6)
+ * @param offset_hz: Channel centre relative to the RX centre (0 = on carrier)
+ * @return: NULL if the capture is not wider than the channel (nothing to reject)
+ */
+nru_channelizer_t *nru_channelizer_create(double in_rate_hz, double channel_bw_hz, double offset_hz);
+
+void nru_channelizer_destroy(nru_channelizer_t *ch);
+
+/**
+ * Forget the filter history (call at every gap in the input)
+ * The first n_taps - 1 samples after a reset only fill the history.
+ */
+void nru_channelizer_reset(nru_channelizer_t *ch);
+
+/**
+ * Filter and decimate contiguous interleaved float I/Q
+ * @param out: Room for n_samples / decimation + 1 complex samples
+ * @return: Number of complex output samples
+ */
+size_t nru_channelizer_process(nru_channelizer_t *ch, const float *iq, size_t n_samples, float *out);
+
+/**
+ * Design results
+ */
+double nru_channelizer_out_rate(const nru_channelizer_t *ch);
+int nru_channelizer_decimation(const nru_channelizer_t *ch);
+int nru_channelizer_taps(const nru_channelizer_t *ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_CHANNELIZER_H */
@@ -0,0 +1,280 @@
+/*
+ * NR-U Technology Classifier
+ * --------------------------
+ * Per stream block: ~1 us block powers -> busy runs -> per run, normalized
+ * autocorrelation at each technology's useful-symbol lag. An OFDM signal
+ * correlates with itself one useful symbol later over the CP, giving a
+ * coefficient near CP / (N + CP); other lags and noise stay near zero.
+ * Wi-Fi bursts that start after an idle stretch are also checked for the
+ * L-STF (0.8 us periodic) preamble.
+ *
+ * A run still busy at the end of a block stays open and continues into
+ * the next one, so a burst is reported once, whatever the block size.
+ * Each run is analysed over at most NRU_CLS_MAX_SAMPLES, so the cost per
+ * burst is bounded (four lag sums) and the stage keeps up on one core.
+ *
+ * Location: common/utils/nru_classifier.cpp
+ */
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#ifdef NRU_LBT_STANDALONE
+#include "nru_classifier.h"
+#include "nru_dsp.h"
+#else
+#include "common/utils/nru_classifier.h"
+#include "common/utils/nru_dsp.h"
+#endif
+
+extern "C" {
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+static const double WIFI_SYMBOL_US = 3.2;          // 64-point FFT at 20 MHz
+static const double WIFI_STF_US = 0.8;
+static const double NR_MU1_SYMBOL_US = 1e6 / 30000.0;
+static const double NR_MU0_SYMBOL_US = 1e6 / 15000.0;
+
+// Ideal CP-correlation coefficients CP / (N + CP)
+static const float WIFI_CP_RHO = 0.8f / 4.0f;
+static const float NR_CP_RHO = 144.0f / (2048.0f + 144.0f);
+
+static const size_t NRU_CLS_MAX_SAMPLES = 16384;   // Analysis cap per burst
+static const double MIN_BURST_US = 4.0;
+static const double STF_WINDOW_US = 8.0;
+static const size_t MERGE_GAP_BLOCKS = 2;
+static const double MAX_RUN_US = 10000.0;          // Longer runs are reported in parts
+static const float MIN_SCORE = 0.35f;              // Fraction of the ideal coefficient
+static const float STF_RHO = 0.7f;
+static const float SIGNIFICANCE = 3.0f;            // x the noise-only 1/sqrt(n)
+
+/* ============================================
+ *  STATE
+ * ============================================ */
+
+static double cls_rate_hz = 0.0;
+static size_t block_len = 1;
+static size_t lag_wifi, lag_stf, lag_nr1, lag_nr0;
+
+// Busy run carried across nru_classify_block_powers() calls (classifying
+// thread only)
+static struct {
+    bool active;
+    bool at_start;                     // Preceded by an idle block
+    bool idle;                         // Last block seen was idle
+    uint64_t start_us;
+    size_t blocks;                     // Through the last busy block
+    size_t gap;                        // Idle blocks since then
+    double sum;
+    std::vector<float> iq;             // First NRU_CLS_MAX_SAMPLES of the run
+} run;
+
+static std::atomic<nru_tech_policy_fn> policy_fn{nullptr};
+static std::atomic<void *> policy_ctx{nullptr};
+
+static std::atomic<uint64_t> tech_bursts[NRU_TECH_COUNT];
+static std::atomic<uint64_t> tech_airtime_us[NRU_TECH_COUNT];
+static std::atomic<uint64_t> observed_us{0};
+static std::atomic<int> last_tech{NRU_TECH_UNKNOWN};
+static float run_cal_offset_db = 0.0f;
+
+/* ============================================
+ *  SETUP
+ * ============================================ */
+
+void nru_classifier_configure(double sample_rate_hz) {
+    if (sample_rate_hz <= 0.0) return;
+    cls_rate_hz = sample_rate_hz;
+    run.active = false;                // Samples at the old rate
+    run.idle = false;
+    const double spu = sample_rate_hz * 1e-6;      // samples per us
+    block_len = std::max<size_t>(1, static_cast<size_t>(std::lround(spu)));
+    lag_wifi = static_cast<size_t>(std::lround(WIFI_SYMBOL_US * spu));
+    lag_stf = std::max<size_t>(1, static_cast<size_t>(std::lround(WIFI_STF_US * spu)));
+    lag_nr1 = static_cast<size_t>(std::lround(NR_MU1_SYMBOL_US * spu));
+    lag_nr0 = static_cast<size_t>(std::lround(NR_MU0_SYMBOL_US * spu));
+}
+
+void nru_classifier_set_policy(nru_tech_policy_fn fn, void *ctx) {
+    policy_ctx.store(ctx, std::memory_order_relaxed);
+    policy_fn.store(fn, std::memory_order_release);
+}
+
+const char *nru_tech_name(nru_tech_t tech) {
+    switch (tech) {
+        case NRU_TECH_WIFI: return "WIFI";
+        case NRU_TECH_NR:   return "NR";
+        case NRU_TECH_LTE:  return "LTE";
+        default:            return "UNKNOWN";
+    }
+}
+
+/* ============================================
+ *  CLASSIFICATION
+ * ============================================ */
+
+// Score of one CP signature, 0 if the span is too short or not significant
+static float cp_score(const float *iq, size_t n, size_t lag, float ideal) {
+    if (lag == 0 || n < 2 * lag) return 0.0f;
+    float rho = nru_autocorr_coeff_fc32(iq, n, lag);
+    if (rho < SIGNIFICANCE / std::sqrt(static_cast<float>(n - lag))) return 0.0f;
+    return rho / ideal;
+}
+
+nru_tech_t nru_classify_burst(const float *iq, size_t n_samples, bool at_burst_start,
+                              float *score, bool *preamble) {
+    if (score) *score = 0.0f;
+    if (preamble) *preamble = false;
+    if (!iq || cls_rate_hz <= 0.0 || n_samples < MIN_BURST_US * cls_rate_hz * 1e-6)
+        return NRU_TECH_UNKNOWN;
+
+    const size_t n = std::min(n_samples, NRU_CLS_MAX_SAMPLES);
+
+    if (at_burst_start) {
+        size_t stf_n = std::min(n, static_cast<size_t>(STF_WINDOW_US * cls_rate_hz * 1e-6));
+        if (nru_autocorr_coeff_fc32(iq, stf_n, lag_stf) >= STF_RHO) {
+            if (score) *score = 1.0f;
+            if (preamble) *preamble = true;
+            return NRU_TECH_WIFI;
+        }
+    }
+
+    const float s_wifi = cp_score(iq, n, lag_wifi, WIFI_CP_RHO);
+    const float s_nr1 = cp_score(iq, n, lag_nr1, NR_CP_RHO);
+    const float s_nr0 = cp_score(iq, n, lag_nr0, NR_CP_RHO);
+
+    nru_tech_t best = NRU_TECH_UNKNOWN;
+    float best_score = MIN_SCORE;
+    if (s_wifi > best_score) { best = NRU_TECH_WIFI; best_score = s_wifi; }
+    if (s_nr1 > best_score) { best = NRU_TECH_NR; best_score = s_nr1; }
+    if (s_nr0 > best_score) { best = NRU_TECH_LTE; best_score = s_nr0; }
+
+    if (score) *score = (best == NRU_TECH_UNKNOWN) ? std::max({s_wifi, s_nr1, s_nr0}) : best_score;
+    return best;
+}
+
+static void report_burst(const nru_burst_info_t &b) {
+    tech_bursts[b.tech].fetch_add(1, std::memory_order_relaxed);
+    tech_airtime_us[b.tech].fetch_add(b.duration_us, std::memory_order_relaxed);
+    last_tech.store(b.tech, std::memory_order_relaxed);
+
+    nru_tech_policy_fn fn = policy_fn.load(std::memory_order_acquire);
+    if (fn)
+        fn(&b, policy_ctx.load(std::memory_order_relaxed));
+}
+
+size_t nru_classifier_block_len(void) {
+    return block_len;
+}
+
+void nru_classify_block(const float *iq, size_t n_samples, uint64_t start_us,
+                        float busy_dbfs, float cal_offset_db) {
+    if (!iq || cls_rate_hz <= 0.0 || n_samples < block_len) return;
+
+    static thread_local std::vector<float> power;
+    const size_t n_blocks = n_samples / block_len;
+    if (power.size() < n_blocks)
+        power.resize(n_blocks);
+    nru_block_power_fc32(iq, n_samples, block_len, power.data());
+    nru_classify_block_powers(iq, power.data(), n_samples, start_us, busy_dbfs, cal_offset_db);
+}
+
+// Classify and report the open run
+static void close_run(void) {
+    if (!run.active) return;
+    run.active = false;
+    const double us_per_block = block_len * 1e6 / cls_rate_hz;
+    const size_t n = std::min(run.blocks * block_len, run.iq.size() / 2);
+    nru_burst_info_t info;
+    info.start_us = run.start_us;
+    info.duration_us = static_cast<uint32_t>(std::lround(run.blocks * us_per_block));
+    info.power_dbm = nru_power_to_db(static_cast<float>(run.sum / run.blocks)) + run_cal_offset_db;
+    info.tech = nru_classify_burst(run.iq.data(), n, run.at_start, &info.score, &info.preamble);
+    report_burst(info);
+}
+
+void nru_classify_block_powers(const float *iq, const float *power, size_t n_samples,
+                               uint64_t start_us, float busy_dbfs, float cal_offset_db) {
+    if (!iq || !power || cls_rate_hz <= 0.0 || n_samples < block_len) return;
+
+    const size_t n_blocks = n_samples / block_len;
+    const double us_per_block = block_len * 1e6 / cls_rate_hz;
+    const size_t max_run_blocks = static_cast<size_t>(MAX_RUN_US / us_per_block);
+    observed_us.fetch_add(static_cast<uint64_t>(n_blocks * us_per_block), std::memory_order_relaxed);
+    run_cal_offset_db = cal_offset_db;
+
+    const float thr = std::pow(10.0f, busy_dbfs / 10.0f);
+    for (size_t b = 0; b < n_blocks; b++) {
+        const bool busy = power[b] >= thr;
+        if (!run.active) {
+            if (!busy) {
+                run.idle = true;
+                continue;
+            }
+            run.active = true;
+            run.at_start = run.idle;
+            run.start_us = start_us + static_cast<uint64_t>(b * us_per_block);
+            run.blocks = run.gap = 0;
+            run.sum = 0.0;
+            run.iq.clear();
+        }
+
+        // Busy run, bridging short dips; gap blocks are kept in case the
+        // run resumes
+        if (run.iq.size() < 2 * NRU_CLS_MAX_SAMPLES) {
+            const float *blk = iq + 2 * b * block_len;
+            run.iq.insert(run.iq.end(), blk, blk + 2 * block_len);
+        }
+        if (busy) {
+            run.blocks += run.gap + 1;
+            run.gap = 0;
+            run.sum += power[b];
+            run.idle = false;
+            if (run.blocks >= max_run_blocks)
+                close_run();           // Continues as a new run, not at its start
+        } else if (++run.gap > MERGE_GAP_BLOCKS) {
+            close_run();
+            run.idle = true;
+        }
+    }
+}
+
+void nru_classifier_flush(void) {
+    if (cls_rate_hz > 0.0)
+        close_run();
+    run.active = false;
+    run.idle = false;                  // Unknown what preceded the next block
+}
+
+/* ============================================
+ *  STATISTICS
+ * ============================================ */
+
+void nru_classifier_get_stats(nru_tech_stats_t *out) {
+    if (!out) return;
+    const uint64_t obs = observed_us.load(std::memory_order_relaxed);
+    for (int t = 0; t < NRU_TECH_COUNT; t++) {
+        out[t].bursts = tech_bursts[t].load(std::memory_order_relaxed);
+        out[t].airtime_us = tech_airtime_us[t].load(std::memory_order_relaxed);
+        out[t].observed_us = obs;
+        out[t].occupancy = obs ? static_cast<double>(out[t].airtime_us) / obs : 0.0;
+    }
+}
+
+void nru_classifier_reset_stats(void) {
+    for (int t = 0; t < NRU_TECH_COUNT; t++) {
+        tech_bursts[t].store(0, std::memory_order_relaxed);
+        tech_airtime_us[t].store(0, std::memory_order_relaxed);
+    }
+    observed_us.store(0, std::memory_order_relaxed);
+}
+
+nru_tech_t nru_classifier_last_tech(void) {
+    return static_cast<nru_tech_t>(last_tech.load(std::memory_order_relaxed));
+}
+
+} // extern "C"
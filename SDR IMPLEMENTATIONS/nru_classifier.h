@@ -0,0 +1,137 @@
+/*
+ * NR-U Technology Classifier Header
+ * ---------------------------------
+ * Attributes busy bursts seen by the energy detector to a technology
+ * using cyclic-prefix autocorrelation signatures:
+ *   - 802.11 OFDM: 3.2 us symbol, 0.8 us CP (plus L-STF 0.8 us period)
+ *   - NR mu=1:    33.3 us symbol, 2.3 us CP (NR-U neighbours)
+ *   - NR mu=0 / LTE-LAA: 66.7 us symbol, 4.7 us CP
+ * Results feed per-technology occupancy counters and an optional policy
+ * callback (e.g. yield to Wi-Fi, coordinate with our own cells).
+ *
+ * Location: common/utils/nru_classifier.h
+ */
+
+#ifndef NRU_CLASSIFIER_H
+#define NRU_CLASSIFIER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  TYPES
+ * ============================================ */
+
+typedef enum {
+    NRU_TECH_UNKNOWN = 0,              // Too short / no OFDM signature
+    NRU_TECH_WIFI,                     // IEEE 802.11a/n/ac/ax (20 MHz)
+    NRU_TECH_NR,                       // NR mu=1 (NR-U)
+    NRU_TECH_LTE,                      // LTE-LAA or NR mu=0
+    NRU_TECH_COUNT
+} nru_tech_t;
+
+/**
+ * One classified busy burst (bursts longer than 10 ms are reported in parts)
+ */
+typedef struct {
+    nru_tech_t tech;
+    uint64_t start_us;                 // nru_clock time of the first sample
+    uint32_t duration_us;
+    float power_dbm;
+    float score;                       // Winning signature / its ideal value
+    bool preamble;                     // L-STF detected at burst start
+} nru_burst_info_t;
+
+/**
+ * Per-technology occupancy since the last reset
+ */
+typedef struct {
+    uint64_t bursts;
+    uint64_t airtime_us;
+    uint64_t observed_us;              // Total classified RX time (all techs)
+    double occupancy;                  // airtime_us / observed_us
+} nru_tech_stats_t;
+
+/**
+ * Policy hook, called on the classifying thread for every burst
+ * Must not block.
+ */
+typedef void (*nru_tech_policy_fn)(const nru_burst_info_t *burst, void *ctx);
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Precompute signature lags for the stream sample rate
+ * Drops an open run (its samples are at the old rate).
+ */
+void nru_classifier_configure(double sample_rate_hz);
+
+/**
+ * Install the policy hook (NULL to remove)
+ */
+void nru_classifier_set_policy(nru_tech_policy_fn fn, void *ctx);
+
+/**
+ * Segment the next block of the stream into busy bursts and classify them
+ * Successive calls are taken as contiguous: a run busy at the end of the
+ * block is reported once it ends in a later one. Call from one thread.
+ * @param iq: Interleaved float I/Q (full scale 1.0)
+ * @param n_samples: Complex samples in the block
+ * @param start_us: nru_clock time of the first sample (stamps runs that
+ *                  begin in this block)
+ * @param busy_dbfs: Energy detection threshold in dBFS
+ * @param cal_offset_db: dBm = dBFS + offset (for reported power)
+ */
+void nru_classify_block(const float *iq, size_t n_samples, uint64_t start_us,
+                        float busy_dbfs, float cal_offset_db);
+
+/**
+ * nru_classify_block() with the block powers already computed
+ * @param power: n_samples / nru_classifier_block_len() mean block powers
+ */
+void nru_classify_block_powers(const float *iq, const float *power, size_t n_samples,
+                               uint64_t start_us, float busy_dbfs, float cal_offset_db);
+
+/**
+ * End of the contiguous stream (samples lost or skipped)
+ * Reports the open run as it stands.
+ */
+void nru_classifier_flush(void);
+
+/**
+ * Samples per segmentation block (about 1 us at the configured rate)
+ */
+size_t nru_classifier_block_len(void);
+
+/**
+ * Classify one burst (exposed for offline tools)
+ * @param at_burst_start: Samples begin at the burst's leading edge
+ */
+nru_tech_t nru_classify_burst(const float *iq, size_t n_samples, bool at_burst_start,
+                              float *score, bool *preamble);
+
+/**
+ * Occupancy counters (array of NRU_TECH_COUNT)
+ */
+void nru_classifier_get_stats(nru_tech_stats_t *out);
+void nru_classifier_reset_stats(void);
+
+/**
+ * Technology of the most recent burst
+ */
+nru_tech_t nru_classifier_last_tech(void);
+
+const char *nru_tech_name(nru_tech_t tech);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_CLASSIFIER_H */
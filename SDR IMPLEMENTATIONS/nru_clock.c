@@ -0,0 +1,378 @@
+/*
+ * NR-U Clock Service
+ * ------------------
+ * One clock domain for every NR-U timing decision (cache ages, sensing
+ * windows, FBE frame offsets, CSV timestamps).
+ *
+ *  - Host time: invariant TSC scaled to CLOCK_MONOTONIC nanoseconds, with
+ *    a vDSO clock_gettime() fallback. Readers are lock-free (seqlock).
+ *  - Device time: offset + drift mapping to the USRP time_spec, updated
+ *    from RX metadata by the sample ingest path.
+ *  - Pluggable source: tests install their own now/sleep pair, or the
+ *    built-in virtual clock whose sleeps complete instantly.
+ *
+ * Location: common/utils/nru_clock.c
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include "nru_clock.h"
+#include "nru_seqlock.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define NRU_CLOCK_HAVE_TSC 1
+#else
+#define NRU_CLOCK_HAVE_TSC 0
+#endif
+
+// TSC calibration spin at init (one-off, replaces nothing on the RT path)
+#define NRU_CLOCK_CAL_SPIN_NS      5000000ULL
+// Device observations further off than this re-anchor the mapping
+#define NRU_CLOCK_DEV_JUMP_NS      1000000LL
+// Minimum spacing between drift updates
+#define NRU_CLOCK_DRIFT_UPDATE_NS  100000000ULL
+
+// ---------------------------------------------------------------------
+// State
+// ---------------------------------------------------------------------
+static atomic_bool clock_initialized = false;
+static bool use_tsc = false;
+
+// TSC -> ns parameters, published under a seqlock
+static uint32_t tsc_seq;
+static _Atomic uint64_t tsc_base_ticks;
+static _Atomic uint64_t tsc_base_ns;
+static _Atomic uint64_t tsc_mult;          // ns per tick, 32.32 fixed point
+
+// First calibration point (long baseline for recalibration)
+static uint64_t tsc_origin_ticks;
+static uint64_t tsc_origin_ns;
+
+// Device mapping, published under a seqlock (single writer: RX path)
+static uint32_t dev_seq;
+static _Atomic int64_t  dev_anchor_ns;
+static _Atomic uint64_t dev_host_anchor_ns;
+static _Atomic int64_t  dev_drift_ppb;
+static atomic_bool      dev_locked = false;
+static uint64_t         dev_last_drift_host_ns;
+static int64_t          dev_last_drift_err_ns;
+
+// Installed time source, NULL = host (per thread in standalone builds)
+static NRU_TLS const nru_clock_ops_t *clock_ops = NULL;
+
+// Built-in virtual source
+static NRU_TLS uint64_t             virt_now_ns = 0;
+static NRU_TLS nru_clock_advance_fn virt_advance = NULL;
+static NRU_TLS void                *virt_ctx = NULL;
+static uint64_t virt_now(void *ctx);
+static void virt_sleep(uint64_t us, void *ctx);
+static const nru_clock_ops_t virt_ops = { virt_now, virt_sleep, NULL };
+
+// ---------------------------------------------------------------------
+// Low-level sources
+// ---------------------------------------------------------------------
+static inline uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t read_tsc(void) {
+#if NRU_CLOCK_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static bool tsc_is_invariant(void) {
+#if NRU_CLOCK_HAVE_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007)
+        return false;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+// Sample (tsc, mono) as a tight pair: the TSC midpoint around clock_gettime
+static void sample_pair(uint64_t *ticks, uint64_t *ns) {
+    uint64_t best_span = UINT64_MAX;
+    for (int i = 0; i < 5; i++) {
+        uint64_t t0 = read_tsc();
+        uint64_t n  = mono_ns();
+        uint64_t t1 = read_tsc();
+        if (t1 - t0 < best_span) {
+            best_span = t1 - t0;
+            *ticks = t0 + (t1 - t0) / 2;
+            *ns = n;
+        }
+    }
+}
+
+static inline uint64_t tsc_to_ns(uint64_t ticks, uint64_t base_ticks,
+                                 uint64_t base_ns, uint64_t mult) {
+    uint64_t delta = ticks - base_ticks;
+    return base_ns + (uint64_t)(((unsigned __int128)delta * mult) >> 32);
+}
+
+static void publish_tsc(uint64_t base_ticks, uint64_t base_ns, uint64_t mult) {
+    nru_seq_write_begin(&tsc_seq);
+    atomic_store_explicit(&tsc_base_ticks, base_ticks, memory_order_relaxed);
+    atomic_store_explicit(&tsc_base_ns, base_ns, memory_order_relaxed);
+    atomic_store_explicit(&tsc_mult, mult, memory_order_relaxed);
+    nru_seq_write_end(&tsc_seq);
+}
+
+// ---------------------------------------------------------------------
+// Initialization / calibration
+// ---------------------------------------------------------------------
+int nru_clock_init(void) {
+    if (atomic_exchange(&clock_initialized, true))
+        return 0;
+
+    use_tsc = tsc_is_invariant();
+    if (use_tsc) {
+        uint64_t t0, n0, t1, n1;
+        sample_pair(&t0, &n0);
+        do {
+            sample_pair(&t1, &n1);
+        } while (n1 - n0 < NRU_CLOCK_CAL_SPIN_NS);
+
+        if (t1 <= t0) {
+            use_tsc = false;
+        } else {
+            uint64_t mult = (uint64_t)(((unsigned __int128)(n1 - n0) << 32) / (t1 - t0));
+            tsc_origin_ticks = t0;
+            tsc_origin_ns = n0;
+            publish_tsc(t1, n1, mult);
+        }
+    }
+
+    printf("[NRU][CLOCK] Time source: %s\n", nru_clock_source_name());
+    return 0;
+}
+
+void nru_clock_recalibrate(void) {
+    if (!use_tsc)
+        return;
+
+    uint64_t t, n;
+    sample_pair(&t, &n);
+    if (t <= tsc_origin_ticks)
+        return;
+
+    uint64_t mult = (uint64_t)(((unsigned __int128)(n - tsc_origin_ns) << 32) /
+                               (t - tsc_origin_ticks));
+
+    // Re-anchor on CLOCK_MONOTONIC but never step backwards
+    uint64_t current = tsc_to_ns(t,
+                                 atomic_load_explicit(&tsc_base_ticks, memory_order_relaxed),
+                                 atomic_load_explicit(&tsc_base_ns, memory_order_relaxed),
+                                 atomic_load_explicit(&tsc_mult, memory_order_relaxed));
+    publish_tsc(t, (current > n) ? current : n, mult);
+}
+
+const char *nru_clock_source_name(void) {
+    return use_tsc ? "tsc" : "vdso";
+}
+
+// ---------------------------------------------------------------------
+// Host time reads
+// ---------------------------------------------------------------------
+uint64_t nru_clock_now_ns(void) {
+    if (clock_ops)
+        return clock_ops->now_ns(clock_ops->ctx);
+    if (!use_tsc)
+        return mono_ns();
+
+    uint64_t ticks = read_tsc();
+    uint32_t seq;
+    uint64_t base_ticks, base_ns, mult;
+    do {
+        seq = nru_seq_read_begin(&tsc_seq);
+        base_ticks = atomic_load_explicit(&tsc_base_ticks, memory_order_relaxed);
+        base_ns = atomic_load_explicit(&tsc_base_ns, memory_order_relaxed);
+        mult = atomic_load_explicit(&tsc_mult, memory_order_relaxed);
+    } while (nru_seq_read_retry(&tsc_seq, seq));
+
+    // Reads that raced a re-anchor may sit just before the new base
+    if (ticks < base_ticks)
+        ticks = base_ticks;
+    return tsc_to_ns(ticks, base_ticks, base_ns, mult);
+}
+
+uint64_t nru_clock_now_us(void) {
+    return nru_clock_now_ns() / 1000ULL;
+}
+
+uint64_t nru_clock_ticks(void) {
+    return use_tsc ? read_tsc() : mono_ns();
+}
+
+uint64_t nru_clock_ticks_to_ns(uint64_t ticks) {
+    if (!use_tsc)
+        return ticks;
+    uint64_t mult = atomic_load_explicit(&tsc_mult, memory_order_relaxed);
+    return (uint64_t)(((unsigned __int128)ticks * mult) >> 32);
+}
+
+void nru_clock_sleep_us(uint64_t us) {
+    if (clock_ops) {
+        clock_ops->sleep_us(us, clock_ops->ctx);
+        return;
+    }
+    usleep((useconds_t)us);
+}
+
+// ---------------------------------------------------------------------
+// Pluggable source
+// ---------------------------------------------------------------------
+void nru_clock_set_ops(const nru_clock_ops_t *ops) {
+    clock_ops = ops;
+}
+
+bool nru_clock_is_simulated(void) {
+    return clock_ops != NULL;
+}
+
+// ---------------------------------------------------------------------
+// Virtual time
+// ---------------------------------------------------------------------
+static uint64_t virt_now(void *ctx) {
+    (void)ctx;
+    return virt_now_ns;
+}
+
+static void virt_sleep(uint64_t us, void *ctx) {
+    (void)ctx;
+    uint64_t until_us = virt_now_ns / 1000ULL + us;
+    if (virt_advance)
+        virt_advance(until_us, virt_ctx);
+    if (virt_now_ns < until_us * 1000ULL)
+        virt_now_ns = until_us * 1000ULL;
+}
+
+void nru_clock_use_virtual(uint64_t start_us, nru_clock_advance_fn advance, void *ctx) {
+    virt_now_ns = start_us * 1000ULL;
+    virt_advance = advance;
+    virt_ctx = ctx;
+    clock_ops = &virt_ops;
+}
+
+void nru_clock_set_virtual_us(uint64_t now_us) {
+    if (clock_ops == &virt_ops)
+        virt_now_ns = now_us * 1000ULL;
+}
+
+void nru_clock_use_host(void) {
+    clock_ops = NULL;
+    virt_advance = NULL;
+    virt_ctx = NULL;
+}
+
+// ---------------------------------------------------------------------
+// Device time mapping
+// ---------------------------------------------------------------------
+static void load_devmap(int64_t *anchor, uint64_t *host_anchor, int64_t *drift) {
+    uint32_t seq;
+    do {
+        seq = nru_seq_read_begin(&dev_seq);
+        *anchor = atomic_load_explicit(&dev_anchor_ns, memory_order_relaxed);
+        *host_anchor = atomic_load_explicit(&dev_host_anchor_ns, memory_order_relaxed);
+        *drift = atomic_load_explicit(&dev_drift_ppb, memory_order_relaxed);
+    } while (nru_seq_read_retry(&dev_seq, seq));
+}
+
+static void store_devmap(int64_t anchor, uint64_t host_anchor, int64_t drift) {
+    nru_seq_write_begin(&dev_seq);
+    atomic_store_explicit(&dev_anchor_ns, anchor, memory_order_relaxed);
+    atomic_store_explicit(&dev_host_anchor_ns, host_anchor, memory_order_relaxed);
+    atomic_store_explicit(&dev_drift_ppb, drift, memory_order_relaxed);
+    nru_seq_write_end(&dev_seq);
+}
+
+static inline int64_t map_host(uint64_t host_ns, int64_t anchor,
+                               uint64_t host_anchor, int64_t drift) {
+    int64_t dt = (int64_t)(host_ns - host_anchor);
+    return anchor + dt + (int64_t)(((__int128)dt * drift) / 1000000000);
+}
+
+void nru_clock_observe_device_time(int64_t device_ns, uint64_t host_ns) {
+    int64_t anchor, drift;
+    uint64_t host_anchor;
+
+    if (!atomic_load_explicit(&dev_locked, memory_order_acquire)) {
+        store_devmap(device_ns, host_ns, 0);
+        dev_last_drift_host_ns = host_ns;
+        dev_last_drift_err_ns = 0;
+        atomic_store_explicit(&dev_locked, true, memory_order_release);
+        return;
+    }
+
+    load_devmap(&anchor, &host_anchor, &drift);
+    int64_t predicted = map_host(host_ns, anchor, host_anchor, drift);
+    int64_t err = device_ns - predicted;
+
+    if (err > NRU_CLOCK_DEV_JUMP_NS || err < -NRU_CLOCK_DEV_JUMP_NS) {
+        // Device time was set (or the stream restarted): start over
+        store_devmap(device_ns, host_ns, 0);
+        dev_last_drift_host_ns = host_ns;
+        dev_last_drift_err_ns = 0;
+        printf("[NRU][CLOCK] Device time re-anchored (error %lld ns)\n", (long long)err);
+        return;
+    }
+
+    // Host capture times carry scheduling jitter: move 1/16 of the error
+    int64_t new_anchor = predicted + err / 16;
+
+    // Drift loop on the accumulated residual over >= 100 ms baselines
+    dev_last_drift_err_ns += err / 16;
+    uint64_t span = host_ns - dev_last_drift_host_ns;
+    if (span >= NRU_CLOCK_DRIFT_UPDATE_NS) {
+        drift += (int64_t)(((__int128)dev_last_drift_err_ns * 1000000000) / (int64_t)span) / 4;
+        dev_last_drift_host_ns = host_ns;
+        dev_last_drift_err_ns = 0;
+    }
+
+    store_devmap(new_anchor, host_ns, drift);
+}
+
+bool nru_clock_device_locked(void) {
+    return atomic_load_explicit(&dev_locked, memory_order_acquire);
+}
+
+int64_t nru_clock_host_to_device_ns(uint64_t host_ns) {
+    if (!nru_clock_device_locked())
+        return (int64_t)host_ns;
+    int64_t anchor, drift;
+    uint64_t host_anchor;
+    load_devmap(&anchor, &host_anchor, &drift);
+    return map_host(host_ns, anchor, host_anchor, drift);
+}
+
+uint64_t nru_clock_device_to_host_ns(int64_t device_ns) {
+    if (!nru_clock_device_locked())
+        return (uint64_t)device_ns;
+    int64_t anchor, drift;
+    uint64_t host_anchor;
+    load_devmap(&anchor, &host_anchor, &drift);
+    int64_t dd = device_ns - anchor;
+    int64_t dt = dd - (int64_t)(((__int128)dd * drift) / (1000000000 + drift));
+    return host_anchor + (uint64_t)dt;
+}
+
+int64_t nru_clock_device_drift_ppb(void) {
+    int64_t anchor, drift;
+    uint64_t host_anchor;
+    load_devmap(&anchor, &host_anchor, &drift);
+    return drift;
+}
@@ -0,0 +1,173 @@
+/*
+ * NR-U Clock Service Header
+ * -------------------------
+ * Single time base shared by nru_lbt.c and nru_uhd_helper.cpp.
+ * Fast reads come from the invariant TSC (calibrated against
+ * CLOCK_MONOTONIC) or, when no usable TSC exists, from the vDSO
+ * clock_gettime(CLOCK_MONOTONIC) path. A second mapping tracks the
+ * USRP device time reported in RX metadata.
+ *
+ * Location: common/utils/nru_clock.h
+ */
+
+#ifndef NRU_CLOCK_H
+#define NRU_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Standalone (simulation) builds run independent replications of the LBT
+ * core on several threads; module state is then kept per thread.
+ */
+#if defined(NRU_LBT_STANDALONE) && defined(__cplusplus)
+#define NRU_TLS thread_local
+#elif defined(NRU_LBT_STANDALONE)
+#define NRU_TLS _Thread_local
+#else
+#define NRU_TLS
+#endif
+
+/* ============================================
+ *  HOST CLOCK
+ * ============================================ */
+
+/**
+ * Initialize the clock service (idempotent)
+ * Selects the TSC when it is invariant, vDSO CLOCK_MONOTONIC otherwise
+ * @return: 0 on success
+ */
+int nru_clock_init(void);
+
+/**
+ * Refine the TSC rate against CLOCK_MONOTONIC
+ * Cheap; call from a housekeeping path, never required for correctness
+ */
+void nru_clock_recalibrate(void);
+
+/**
+ * Current time on the CLOCK_MONOTONIC scale
+ * @return: Nanoseconds / microseconds
+ */
+uint64_t nru_clock_now_ns(void);
+uint64_t nru_clock_now_us(void);
+
+/**
+ * Raw tick counter for profiling (TSC cycles or ns on vDSO fallback)
+ */
+uint64_t nru_clock_ticks(void);
+
+/**
+ * Convert a tick delta to nanoseconds
+ */
+uint64_t nru_clock_ticks_to_ns(uint64_t ticks);
+
+/**
+ * Name of the active source ("tsc" or "vdso")
+ */
+const char *nru_clock_source_name(void);
+
+/**
+ * Sleep on the NR-U clock
+ * Blocks on the host clock; returns at once under an installed source
+ * @param us: Duration in microseconds
+ */
+void nru_clock_sleep_us(uint64_t us);
+
+/* ============================================
+ *  PLUGGABLE TIME SOURCE
+ * ============================================ */
+
+/**
+ * Replacement for host time reads and waits
+ * Every NR-U time read and sleep goes through the installed source, so a
+ * test can drive the LBT core and the UHD helper faster than real time.
+ */
+typedef struct {
+    uint64_t (*now_ns)(void *ctx);
+    void (*sleep_us)(uint64_t us, void *ctx);
+    void *ctx;
+} nru_clock_ops_t;
+
+/**
+ * Install a time source (NULL restores the host clock)
+ * Per thread in standalone builds, process-wide otherwise; install it
+ * before the threads that use it start.
+ * @param ops: Source descriptor, must outlive its installation
+ */
+void nru_clock_set_ops(const nru_clock_ops_t *ops);
+
+/**
+ * @return: true while a non-host source is installed
+ */
+bool nru_clock_is_simulated(void);
+
+/* ============================================
+ *  VIRTUAL TIME (SIMULATION)
+ * ============================================ */
+
+/**
+ * Callback run before a virtual sleep completes
+ * The owner processes its events up to until_us (calling
+ * nru_clock_set_virtual_us() as it goes) before the clock jumps there.
+ */
+typedef void (*nru_clock_advance_fn)(uint64_t until_us, void *ctx);
+
+/**
+ * Install the built-in simulated source
+ * Time only moves when somebody sleeps or sets it, so sleeps cost nothing.
+ * @param start_us: Initial virtual time
+ * @param advance: Event hook for sleeps (may be NULL)
+ * @param ctx: Opaque pointer handed to advance
+ */
+void nru_clock_use_virtual(uint64_t start_us, nru_clock_advance_fn advance, void *ctx);
+
+/**
+ * Move the virtual clock (no-op unless the simulated source is installed)
+ */
+void nru_clock_set_virtual_us(uint64_t now_us);
+
+/**
+ * Return the calling thread to host time
+ */
+void nru_clock_use_host(void);
+
+/* ============================================
+ *  USRP DEVICE TIME MAPPING
+ * ============================================ */
+
+/**
+ * Feed one (device time, host time) observation
+ * Called from the RX path with the time_spec of the first sample and the
+ * host time that sample was captured at. Large jumps re-anchor the mapping.
+ * Single writer: only trx_usrp_read() feeds it (nru_observe_rx_timestamp).
+ * @param device_ns: Device time in nanoseconds
+ * @param host_ns: nru_clock_now_ns() time of the same sample
+ */
+void nru_clock_observe_device_time(int64_t device_ns, uint64_t host_ns);
+
+/**
+ * @return: true once at least one device observation was received
+ */
+bool nru_clock_device_locked(void);
+
+/**
+ * Map between host and device time (identity until locked)
+ */
+int64_t nru_clock_host_to_device_ns(uint64_t host_ns);
+uint64_t nru_clock_device_to_host_ns(int64_t device_ns);
+
+/**
+ * Estimated device clock drift relative to the host (parts per billion)
+ */
+int64_t nru_clock_device_drift_ppb(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_CLOCK_H */
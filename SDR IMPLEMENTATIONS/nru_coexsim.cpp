@@ -0,0 +1,738 @@
+/*
+ * NR-U / Wi-Fi Coexistence Discrete-Event Engine
+ * ----------------------------------------------
+ * Native replacement for the SimPy sweeps (run_all_modes.py,
+ * run_coexistenxe_matrix.py) that runs the deployed LBT decision code:
+ * nru_lbt.c is linked as-is (NRU_LBT_STANDALONE) and driven on a virtual
+ * nru_clock against N Wi-Fi DCF stations. Every usleep() in nru_lbt.c
+ * becomes an instant clock jump during which the Wi-Fi model advances.
+ *
+ * Independent Monte-Carlo replications run in parallel on all cores and
+ * the output has the same columns as results/coexistence_*.csv.
+ *
+ * Build:
+ *   gcc -O2 -std=gnu11 -DNRU_LBT_STANDALONE -c nru_lbt.c nru_clock.c nru_stability.c \
+ *       nru_airtime.c nru_coord.c
+ *   g++ -O2 -std=c++17 -DNRU_LBT_STANDALONE nru_coexsim.cpp nru_lbt.o nru_clock.o \
+ *       nru_stability.o nru_airtime.o nru_coord.o -lrt -lpthread -o nru_coexsim
+ *
+ * Example (1-3 APs x cw_min x mcot x ED threshold, 10 seeds each):
+ *   ./nru_coexsim --wifi 1:3 --cw-min 7,15,31,63 --mcot 2,4,6,8 \
+ *                 --ed -82:-62:4 --runs 10 -t 10 -o results/coexistence_des.csv
+ *
+ * Model notes:
+ *  - One gNB per replication (nru_lbt.c holds a single LBT instance).
+ *  - The gNB calls nru_lbt_sense_and_acquire() at every slot boundary with
+ *    a full buffer, transmits for mcot_ms (LBE) or the rest of the FBE TX
+ *    window, then calls nru_lbt_on_tx_complete().
+ *  - Wi-Fi: DIFS + binary exponential backoff, fixed frame/ACK times as in
+ *    coexistanceSimpy (5400 us frame, 44 us ACK, 45 us ACK timeout).
+ *  - SINR is not modelled (no geometry) and is written as 0.
+ *
+ * Author: Integration for OAI NR-U Makhubela Innocent(MKHINN011)
+ * Date: 2025
+ */
+
+#include <getopt.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nru_lbt.h"
+#include "nru_clock.h"
+#include "nru_airtime.h"
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+// 802.11 timing (coexistanceSimpy/Times.py)
+static const uint64_t WIFI_SLOT_US = 9;
+static const uint64_t WIFI_DIFS_US = 3 * WIFI_SLOT_US + 16;
+static const uint64_t WIFI_ACK_US = 44;
+static const uint64_t WIFI_ACK_TIMEOUT_US = 45;
+
+// Data rates used by coexistanceSimpy to turn efficiency into Mbit/s
+static const double WIFI_DATA_RATE_MBPS = 866.7;
+static const double NRU_DATA_RATE_MBPS = 1200.0;
+
+struct SimParams {
+    double sim_time_s = 10.0;
+    int runs = 10;
+    int seed_start = 1;
+    int threads = 0;
+    std::string mode = "LBE";
+    std::string output = "coexistence_des.csv";
+
+    // Swept axes
+    std::vector<int> wifi_nodes{1};
+    std::vector<int> nru_nodes{1};
+    std::vector<int> cw_min{15};
+    std::vector<int> mcot_ms{6};
+    std::vector<int> ed_threshold_dbm{-72};
+
+    // Fixed parameters
+    int nru_cw_max = 1023;
+    int sensing_us = 100;
+    int frame_period_ms = 10;
+    int tx_window_ms = 5;
+    double duty_cap_percent = 0.0;     // Airtime cap (0 = off)
+    int duty_window_ms = 1000;
+    int wifi_cw_min = 15;
+    int wifi_cw_max = 63;
+    int wifi_r_limit = 7;
+    uint64_t wifi_frame_us = 5400;
+    uint64_t slot_us = 500;            // NR slot (30 kHz SCS)
+    double wifi_rx_dbm = -55.0;        // Wi-Fi power at the gNB
+    double nru_rx_dbm = -55.0;         // gNB power at the Wi-Fi stations
+    double wifi_ed_dbm = -62.0;        // Wi-Fi CCA-ED for non-Wi-Fi energy
+    double noise_dbm = -95.0;
+};
+
+struct SimPoint {
+    int wifi_nodes;
+    int nru_nodes;
+    int cw_min;
+    int mcot_ms;
+    int ed_threshold_dbm;
+};
+
+struct SimResult {
+    int seed = 0;
+    SimPoint point{};
+    int nru_cw_max = 0;
+    int wifi_cw_min = 0;
+    int wifi_cw_max = 0;
+    double wifi_thr = 0, nru_thr = 0;
+    double wifi_plr = 0, nru_plr = 0;
+    double wifi_latency = 0, nru_latency = 0;
+    double wifi_access = 0, nru_access = 0;
+    double fairness = 0, jains = 0, joint = 0;
+    double wifi_cot = 0, nru_cot = 0, total_cot = 0;
+    double wifi_eff = 0, nru_eff = 0, total_eff = 0;
+};
+
+/* ============================================
+ *  WI-FI DCF + CHANNEL MODEL
+ * ============================================ */
+
+enum class StaPhase { CONTEND, FRAME, ACK };
+
+struct Station {
+    StaPhase phase = StaPhase::CONTEND;
+    int backoff = 0;               // remaining slots
+    int retries = 0;
+    uint64_t ready_at = 0;         // earliest contention start (ACK timeout)
+    uint64_t phase_end = 0;        // FRAME/ACK end
+    uint64_t frame_since = 0;      // frame became head-of-line
+    uint64_t attempt_since = 0;    // current access attempt began
+    bool collided = false;
+
+    uint64_t succeeded = 0, failed = 0;
+    uint64_t airtime_data = 0, airtime_control = 0;
+    double latency_sum = 0, access_sum = 0;
+    uint64_t access_count = 0;
+};
+
+class CoexEngine {
+public:
+    CoexEngine(const SimParams &p, const SimPoint &pt, int seed)
+        : params(p), point(pt), rng(static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ULL + 1),
+          stations(pt.wifi_nodes) {
+        for (auto &st : stations)
+            st.backoff = draw_backoff(st);
+    }
+
+    SimResult run(int seed);
+
+    // nru_lbt.c hooks (via the thread-local engine pointer)
+    float sensed_energy_dbm();
+    void advance_to(uint64_t t);
+
+private:
+    const SimParams &params;
+    SimPoint point;
+    std::mt19937_64 rng;
+    std::normal_distribution<double> jitter_db{0.0, 1.0};
+    std::vector<Station> stations;
+
+    uint64_t now = 0;
+    uint64_t idle_since = 0;       // medium idle (from Wi-Fi's view) since
+    bool nru_active = false;
+    bool nru_collided = false;
+
+    uint64_t nru_succeeded = 0, nru_failed = 0;
+    uint64_t nru_airtime = 0;
+    double nru_access_sum = 0, nru_latency_sum = 0;
+    uint64_t nru_access_count = 0;
+
+    int draw_backoff(const Station &st) {
+        int upper = ((1 << std::min(st.retries, 16)) * (params.wifi_cw_min + 1)) - 1;
+        upper = std::min(upper, params.wifi_cw_max);
+        return std::uniform_int_distribution<int>(0, upper)(rng);
+    }
+
+    bool nru_audible() const { return params.nru_rx_dbm >= params.wifi_ed_dbm; }
+
+    int wifi_on_air() const {
+        int n = 0;
+        for (const auto &st : stations)
+            n += (st.phase != StaPhase::CONTEND);
+        return n;
+    }
+
+    int wifi_frames_on_air() const {
+        int n = 0;
+        for (const auto &st : stations)
+            n += (st.phase == StaPhase::FRAME);
+        return n;
+    }
+
+    bool medium_busy() const {
+        return wifi_on_air() > 0 || (nru_active && nru_audible());
+    }
+
+    uint64_t fire_time(const Station &st) const {
+        return std::max(idle_since, st.ready_at) + WIFI_DIFS_US + st.backoff * WIFI_SLOT_US;
+    }
+
+    // Medium turned busy at t: freeze every contending station's countdown
+    void freeze(uint64_t t) {
+        for (auto &st : stations) {
+            if (st.phase != StaPhase::CONTEND) continue;
+            uint64_t base = std::max(idle_since, st.ready_at) + WIFI_DIFS_US;
+            if (t > base)
+                st.backoff -= std::min<int>(st.backoff, static_cast<int>((t - base) / WIFI_SLOT_US));
+        }
+    }
+
+    uint64_t next_event() const;
+    void process_events_at(uint64_t t);
+    void nru_begin_tx();
+    void nru_end_tx(uint64_t start);
+    SimResult collect(int seed) const;
+};
+
+static thread_local CoexEngine *tl_engine = nullptr;
+
+uint64_t CoexEngine::next_event() const {
+    uint64_t next = UINT64_MAX;
+    bool busy = medium_busy();
+    for (const auto &st : stations) {
+        if (st.phase != StaPhase::CONTEND)
+            next = std::min(next, st.phase_end);
+        else if (!busy)
+            next = std::min(next, fire_time(st));
+    }
+    return next;
+}
+
+void CoexEngine::process_events_at(uint64_t t) {
+    bool was_busy = medium_busy();
+
+    // 1) Frame / ACK completions
+    for (auto &st : stations) {
+        if (st.phase == StaPhase::FRAME && st.phase_end == t) {
+            if (st.collided) {
+                st.failed++;
+                st.retries++;
+                if (st.retries > params.wifi_r_limit) {
+                    st.retries = 0;
+                    st.frame_since = t + WIFI_ACK_TIMEOUT_US;
+                }
+                st.phase = StaPhase::CONTEND;
+                st.ready_at = t + WIFI_ACK_TIMEOUT_US;
+                st.attempt_since = st.ready_at;
+                st.backoff = draw_backoff(st);
+            } else {
+                st.succeeded++;
+                st.airtime_data += params.wifi_frame_us;
+                st.airtime_control += WIFI_ACK_US;
+                st.phase = StaPhase::ACK;
+                st.phase_end = t + WIFI_ACK_US;
+            }
+        } else if (st.phase == StaPhase::ACK && st.phase_end == t) {
+            st.latency_sum += static_cast<double>(t - st.frame_since);
+            st.retries = 0;
+            st.phase = StaPhase::CONTEND;
+            st.ready_at = t;
+            st.frame_since = t;
+            st.attempt_since = t;
+            st.backoff = draw_backoff(st);
+        }
+    }
+
+    bool busy = medium_busy();
+    if (was_busy && !busy) {
+        idle_since = t;
+        return;
+    }
+    if (busy)
+        return;
+
+    // 2) Backoff expiries on an idle medium (same slot => collision)
+    std::vector<Station *> firing;
+    for (auto &st : stations)
+        if (st.phase == StaPhase::CONTEND && fire_time(st) == t)
+            firing.push_back(&st);
+    if (firing.empty())
+        return;
+
+    for (auto *st : firing) {
+        st->phase = StaPhase::FRAME;
+        st->phase_end = t + params.wifi_frame_us;
+        st->collided = (firing.size() > 1) || nru_active;
+        st->access_sum += static_cast<double>(t - st->attempt_since);
+        st->access_count++;
+    }
+    if (nru_active)
+        nru_collided = true;
+    freeze(t);
+}
+
+void CoexEngine::advance_to(uint64_t t) {
+    while (true) {
+        uint64_t next = next_event();
+        if (next > t) break;
+        now = next;
+        nru_clock_set_virtual_us(now);
+        process_events_at(now);
+    }
+    now = t;
+    nru_clock_set_virtual_us(now);
+}
+
+float CoexEngine::sensed_energy_dbm() {
+    double level = (wifi_on_air() > 0) ? params.wifi_rx_dbm : params.noise_dbm;
+    return static_cast<float>(level + jitter_db(rng));
+}
+
+void CoexEngine::nru_begin_tx() {
+    bool was_busy = medium_busy();
+    nru_active = true;
+    nru_collided = false;
+    if (wifi_frames_on_air() > 0) {
+        nru_collided = true;
+        for (auto &st : stations)
+            if (st.phase == StaPhase::FRAME) st.collided = true;
+    }
+    if (!was_busy && medium_busy())
+        freeze(now);
+}
+
+void CoexEngine::nru_end_tx(uint64_t start) {
+    bool was_busy = medium_busy();
+    nru_active = false;
+    if (nru_collided) {
+        nru_failed++;
+    } else {
+        nru_succeeded++;
+        nru_airtime += now - start;
+    }
+    nru_airtime_record(start, now);
+    if (was_busy && !medium_busy())
+        idle_since = now;
+}
+
+SimResult CoexEngine::run(int seed) {
+    const uint64_t end_us = static_cast<uint64_t>(params.sim_time_s * 1e6);
+    const bool fbe = (params.mode == "FBE");
+
+    while (point.nru_nodes > 0 && now < end_us) {
+        // Scheduler runs once per slot
+        uint64_t slot_start = ((now + params.slot_us - 1) / params.slot_us) * params.slot_us;
+        advance_to(slot_start);
+        uint64_t attempt = now;
+
+        int required_us = point.mcot_ms * 1000;
+        while (now < end_us && !nru_lbt_sense_and_acquire(0, required_us)) {
+            advance_to(((now / params.slot_us) + 1) * params.slot_us);
+        }
+        if (now >= end_us) break;
+
+        uint64_t burst = static_cast<uint64_t>(required_us);
+        if (fbe) {
+            uint64_t frame_us = static_cast<uint64_t>(params.frame_period_ms) * 1000;
+            uint64_t on_us = static_cast<uint64_t>(params.tx_window_ms) * 1000;
+            uint64_t off = now % frame_us;
+            if (off >= on_us) continue;    // guard slept past the window
+            burst = std::min(burst, on_us - off);
+        }
+        // The COT the LBT core granted (may be cut by the airtime cap)
+        uint64_t cot_end;
+        nru_lbt_get_guard(nullptr, &cot_end);
+        if (cot_end <= now) continue;
+        burst = std::min(burst, cot_end - now);
+
+        nru_access_sum += static_cast<double>(now - attempt);
+        nru_access_count++;
+        uint64_t start = now;
+        nru_begin_tx();
+        advance_to(std::min(start + burst, end_us));
+        nru_end_tx(start);
+        nru_latency_sum += static_cast<double>(now - attempt);
+        nru_lbt_on_tx_complete();
+    }
+    advance_to(end_us);
+    return collect(seed);
+}
+
+SimResult CoexEngine::collect(int seed) const {
+    SimResult r;
+    r.seed = seed;
+    r.point = point;
+    r.nru_cw_max = params.nru_cw_max;
+    r.wifi_cw_min = params.wifi_cw_min;
+    r.wifi_cw_max = params.wifi_cw_max;
+
+    const double T = params.sim_time_s * 1e6;
+    uint64_t w_succ = 0, w_fail = 0, w_data = 0, w_ctrl = 0, w_acc_n = 0;
+    double w_lat = 0, w_acc = 0;
+    for (const auto &st : stations) {
+        w_succ += st.succeeded;
+        w_fail += st.failed;
+        w_data += st.airtime_data;
+        w_ctrl += st.airtime_control;
+        w_lat += st.latency_sum;
+        w_acc += st.access_sum;
+        w_acc_n += st.access_count;
+    }
+
+    r.wifi_plr = (w_succ + w_fail) ? static_cast<double>(w_fail) / (w_succ + w_fail) : 0.0;
+    r.nru_plr = (nru_succeeded + nru_failed) ?
+                static_cast<double>(nru_failed) / (nru_succeeded + nru_failed) : 0.0;
+    r.wifi_latency = w_succ ? w_lat / w_succ : 0.0;
+    r.nru_latency = nru_succeeded ? nru_latency_sum / nru_succeeded : 0.0;
+    r.wifi_access = w_acc_n ? w_acc / w_acc_n : 0.0;
+    r.nru_access = nru_access_count ? nru_access_sum / nru_access_count : 0.0;
+
+    r.wifi_cot = (w_data + w_ctrl) / T;
+    r.nru_cot = nru_airtime / T;
+    r.total_cot = r.wifi_cot + r.nru_cot;
+    r.wifi_eff = w_data / T;
+    r.nru_eff = nru_airtime / T;
+    r.total_eff = r.wifi_eff + r.nru_eff;
+
+    r.wifi_thr = point.wifi_nodes > 0 ? r.wifi_eff * WIFI_DATA_RATE_MBPS : 0.0;
+    r.nru_thr = point.nru_nodes > 0 ? r.nru_eff * NRU_DATA_RATE_MBPS : 0.0;
+
+    // Same fairness definitions as coexistanceSimpy.run_simulation()
+    if (r.wifi_cot > 0 || r.nru_cot > 0)
+        r.fairness = (r.total_cot * r.total_cot) /
+                     (2 * (r.wifi_cot * r.wifi_cot + r.nru_cot * r.nru_cot));
+    std::vector<double> thr;
+    for (const auto &st : stations)
+        thr.push_back(st.airtime_data / T * WIFI_DATA_RATE_MBPS);
+    if (point.nru_nodes > 0)
+        thr.push_back(r.nru_thr);
+    double sum = 0, sq = 0;
+    for (double x : thr) { sum += x; sq += x * x; }
+    if (!thr.empty() && sq > 0)
+        r.jains = (sum * sum) / (thr.size() * sq);
+    r.joint = r.fairness * r.total_cot;
+    return r;
+}
+
+/* ============================================
+ *  UHD HELPER STUBS (energy comes from the model)
+ * ============================================ */
+
+extern "C" {
+
+float noise_floor_dbm = -95.0f;
+float nru_config_ed_threshold_dbm = -72.0f;
+bool noise_calibrated = true;
+
+float nru_get_current_energy_dbm(void) {
+    return tl_engine ? tl_engine->sensed_energy_dbm() : noise_floor_dbm;
+}
+
+// Per sweep thread, like the engine
+static thread_local float tl_ed_threshold_dbm = -72.0f;
+
+int nru_lbt_check_timed(int sensing_time_us) {
+    nru_clock_sleep_us(sensing_time_us);
+    return nru_get_current_energy_dbm() < tl_ed_threshold_dbm ? 1 : 0;
+}
+
+// The model has no RF chain: TX starts at the grant
+void nru_note_tx_grant(uint64_t grant_us) { (void)grant_us; }
+uint32_t nru_get_rf_turnaround_us(void) { return 0; }
+bool nru_own_tx_masked(void) { return true; }
+
+void nru_set_ed_threshold(float threshold_dbm) { tl_ed_threshold_dbm = threshold_dbm; }
+float nru_get_ed_threshold(void) { return tl_ed_threshold_dbm; }
+void nru_set_cca_sequential(bool enabled, float false_free, float false_busy, int min_us) {
+    (void)enabled; (void)false_free; (void)false_busy; (void)min_us;
+}
+void nru_set_ed_bandwidth(double bw_hz, double offset_hz) { (void)bw_hz; (void)offset_hz; }
+void nru_set_ingest_conditioning(bool dc_removal, bool iq_balance, bool clip_check, float margin_db) {
+    (void)dc_removal; (void)iq_balance; (void)clip_check; (void)margin_db;
+}
+void nru_set_spectrum_monitor(int fft_size, int n_avg, double frame_rate_hz) {
+    (void)fft_size; (void)n_avg; (void)frame_rate_hz;
+}
+void nru_calibrate_noise_floor(int samples) { (void)samples; }
+void nru_start_noise_calibration(int max_measurements) { (void)max_measurements; }
+void nru_stop_rx_stream(void) {}
+void nru_restart_rx_stream(void) {}
+void nru_cleanup(void) {}
+
+} // extern "C"
+
+static void engine_advance(uint64_t until_us, void *ctx) {
+    static_cast<CoexEngine *>(ctx)->advance_to(until_us);
+}
+
+/* ============================================
+ *  REPLICATION RUNNER
+ * ============================================ */
+
+static SimResult run_replication(const SimParams &params, const SimPoint &pt, int seed) {
+    CoexEngine engine(params, pt, seed);
+    tl_engine = &engine;
+    nru_clock_use_virtual(0, engine_advance, &engine);
+
+    nru_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.enabled = true;
+    snprintf(cfg.mode, sizeof(cfg.mode), "%s", params.mode.c_str());
+    cfg.ed_threshold_dbm = pt.ed_threshold_dbm;
+    cfg.ed_sensing_time_us = params.sensing_us;
+    cfg.frame_period_ms = params.frame_period_ms;
+    cfg.tx_window_ms = params.tx_window_ms;
+    cfg.duty_cycle_percent = 100.0 * params.tx_window_ms / params.frame_period_ms;
+    cfg.duty_cap_percent = params.duty_cap_percent;
+    cfg.duty_window_ms = params.duty_window_ms;
+    cfg.mcot_ms = pt.mcot_ms;
+    cfg.cw_min = pt.cw_min;
+    cfg.cw_max = params.nru_cw_max;
+    cfg.log_lbt = false;
+    nru_lbt_init(&cfg);
+    nru_lbt_set_seed(static_cast<unsigned int>(seed) * 2654435761u);
+
+    SimResult r = engine.run(seed);
+
+    nru_clock_use_host();
+    tl_engine = nullptr;
+    return r;
+}
+
+static void write_csv(const std::string &path, const std::vector<SimResult> &rows) {
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f) {
+        perror(path.c_str());
+        return;
+    }
+    fprintf(f, "Seed,WiFi_Nodes,NRU_Nodes,WiFi_CW_Min,WiFi_CW_Max,NRU_CW_Min,NRU_CW_Max,"
+               "WiFi_Throughput,NRU_Throughput,Total_Throughput,WiFi_PLR,NRU_PLR,"
+               "WiFi_Latency,NRU_Latency,WiFi_Access_Delay,NRU_Access_Delay,WiFi_SINR,NRU_SINR,"
+               "Traditional_Fairness,Jains_Fairness,Joint_Metric,WiFi_COT,NRU_COT,Total_COT,"
+               "WiFi_Efficiency,NRU_Efficiency,Total_Efficiency,NRU_MCOT_ms,NRU_ED_dBm\n");
+    for (const auto &r : rows) {
+        fprintf(f, "%d,%d,%d,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.8f,%.8f,%.3f,%.3f,%.3f,%.3f,0,0,"
+                   "%.8f,%.8f,%.8f,%.8f,%.8f,%.8f,%.8f,%.8f,%.8f,%d,%d\n",
+                r.seed, r.point.wifi_nodes, r.point.nru_nodes,
+                r.wifi_cw_min, r.wifi_cw_max, r.point.cw_min, r.nru_cw_max,
+                r.wifi_thr, r.nru_thr, r.wifi_thr + r.nru_thr,
+                r.wifi_plr, r.nru_plr, r.wifi_latency, r.nru_latency,
+                r.wifi_access, r.nru_access,
+                r.fairness, r.jains, r.joint,
+                r.wifi_cot, r.nru_cot, r.total_cot,
+                r.wifi_eff, r.nru_eff, r.total_eff,
+                r.point.mcot_ms, r.point.ed_threshold_dbm);
+    }
+    fclose(f);
+}
+
+/* ============================================
+ *  COMMAND LINE
+ * ============================================ */
+
+// "a,b,c" or "start:stop[:step]" (inclusive)
+static std::vector<int> parse_list(const char *arg) {
+    std::vector<int> out;
+    std::string s(arg);
+    size_t pos = 0;
+    while (pos <= s.size()) {
+        size_t comma = s.find(',', pos);
+        std::string tok = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        int a, b, step = 1;
+        int n = sscanf(tok.c_str(), "%d:%d:%d", &a, &b, &step);
+        if (n >= 2) {
+            if (step == 0) step = 1;
+            if ((b - a) * step < 0) step = -step;
+            for (int v = a; step > 0 ? v <= b : v >= b; v += step)
+                out.push_back(v);
+        } else if (n == 1) {
+            out.push_back(a);
+        }
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    return out;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [OPTIONS]\n"
+           "  -r, --runs N            Replications per point (default 10)\n"
+           "      --seed N            First seed (default 1)\n"
+           "  -t, --simulation-time S Simulated seconds per replication (default 10)\n"
+           "      --wifi LIST         Wi-Fi station counts (default 1)\n"
+           "      --nru LIST          gNB count, 0 or 1 (default 1)\n"
+           "      --cw-min LIST       NR-U cw_min values (default 15)\n"
+           "      --cw-max N          NR-U cw_max, recorded only (default 1023)\n"
+           "      --mcot LIST         mcot_ms values (default 6)\n"
+           "      --ed LIST           ed_threshold_dbm values (default -72)\n"
+           "      --mode LBE|FBE      LBT mode (default LBE)\n"
+           "      --sensing-us N      ed_sensing_time_us (default 100)\n"
+           "      --frame-ms N        FBE frame period (default 10)\n"
+           "      --tx-window-ms N    FBE TX window (default 5)\n"
+           "      --duty-cap PCT      NR-U airtime cap per duty window (default off)\n"
+           "      --duty-window-ms N  Sliding window of the cap (default 1000)\n"
+           "      --wifi-cw-min N     Wi-Fi CWmin (default 15)\n"
+           "      --wifi-cw-max N     Wi-Fi CWmax (default 63)\n"
+           "      --wifi-frame-us N   Wi-Fi frame airtime (default 5400)\n"
+           "      --wifi-rx-dbm X     Wi-Fi power seen by the gNB (default -55)\n"
+           "      --nru-rx-dbm X      gNB power seen by Wi-Fi (default -55)\n"
+           "      --wifi-ed-dbm X     Wi-Fi CCA-ED threshold (default -62)\n"
+           "  -j, --threads N         Worker threads (default: all cores)\n"
+           "  -o, --output FILE       CSV output (default coexistence_des.csv)\n"
+           "LIST is a,b,c or start:stop[:step]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    SimParams p;
+    enum {
+        OPT_SEED = 256, OPT_WIFI, OPT_NRU, OPT_CWMIN, OPT_CWMAX, OPT_MCOT, OPT_ED, OPT_MODE,
+        OPT_SENSING, OPT_FRAME, OPT_TXWIN, OPT_WCWMIN, OPT_WCWMAX, OPT_WFRAME,
+        OPT_WIFIRX, OPT_NRURX, OPT_WIFIED, OPT_DUTYCAP, OPT_DUTYWIN
+    };
+    static const struct option opts[] = {
+        {"runs", required_argument, nullptr, 'r'},
+        {"seed", required_argument, nullptr, OPT_SEED},
+        {"simulation-time", required_argument, nullptr, 't'},
+        {"wifi", required_argument, nullptr, OPT_WIFI},
+        {"nru", required_argument, nullptr, OPT_NRU},
+        {"cw-min", required_argument, nullptr, OPT_CWMIN},
+        {"cw-max", required_argument, nullptr, OPT_CWMAX},
+        {"mcot", required_argument, nullptr, OPT_MCOT},
+        {"ed", required_argument, nullptr, OPT_ED},
+        {"mode", required_argument, nullptr, OPT_MODE},
+        {"sensing-us", required_argument, nullptr, OPT_SENSING},
+        {"frame-ms", required_argument, nullptr, OPT_FRAME},
+        {"tx-window-ms", required_argument, nullptr, OPT_TXWIN},
+        {"duty-cap", required_argument, nullptr, OPT_DUTYCAP},
+        {"duty-window-ms", required_argument, nullptr, OPT_DUTYWIN},
+        {"wifi-cw-min", required_argument, nullptr, OPT_WCWMIN},
+        {"wifi-cw-max", required_argument, nullptr, OPT_WCWMAX},
+        {"wifi-frame-us", required_argument, nullptr, OPT_WFRAME},
+        {"wifi-rx-dbm", required_argument, nullptr, OPT_WIFIRX},
+        {"nru-rx-dbm", required_argument, nullptr, OPT_NRURX},
+        {"wifi-ed-dbm", required_argument, nullptr, OPT_WIFIED},
+        {"threads", required_argument, nullptr, 'j'},
+        {"output", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "r:t:j:o:h", opts, nullptr)) != -1) {
+        switch (c) {
+            case 'r': p.runs = atoi(optarg); break;
+            case 't': p.sim_time_s = atof(optarg); break;
+            case 'j': p.threads = atoi(optarg); break;
+            case 'o': p.output = optarg; break;
+            case OPT_SEED: p.seed_start = atoi(optarg); break;
+            case OPT_WIFI: p.wifi_nodes = parse_list(optarg); break;
+            case OPT_NRU: p.nru_nodes = parse_list(optarg); break;
+            case OPT_CWMIN: p.cw_min = parse_list(optarg); break;
+            case OPT_CWMAX: p.nru_cw_max = atoi(optarg); break;
+            case OPT_MCOT: p.mcot_ms = parse_list(optarg); break;
+            case OPT_ED: p.ed_threshold_dbm = parse_list(optarg); break;
+            case OPT_MODE: p.mode = optarg; break;
+            case OPT_SENSING: p.sensing_us = atoi(optarg); break;
+            case OPT_FRAME: p.frame_period_ms = atoi(optarg); break;
+            case OPT_TXWIN: p.tx_window_ms = atoi(optarg); break;
+            case OPT_DUTYCAP: p.duty_cap_percent = atof(optarg); break;
+            case OPT_DUTYWIN: p.duty_window_ms = atoi(optarg); break;
+            case OPT_WCWMIN: p.wifi_cw_min = atoi(optarg); break;
+            case OPT_WCWMAX: p.wifi_cw_max = atoi(optarg); break;
+            case OPT_WFRAME: p.wifi_frame_us = strtoull(optarg, nullptr, 10); break;
+            case OPT_WIFIRX: p.wifi_rx_dbm = atof(optarg); break;
+            case OPT_NRURX: p.nru_rx_dbm = atof(optarg); break;
+            case OPT_WIFIED: p.wifi_ed_dbm = atof(optarg); break;
+            case 'h': usage(argv[0]); return 0;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    if (p.mode != "LBE" && p.mode != "FBE") {
+        fprintf(stderr, "[NRU][SIM] Unknown mode %s\n", p.mode.c_str());
+        return 1;
+    }
+    if (p.sensing_us <= 0 || p.runs <= 0 || p.sim_time_s <= 0 || p.frame_period_ms <= 0) {
+        fprintf(stderr, "[NRU][SIM] runs, simulation time, sensing-us and frame-ms must be > 0\n");
+        return 1;
+    }
+    for (int n : p.nru_nodes) {
+        if (n < 0 || n > 1) {
+            fprintf(stderr, "[NRU][SIM] --nru accepts 0 or 1 (nru_lbt.c runs one LBT instance)\n");
+            return 1;
+        }
+    }
+
+    std::vector<SimPoint> points;
+    for (int w : p.wifi_nodes)
+        for (int n : p.nru_nodes)
+            for (int cw : p.cw_min)
+                for (int m : p.mcot_ms)
+                    for (int ed : p.ed_threshold_dbm)
+                        if (w > 0 || n > 0)
+                            points.push_back({w, n, cw, m, ed});
+
+    const size_t jobs = points.size() * static_cast<size_t>(p.runs);
+    unsigned int nthreads = p.threads > 0 ? p.threads : std::thread::hardware_concurrency();
+    if (nthreads == 0) nthreads = 1;
+    nthreads = static_cast<unsigned int>(std::min<size_t>(nthreads, jobs));
+
+    printf("[NRU][SIM] %zu points x %d runs = %zu replications on %u threads (%.1f s each)\n",
+           points.size(), p.runs, jobs, nthreads, p.sim_time_s);
+
+    nru_clock_init();
+    uint64_t t0 = nru_clock_now_us();
+
+    std::vector<SimResult> results(jobs);
+    std::atomic<size_t> next_job{0};
+    std::atomic<size_t> done{0};
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < nthreads; i++) {
+        workers.emplace_back([&]() {
+            size_t j;
+            while ((j = next_job.fetch_add(1, std::memory_order_relaxed)) < jobs) {
+                const SimPoint &pt = points[j / p.runs];
+                int seed = p.seed_start + static_cast<int>(j % p.runs);
+                results[j] = run_replication(p, pt, seed);
+                size_t d = done.fetch_add(1, std::memory_order_relaxed) + 1;
+                if (d % 100 == 0 || d == jobs)
+                    fprintf(stderr, "\r[NRU][SIM] %zu/%zu", d, jobs);
+            }
+        });
+    }
+    for (auto &t : workers)
+        t.join();
+    fprintf(stderr, "\n");
+
+    double wall_s = (nru_clock_now_us() - t0) / 1e6;
+    write_csv(p.output, results);
+    printf("[NRU][SIM] Done in %.2f s (%.0fx real time) -> %s\n",
+           wall_s, wall_s > 0 ? jobs * p.sim_time_s / wall_s : 0.0, p.output.c_str());
+    return 0;
+}
@@ -0,0 +1,381 @@
+/*
+ * NR-U Co-located gNB Coordination
+ * --------------------------------
+ * Shared-memory group of gNB processes on one host (see nru_coord.h).
+ * The first process to attach creates and initializes the segment; the
+ * others wait for its magic. Member schedules are seqlocks written only
+ * by their owner, read by everyone. The STAGGER exclusion words are the
+ * only fields several processes write, always by CAS. Operators whose ids
+ * share a word also exclude each other: less air, never a collision.
+ *
+ * The FBE phase is rescanned at most every NRU_COORD_REFRESH_US; the LBE
+ * queries read the member slots directly, once per access attempt.
+ *
+ * Location: common/utils/nru_coord.c
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef NRU_LBT_STANDALONE
+#include "nru_clock.h"
+#include "nru_coord.h"
+#include "nru_seqlock.h"
+#else
+#include "common/utils/nru_clock.h"
+#include "common/utils/nru_coord.h"
+#include "common/utils/nru_seqlock.h"
+#endif
+
+#define COORD_ATTACH_WAIT_MS 100           // Creator's initialization deadline
+#define COORD_READ_TRIES     64
+
+static NRU_TLS nru_coord_shm_t *coord_shm;
+static NRU_TLS int coord_self = -1;
+static NRU_TLS nru_coord_cfg_t coord_cfg;
+
+// Cached FBE phase (recomputed every NRU_COORD_REFRESH_US)
+static NRU_TLS uint64_t fbe_scan_us;
+static NRU_TLS uint64_t fbe_frame_us, fbe_window_us, fbe_own_us, fbe_offset_us;
+static NRU_TLS uint64_t heartbeat_us;
+static NRU_TLS uint64_t want_since_us;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static inline size_t shm_bytes(void) {
+    return sizeof(nru_coord_shm_t) + NRU_COORD_MAX_MEMBERS * sizeof(nru_coord_member_t);
+}
+
+static inline nru_coord_member_t *member(int i) {
+    return (nru_coord_member_t *)((char *)coord_shm + sizeof(nru_coord_shm_t)) + i;
+}
+
+static bool process_alive(uint32_t pid) {
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+}
+
+// Consistent copy of slot i (false if free or being rewritten throughout)
+static bool read_member(int i, nru_coord_member_t *out) {
+    const nru_coord_member_t *m = member(i);
+    for (int t = 0; t < COORD_READ_TRIES; t++) {
+        const uint32_t seq = nru_seq_read_begin(&m->seq);
+        if (seq & 1u)
+            continue;
+        memcpy(out, m, sizeof(*out));
+        if (!nru_seq_read_retry(&m->seq, seq))
+            return out->pid != 0;
+    }
+    return false;
+}
+
+// Same operator, alive, and not us
+static bool is_peer(int i, const nru_coord_member_t *m, uint64_t now_us) {
+    return i != coord_self && m->operator_id == coord_cfg.operator_id &&
+           now_us < m->heartbeat_us + NRU_COORD_STALE_US;
+}
+
+static void touch(uint64_t now_us) {
+    if (now_us - heartbeat_us < NRU_COORD_REFRESH_US)
+        return;
+    heartbeat_us = now_us;
+    __atomic_store_n(&member(coord_self)->heartbeat_us, now_us, __ATOMIC_RELAXED);
+}
+
+static inline bool staggered(void) {
+    return coord_shm && coord_cfg.mode == NRU_COORD_STAGGER;
+}
+
+static inline uint64_t *excl_word(void) {
+    return &coord_shm->excl[coord_cfg.operator_id % NRU_COORD_MAX_MEMBERS];
+}
+
+// Kept off the channel (waiting since the first refusal), or served
+static void set_want(uint64_t now_us, bool waiting) {
+    nru_coord_member_t *m = member(coord_self);
+    if (!waiting) {
+        want_since_us = 0;
+    } else if (!want_since_us) {
+        want_since_us = now_us;
+    }
+    __atomic_store_n(&m->want_since_us, want_since_us, __ATOMIC_RELAXED);
+    __atomic_store_n(&m->want_seen_us, now_us, __ATOMIC_RELAXED);
+}
+
+// A peer still asking (within a refresh period) that has waited longer
+static bool peer_waiting_longer(uint64_t now_us) {
+    for (int i = 0; i < NRU_COORD_MAX_MEMBERS; i++) {
+        nru_coord_member_t p;
+        if (!read_member(i, &p) || !is_peer(i, &p, now_us) || !p.want_since_us ||
+            now_us >= p.want_seen_us + NRU_COORD_REFRESH_US)
+            continue;
+        if (!want_since_us || p.want_since_us < want_since_us ||
+            (p.want_since_us == want_since_us && i < coord_self))
+            return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------
+// Membership
+// ---------------------------------------------------------------------
+int nru_coord_attach(const char *shm_name, const nru_coord_cfg_t *cfg) {
+    nru_coord_detach();
+    if (!cfg || cfg->mode == NRU_COORD_OFF)
+        return -1;
+
+    const char *name = (shm_name && shm_name[0]) ? shm_name : NRU_COORD_SHM_NAME;
+    const size_t bytes = shm_bytes();
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0666);
+    const bool creator = fd >= 0;
+    if (!creator) {
+        if (errno != EEXIST || (fd = shm_open(name, O_RDWR, 0)) < 0)
+            return -1;
+    } else if (ftruncate(fd, (off_t)bytes) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return -1;
+    }
+
+    // Another creator may still be sizing the segment
+    struct stat st;
+    for (int t = 0; !creator; t++) {
+        if (fstat(fd, &st) == 0 && (size_t)st.st_size >= bytes)
+            break;
+        if (t == COORD_ATTACH_WAIT_MS) {
+            close(fd);
+            return -1;
+        }
+        usleep(1000);
+    }
+    void *map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return -1;
+
+    nru_coord_shm_t *hdr = (nru_coord_shm_t *)map;
+    if (creator) {
+        hdr->version = NRU_COORD_VERSION;
+        hdr->n_members = NRU_COORD_MAX_MEMBERS;
+        hdr->member_bytes = sizeof(nru_coord_member_t);
+        for (int i = 0; i < NRU_COORD_MAX_MEMBERS; i++)
+            __atomic_store_n(&hdr->excl[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&hdr->magic, NRU_COORD_MAGIC, __ATOMIC_RELEASE);
+    } else {
+        for (int t = 0; __atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != NRU_COORD_MAGIC; t++) {
+            if (t == COORD_ATTACH_WAIT_MS) {
+                munmap(map, bytes);
+                return -1;
+            }
+            usleep(1000);
+        }
+        if (hdr->version != NRU_COORD_VERSION || hdr->n_members != NRU_COORD_MAX_MEMBERS ||
+            hdr->member_bytes != sizeof(nru_coord_member_t)) {
+            munmap(map, bytes);
+            return -1;
+        }
+    }
+    coord_shm = hdr;
+
+    // Take a free slot, or one whose owner has died
+    const uint32_t pid = (uint32_t)getpid();
+    for (int i = 0; i < NRU_COORD_MAX_MEMBERS && coord_self < 0; i++) {
+        uint32_t owner = __atomic_load_n(&member(i)->pid, __ATOMIC_ACQUIRE);
+        if (owner != 0 && process_alive(owner))
+            continue;
+        if (__atomic_compare_exchange_n(&member(i)->pid, &owner, pid, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            coord_self = i;
+    }
+    if (coord_self < 0) {
+        munmap(map, bytes);
+        coord_shm = NULL;
+        return -1;
+    }
+
+    coord_cfg = *cfg;
+    const uint64_t now = nru_clock_now_us();
+    nru_coord_member_t *m = member(coord_self);
+    nru_seq_write_begin(&m->seq);
+    m->operator_id = cfg->operator_id;
+    m->cell_id = cfg->cell_id;
+    m->mode = (uint32_t)cfg->mode;
+    m->fbe = 0;
+    m->frame_us = m->frame_offset_us = m->tx_window_us = 0;
+    m->cot_from_us = m->cot_end_us = 0;
+    m->want_since_us = m->want_seen_us = 0;
+    nru_seq_write_end(&m->seq);
+    want_since_us = 0;
+    heartbeat_us = now;
+    __atomic_store_n(&m->heartbeat_us, now, __ATOMIC_RELAXED);
+    fbe_frame_us = fbe_scan_us = 0;
+    return coord_self;
+}
+
+void nru_coord_detach(void) {
+    if (!coord_shm)
+        return;
+    nru_coord_release(nru_clock_now_us());
+    nru_coord_member_t *m = member(coord_self);
+    nru_seq_write_begin(&m->seq);
+    m->cot_from_us = m->cot_end_us = 0;
+    m->heartbeat_us = 0;
+    nru_seq_write_end(&m->seq);
+    __atomic_store_n(&m->pid, 0, __ATOMIC_RELEASE);
+    munmap(coord_shm, shm_bytes());
+    coord_shm = NULL;
+    coord_self = -1;
+}
+
+nru_coord_mode_t nru_coord_mode(void) {
+    return coord_shm ? coord_cfg.mode : NRU_COORD_OFF;
+}
+
+// ---------------------------------------------------------------------
+// FBE phase
+// ---------------------------------------------------------------------
+uint64_t nru_coord_fbe_offset_us(uint64_t now_us, uint64_t frame_us, uint64_t tx_window_us,
+                                 uint64_t own_offset_us) {
+    if (!coord_shm || frame_us == 0)
+        return own_offset_us;
+    if (frame_us == fbe_frame_us && tx_window_us == fbe_window_us && own_offset_us == fbe_own_us &&
+        now_us - fbe_scan_us < NRU_COORD_REFRESH_US)
+        return fbe_offset_us;
+
+    // Leader = lowest live member on the same frame; stagger behind the
+    // windows of every such member ranked before us
+    uint64_t offset = own_offset_us, before_us = 0;
+    bool leader_found = false;
+    for (int i = 0; i < coord_self; i++) {
+        nru_coord_member_t p;
+        if (!read_member(i, &p) || !is_peer(i, &p, now_us) || !p.fbe || p.frame_us != frame_us)
+            continue;
+        if (!leader_found) {
+            offset = p.frame_offset_us;
+            leader_found = true;
+        }
+        before_us += p.tx_window_us;
+    }
+    if (coord_cfg.mode == NRU_COORD_STAGGER)
+        offset += before_us;
+    offset %= frame_us;
+
+    nru_coord_member_t *m = member(coord_self);
+    nru_seq_write_begin(&m->seq);
+    m->fbe = 1;
+    m->frame_us = frame_us;
+    m->frame_offset_us = offset;
+    m->tx_window_us = tx_window_us;
+    nru_seq_write_end(&m->seq);
+    heartbeat_us = now_us;
+    __atomic_store_n(&m->heartbeat_us, now_us, __ATOMIC_RELAXED);
+
+    fbe_frame_us = frame_us;
+    fbe_window_us = tx_window_us;
+    fbe_own_us = own_offset_us;
+    fbe_offset_us = offset;
+    fbe_scan_us = now_us;
+    return offset;
+}
+
+// ---------------------------------------------------------------------
+// COT schedule
+// ---------------------------------------------------------------------
+void nru_coord_publish_cot(uint64_t from_us, uint64_t end_us) {
+    if (!coord_shm)
+        return;
+    nru_coord_member_t *m = member(coord_self);
+    nru_seq_write_begin(&m->seq);
+    m->cot_from_us = from_us;
+    m->cot_end_us = end_us;
+    nru_seq_write_end(&m->seq);
+}
+
+uint64_t nru_coord_peer_cot_end(uint64_t now_us) {
+    if (!coord_shm)
+        return 0;
+    touch(now_us);
+    uint64_t end = 0;
+    for (int i = 0; i < NRU_COORD_MAX_MEMBERS; i++) {
+        nru_coord_member_t p;
+        if (!read_member(i, &p) || !is_peer(i, &p, now_us))
+            continue;
+        if (p.cot_from_us <= now_us && now_us < p.cot_end_us && p.cot_end_us > end)
+            end = p.cot_end_us;
+    }
+    return end;
+}
+
+// ---------------------------------------------------------------------
+// STAGGER exclusion
+// ---------------------------------------------------------------------
+// Held by a peer, or free with a peer ahead of us in the queue
+static bool must_wait(uint64_t v, uint64_t now_us) {
+    const uint64_t holder = v & 0xffu;
+    if (holder && holder != (uint64_t)coord_self + 1 && (v >> 8) > now_us)
+        return true;
+    return peer_waiting_longer(now_us);
+}
+
+bool nru_coord_my_turn(uint64_t now_us) {
+    if (!staggered())
+        return true;
+    touch(now_us);
+    if (!must_wait(__atomic_load_n(excl_word(), __ATOMIC_ACQUIRE), now_us))
+        return true;
+    set_want(now_us, true);
+    return false;
+}
+
+bool nru_coord_claim(uint64_t now_us, uint64_t end_us) {
+    if (!staggered())
+        return true;
+    const uint64_t mine = (end_us << 8) | ((uint64_t)coord_self + 1);
+    uint64_t v = __atomic_load_n(excl_word(), __ATOMIC_ACQUIRE);
+    for (;;) {
+        if (must_wait(v, now_us)) {
+            set_want(now_us, true);
+            return false;
+        }
+        if (__atomic_compare_exchange_n(excl_word(), &v, mine, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            set_want(now_us, false);
+            return true;
+        }
+    }
+}
+
+void nru_coord_release(uint64_t now_us) {
+    if (!staggered())
+        return;
+    uint64_t v = __atomic_load_n(excl_word(), __ATOMIC_ACQUIRE);
+    while ((v & 0xffu) == (uint64_t)coord_self + 1 && (v >> 8) > now_us) {
+        const uint64_t mine = (now_us << 8) | ((uint64_t)coord_self + 1);
+        if (__atomic_compare_exchange_n(excl_word(), &v, mine, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            break;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Snapshot
+// ---------------------------------------------------------------------
+int nru_coord_members(nru_coord_member_t *out, int max, int *self) {
+    if (self)
+        *self = -1;
+    if (!coord_shm || !out)
+        return 0;
+    int n = 0;
+    for (int i = 0; i < NRU_COORD_MAX_MEMBERS && n < max; i++) {
+        if (!read_member(i, &out[n]))
+            continue;
+        if (i == coord_self && self)
+            *self = n;
+        n++;
+    }
+    return n;
+}
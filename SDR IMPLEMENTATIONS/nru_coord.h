@@ -0,0 +1,167 @@
+/*
+ * NR-U Co-located gNB Coordination Header
+ * ---------------------------------------
+ * gNB processes on one host share a POSIX shared-memory segment in which
+ * each publishes its FBE frame and its current COT. Same-operator cells
+ * then stop treating each other as foreign energy:
+ *
+ *  - ALIGN:   FBE frames follow the group leader's phase (all cells send
+ *             in the same window); an LBE cell joins a peer's running COT
+ *             instead of deferring to it.
+ *  - STAGGER: FBE windows are laid end to end within the frame; LBE COTs
+ *             are mutually exclusive through one word per operator, so a cell
+ *             waits for the peer's COT end instead of backing off. The
+ *             member waiting longest goes next.
+ *
+ * Members with another operator_id or FBE frame period are listed but
+ * ignored. All times are nru_clock (CLOCK_MONOTONIC) microseconds, which
+ * every process on the host shares.
+ *
+ * Shared-memory layout (native endianness):
+ *   nru_coord_shm_t                         header, 128 bytes
+ *   NRU_COORD_MAX_MEMBERS x member_bytes    nru_coord_member_t slots
+ * A slot belongs to the process in pid; slots of dead processes are
+ * reclaimed on attach. Each slot's schedule is a seqlock (seq odd while
+ * the owner writes it).
+ *
+ * Location: common/utils/nru_coord.h
+ */
+
+#ifndef NRU_COORD_H
+#define NRU_COORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_COORD_SHM_NAME       "/nru_coord"
+#define NRU_COORD_MAGIC          0x434f524eu    // "NROC"
+#define NRU_COORD_VERSION        1
+#define NRU_COORD_MAX_MEMBERS    8
+#define NRU_COORD_REFRESH_US     10000          // Heartbeat / peer rescan period
+#define NRU_COORD_STALE_US       200000         // Silent this long = not a peer
+
+typedef enum {
+    NRU_COORD_OFF = 0,
+    NRU_COORD_ALIGN = 1,
+    NRU_COORD_STAGGER = 2
+} nru_coord_mode_t;
+
+typedef struct {
+    nru_coord_mode_t mode;
+    uint32_t operator_id;              // Only members with the same id coordinate
+    int32_t cell_id;                   // Shown to peers and tools (-1 = none)
+} nru_coord_cfg_t;
+
+/* ============================================
+ *  SHARED-MEMORY LAYOUT
+ * ============================================ */
+
+typedef struct {
+    uint32_t magic;            // NRU_COORD_MAGIC once initialized
+    uint32_t version;
+    uint32_t n_members;
+    uint32_t member_bytes;     // Stride between member slots
+    uint64_t excl[NRU_COORD_MAX_MEMBERS];  // STAGGER COT exclusion per operator_id % n:
+                                           // end_us << 8 | (holder + 1)
+    uint64_t reserved[6];
+} nru_coord_shm_t;
+
+typedef struct {
+    uint32_t pid;              // Owner process, 0 = free
+    uint32_t seq;              // Odd while the schedule below is written
+    uint32_t operator_id;
+    int32_t cell_id;
+    uint32_t mode;             // nru_coord_mode_t
+    uint32_t fbe;              // 1 = FBE, 0 = LBE
+    uint64_t heartbeat_us;     // Last sign of life
+    uint64_t frame_us;         // FBE frame period
+    uint64_t frame_offset_us;  // FBE frame phase in use (time mod frame_us)
+    uint64_t tx_window_us;     // FBE TX window
+    uint64_t cot_from_us;      // Latest COT
+    uint64_t cot_end_us;
+    uint64_t want_since_us;    // STAGGER: waiting for the channel since (0 = not waiting)
+    uint64_t want_seen_us;     // STAGGER: last time we were kept off
+    uint64_t reserved[5];
+} nru_coord_member_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Join the group (creates the segment if needed)
+ * @param shm_name: POSIX shm name (NULL or "" = NRU_COORD_SHM_NAME)
+ * @return: Member index, -1 if the segment cannot be mapped, is full or
+ *          has another layout version
+ */
+int nru_coord_attach(const char *shm_name, const nru_coord_cfg_t *cfg);
+
+/**
+ * Free our slot and unmap (the segment itself is kept for the others)
+ */
+void nru_coord_detach(void);
+
+/**
+ * Mode in effect (NRU_COORD_OFF when not attached)
+ */
+nru_coord_mode_t nru_coord_mode(void);
+
+/**
+ * FBE frame phase to use from now on
+ * ALIGN returns the leader's phase (the lowest live member sharing the
+ * frame period), STAGGER the leader's phase plus the TX windows of the
+ * members ranked before us; detached or alone it is own_offset_us.
+ * Also publishes our frame and refreshes our heartbeat.
+ */
+uint64_t nru_coord_fbe_offset_us(uint64_t now_us, uint64_t frame_us, uint64_t tx_window_us,
+                                 uint64_t own_offset_us);
+
+/**
+ * Publish a COT we opened (radio time, from_us may lie in the past)
+ */
+void nru_coord_publish_cot(uint64_t from_us, uint64_t end_us);
+
+/**
+ * ALIGN: end of the latest peer COT running at now_us (0 = none)
+ */
+uint64_t nru_coord_peer_cot_end(uint64_t now_us);
+
+/**
+ * STAGGER: whether we may contend now; false while a peer holds the
+ * channel or has been waiting longer than us (always true in other modes
+ * or detached)
+ */
+bool nru_coord_my_turn(uint64_t now_us);
+
+/**
+ * STAGGER: take the channel until end_us
+ * @return: true if ours (always true in other modes or detached), false
+ *          if a peer took it first or its turn has come
+ */
+bool nru_coord_claim(uint64_t now_us, uint64_t end_us);
+
+/**
+ * Give back what remains of our claim (COT ended early)
+ */
+void nru_coord_release(uint64_t now_us);
+
+/**
+ * Snapshot of the occupied slots (tools, logging)
+ * @param self: Our index in out (-1 if not listed), may be NULL
+ * @return: Members copied
+ */
+int nru_coord_members(nru_coord_member_t *out, int max, int *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_COORD_H */
@@ -0,0 +1,319 @@
+/*
+ * NR-U DSP Kernels
+ * ----------------
+ * Block-power reductions written as eight independent accumulator lanes so
+ * the compiler emits packed SSE/AVX/NEON code without -ffast-math. Block
+ * kernels have fixed-length instances for the common RX rates.
+ *
+ * Location: common/utils/nru_dsp.cpp
+ */
+
+#include <type_traits>
+#include "nru_dsp.h"
+
+static const float SC16_SCALE = 1.0f / (32768.0f * 32768.0f);
+
+/* ============================================
+ *  INNER KERNELS
+ * ============================================ */
+
+// Sum of I^2 + Q^2 over n complex int16 samples
+static inline float sum_power_sc16(const int16_t *iq, size_t n) {
+    float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    const size_t vals = 2 * n, body = vals & ~static_cast<size_t>(7);
+    for (size_t i = 0; i < body; i += 8) {
+        for (int k = 0; k < 8; k++) {
+            float v = static_cast<float>(iq[i + k]);
+            acc[k] += v * v;
+        }
+    }
+    float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    for (size_t i = body; i < vals; i++) {
+        float v = static_cast<float>(iq[i]);
+        sum += v * v;
+    }
+    return sum;
+}
+
+// Sum of I^2 + Q^2 over n complex float samples
+static inline float sum_power_fc32(const float *iq, size_t n) {
+    float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    const size_t vals = 2 * n, body = vals & ~static_cast<size_t>(7);
+    for (size_t i = 0; i < body; i += 8) {
+        for (int k = 0; k < 8; k++)
+            acc[k] += iq[i + k] * iq[i + k];
+    }
+    float sum = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    for (size_t i = body; i < vals; i++)
+        sum += iq[i] * iq[i];
+    return sum;
+}
+
+/* ============================================
+ *  RATE SPECIALIZATIONS
+ * ============================================ */
+
+// The ~1 us block (lround(rate * 1e-6) samples) of the common RX rates is
+// compiled in as a constant, so trip counts and tails are resolved at
+// compile time; the switch runs once per call, not per sample.
+//   15.36 / 23.04 / 30.72 / 46.08 / 61.44 / 92.16 / 122.88 Msps
+template <typename F>
+static inline size_t with_block_len(size_t block_len, F &&f) {
+    switch (block_len) {
+    case 15:  return f(std::integral_constant<size_t, 15>());
+    case 23:  return f(std::integral_constant<size_t, 23>());
+    case 31:  return f(std::integral_constant<size_t, 31>());
+    case 46:  return f(std::integral_constant<size_t, 46>());
+    case 61:  return f(std::integral_constant<size_t, 61>());
+    case 92:  return f(std::integral_constant<size_t, 92>());
+    case 123: return f(std::integral_constant<size_t, 123>());
+    default:  return f(std::integral_constant<size_t, 0>());
+    }
+}
+
+// BL: compile-time block length, 0 = use block_len
+static inline float sum_power(const int16_t *iq, size_t n) { return sum_power_sc16(iq, n) * SC16_SCALE; }
+static inline float sum_power(const float *iq, size_t n) { return sum_power_fc32(iq, n); }
+
+template <size_t BL, typename T>
+static size_t block_power(const T *iq, size_t n_samples, size_t block_len, float *out) {
+    const size_t bl = BL ? BL : block_len;
+    const size_t blocks = n_samples / bl;
+    const float scale = 1.0f / static_cast<float>(bl);
+    for (size_t b = 0; b < blocks; b++)
+        out[b] = sum_power(iq + 2 * b * bl, bl) * scale;
+    return blocks;
+}
+
+/* ============================================
+ *  CONDITIONING KERNEL
+ * ============================================ */
+
+// One span with fixed DC over four value lanes (even lanes I, odd lanes Q,
+// two samples per step); the cross term reads the I of the same sample.
+// Returns corrected power; raw sums go to sum[2], moments to mom[3].
+template <typename T>
+static inline float condition_span(const nru_cond_t *c, const T *in, float scale, size_t n,
+                                   float *out, float sum[2], float mom[3], uint64_t *clipped) {
+    const float lvl = (c->clip_level > 0.0f) ? c->clip_level : INFINITY;
+    const float dc[4] = { c->dc[0], c->dc[1], c->dc[0], c->dc[1] };
+    const float g[4] = { c->gain_i, c->gain_q, c->gain_i, c->gain_q };
+    const float cr[4] = { 0.0f, c->cross_q, 0.0f, c->cross_q };
+    float s[4] = {0, 0, 0, 0}, sq[4] = {0, 0, 0, 0}, x2[4] = {0, 0, 0, 0}, p[4] = {0, 0, 0, 0};
+    float clip[4] = {0, 0, 0, 0};
+    const size_t vals = 2 * n;
+    for (size_t v = 0; v + 4 <= vals; v += 4) {
+        float r[4], x[4];
+        for (int k = 0; k < 4; k++) {
+            r[k] = scale * static_cast<float>(in[v + k]);
+            x[k] = r[k] - dc[k];
+        }
+        const float xi[4] = { x[0], x[0], x[2], x[2] };
+        for (int k = 0; k < 4; k++) {
+            const float y = g[k] * x[k] + cr[k] * xi[k];
+            out[v + k] = y;
+            clip[k] += (fabsf(r[k]) >= lvl) ? 1.0f : 0.0f;
+            s[k] += r[k];
+            sq[k] += x[k] * x[k];
+            x2[k] += x[k] * xi[k];
+            p[k] += y * y;
+        }
+    }
+    if (n & 1) {
+        const size_t v = vals - 2;
+        const float ri = scale * static_cast<float>(in[v]);
+        const float rq = scale * static_cast<float>(in[v + 1]);
+        const float xi = ri - dc[0], xq = rq - dc[1];
+        const float yi = g[0] * xi, yq = cr[1] * xi + g[1] * xq;
+        out[v] = yi;
+        out[v + 1] = yq;
+        clip[0] += (fabsf(ri) >= lvl) ? 1.0f : 0.0f;
+        clip[1] += (fabsf(rq) >= lvl) ? 1.0f : 0.0f;
+        s[0] += ri;
+        s[1] += rq;
+        sq[0] += xi * xi;
+        sq[1] += xq * xq;
+        x2[1] += xi * xq;
+        p[0] += yi * yi;
+        p[1] += yq * yq;
+    }
+    sum[0] = s[0] + s[2];
+    sum[1] = s[1] + s[3];
+    mom[0] = sq[0] + sq[2];
+    mom[1] = sq[1] + sq[3];
+    mom[2] = x2[1] + x2[3];
+    *clipped += static_cast<uint64_t>((clip[0] + clip[1]) + (clip[2] + clip[3]));
+    return (p[0] + p[1]) + (p[2] + p[3]);
+}
+
+// Blocks share the DC estimate, which moves once per block, so the inner
+// loop has no sample-to-sample dependency
+template <size_t BL, typename T>
+static size_t condition(nru_cond_t *c, const T *in, float scale, size_t n_samples,
+                        size_t block_len, float *out, float *block_power, int track) {
+    const size_t bl = BL ? BL : block_len;
+    size_t blocks = 0;
+    for (size_t pos = 0; pos < n_samples; pos += bl) {
+        float sum[2], mom[3], p;
+        uint64_t clipped = 0;
+        size_t n = n_samples - pos;
+        if (n >= bl) {
+            n = bl;
+            p = condition_span(c, in + 2 * pos, scale, bl, out + 2 * pos, sum, mom, &clipped);
+            if (block_power)
+                block_power[blocks] = p / static_cast<float>(bl);
+            blocks++;
+        } else {
+            p = condition_span(c, in + 2 * pos, scale, n, out + 2 * pos, sum, mom, &clipped);
+        }
+        if (!track) continue;
+
+        const float a = c->dc_alpha * static_cast<float>(n) / static_cast<float>(bl);
+        c->dc[0] += a * (sum[0] / static_cast<float>(n) - c->dc[0]);
+        c->dc[1] += a * (sum[1] / static_cast<float>(n) - c->dc[1]);
+        c->sum_ii += mom[0];
+        c->sum_qq += mom[1];
+        c->sum_iq += mom[2];
+        c->n_moments += n;
+        c->clipped += clipped;
+    }
+    return blocks;
+}
+
+extern "C" {
+
+/* ============================================
+ *  BLOCK POWER
+ * ============================================ */
+
+size_t nru_block_power_sc16(const int16_t *iq, size_t n_samples, size_t block_len, float *out) {
+    if (!iq || !out || block_len == 0) return 0;
+    return with_block_len(block_len, [&](auto bl) {
+        return block_power<decltype(bl)::value>(iq, n_samples, block_len, out);
+    });
+}
+
+size_t nru_block_power_fc32(const float *iq, size_t n_samples, size_t block_len, float *out) {
+    if (!iq || !out || block_len == 0) return 0;
+    return with_block_len(block_len, [&](auto bl) {
+        return block_power<decltype(bl)::value>(iq, n_samples, block_len, out);
+    });
+}
+
+int nru_dsp_block_len_specialized(size_t block_len) {
+    return with_block_len(block_len, [](auto bl) { return static_cast<size_t>(decltype(bl)::value != 0); }) ? 1 : 0;
+}
+
+float nru_mean_power_fc32(const float *iq, size_t n_samples) {
+    if (!iq || n_samples == 0) return 0.0f;
+    return sum_power_fc32(iq, n_samples) / static_cast<float>(n_samples);
+}
+
+/* ============================================
+ *  INGEST CONDITIONING
+ * ============================================ */
+
+void nru_cond_init(nru_cond_t *c) {
+    if (!c) return;
+    c->gain_i = 1.0f;
+    c->gain_q = 1.0f;
+    c->cross_q = 0.0f;
+    c->dc_alpha = 0.0f;
+    c->clip_level = 0.0f;
+    c->dc[0] = c->dc[1] = 0.0f;
+    c->sum_ii = c->sum_qq = c->sum_iq = 0.0;
+    c->n_moments = 0;
+    c->clipped = 0;
+}
+
+size_t nru_condition_fc32(nru_cond_t *c, const float *in, size_t n_samples, size_t block_len,
+                          float *out, float *block_power, int track) {
+    if (!c || !in || !out || block_len == 0) return 0;
+    return with_block_len(block_len, [&](auto bl) {
+        return condition<decltype(bl)::value>(c, in, 1.0f, n_samples, block_len, out, block_power, track);
+    });
+}
+
+size_t nru_condition_sc16(nru_cond_t *c, const int16_t *in, size_t n_samples, size_t block_len,
+                          float *out, float *block_power, int track) {
+    if (!c || !in || !out || block_len == 0) return 0;
+    return with_block_len(block_len, [&](auto bl) {
+        return condition<decltype(bl)::value>(c, in, 1.0f / 32768.0f, n_samples, block_len, out, block_power, track);
+    });
+}
+
+/* ============================================
+ *  FILTERING
+ * ============================================ */
+
+// Even lanes accumulate I, odd lanes Q, so one tap pair meets one sample
+size_t nru_fir_decim_fc32(const float *iq, size_t n_samples, const float *taps2, size_t n_taps,
+                          size_t decim, size_t first, float *out) {
+    if (!iq || !taps2 || !out || n_taps == 0 || decim == 0 || first + 1 < n_taps)
+        return 0;
+    const size_t vals = 2 * n_taps;
+    size_t n_out = 0;
+    for (size_t p = first; p < n_samples; p += decim, n_out++) {
+        const float *x = iq + 2 * (p + 1 - n_taps);
+        float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (size_t j = 0; j + 8 <= vals; j += 8) {
+            for (int k = 0; k < 8; k++)
+                acc[k] += taps2[j + k] * x[j + k];
+        }
+        out[2 * n_out] = (acc[0] + acc[2]) + (acc[4] + acc[6]);
+        out[2 * n_out + 1] = (acc[1] + acc[3]) + (acc[5] + acc[7]);
+    }
+    return n_out;
+}
+
+/* ============================================
+ *  CORRELATION
+ * ============================================ */
+
+// Written with explicit real arithmetic: std::complex multiplies go through
+// the NaN-checking libgcc path without -ffast-math and do not vectorize.
+void nru_autocorr_fc32(const float *iq, size_t n_samples, size_t lag,
+                       float corr[2], float energy[2]) {
+    float re[4] = {0, 0, 0, 0}, im[4] = {0, 0, 0, 0};
+    float e0[4] = {0, 0, 0, 0}, e1[4] = {0, 0, 0, 0};
+    const size_t n = (n_samples > lag) ? n_samples - lag : 0;
+    const float *a = iq;
+    const float *b = iq + 2 * lag;
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        for (int j = 0; j < 4; j++) {
+            float ar = a[2 * (k + j)], ai = a[2 * (k + j) + 1];
+            float br = b[2 * (k + j)], bi = b[2 * (k + j) + 1];
+            re[j] += ar * br + ai * bi;
+            im[j] += ai * br - ar * bi;
+            e0[j] += ar * ar + ai * ai;
+            e1[j] += br * br + bi * bi;
+        }
+    }
+    float sr = (re[0] + re[1]) + (re[2] + re[3]);
+    float si = (im[0] + im[1]) + (im[2] + im[3]);
+    float s0 = (e0[0] + e0[1]) + (e0[2] + e0[3]);
+    float s1 = (e1[0] + e1[1]) + (e1[2] + e1[3]);
+    for (; k < n; k++) {
+        float ar = a[2 * k], ai = a[2 * k + 1];
+        float br = b[2 * k], bi = b[2 * k + 1];
+        sr += ar * br + ai * bi;
+        si += ai * br - ar * bi;
+        s0 += ar * ar + ai * ai;
+        s1 += br * br + bi * bi;
+    }
+    corr[0] = sr;
+    corr[1] = si;
+    energy[0] = s0;
+    energy[1] = s1;
+}
+
+float nru_autocorr_coeff_fc32(const float *iq, size_t n_samples, size_t lag) {
+    if (!iq || lag == 0 || n_samples <= lag) return 0.0f;
+    float corr[2], energy[2];
+    nru_autocorr_fc32(iq, n_samples, lag, corr, energy);
+    float den = sqrtf(energy[0] * energy[1]);
+    return den > 0.0f ? sqrtf(corr[0] * corr[0] + corr[1] * corr[1]) / den : 0.0f;
+}
+
+} // extern "C"
@@ -0,0 +1,151 @@
+/*
+ * NR-U DSP Kernels Header
+ * -----------------------
+ * Sample-reduction kernels shared by the runtime energy detector and the
+ * offline trace tools, so both measure power exactly the same way.
+ *
+ * Location: common/utils/nru_dsp.h
+ */
+
+#ifndef NRU_DSP_H
+#define NRU_DSP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  BLOCK POWER
+ * ============================================ */
+
+/**
+ * Mean power of consecutive sample blocks (interleaved int16 I/Q)
+ * Power is normalized to full scale (|x| = 32768 -> 1.0).
+ * @param iq: Interleaved I/Q, 2 * n_samples values
+ * @param n_samples: Number of complex samples
+ * @param block_len: Complex samples per block
+ * @param out: n_samples / block_len block powers (trailing partial block dropped)
+ * @return: Number of blocks written
+ */
+size_t nru_block_power_sc16(const int16_t *iq, size_t n_samples, size_t block_len, float *out);
+
+/**
+ * Mean power of consecutive sample blocks (interleaved float I/Q)
+ * Same contract as nru_block_power_sc16()
+ */
+size_t nru_block_power_fc32(const float *iq, size_t n_samples, size_t block_len, float *out);
+
+/**
+ * Mean power of one span of interleaved float I/Q
+ */
+float nru_mean_power_fc32(const float *iq, size_t n_samples);
+
+/**
+ * Whether block kernels have a fixed-length instance for block_len
+ * (the ~1 us block of 15.36 / 23.04 / 30.72 / 46.08 / 61.44 / 92.16 / 122.88 Msps)
+ * @return: 1 specialized, 0 generic loop
+ */
+int nru_dsp_block_len_specialized(size_t block_len);
+
+/* ============================================
+ *  INGEST CONDITIONING
+ * ============================================ */
+
+/**
+ * Conditioning state for one RX stream
+ * Correction (set by the caller):
+ *   x = raw - dc
+ *   I' = gain_i * x_I
+ *   Q' = cross_q * x_I + gain_q * x_Q     (gain and IQ balance)
+ * The DC estimate follows the mean of each block with dc_alpha; moments and
+ * clip counts accumulate until the caller clears them.
+ */
+typedef struct {
+    float gain_i;
+    float gain_q;
+    float cross_q;
+    float dc_alpha;        // DC tracking per block_len samples (0 = fixed)
+    float clip_level;      // Raw |I| or |Q| at or above this (full scale 1.0) clips, 0 = off
+    float dc[2];           // Running DC estimate {I, Q}
+    double sum_ii;         // Second moments of x (DC removed, before correction)
+    double sum_qq;
+    double sum_iq;
+    uint64_t n_moments;
+    uint64_t clipped;      // Clipped I or Q values
+} nru_cond_t;
+
+/**
+ * Identity correction, zero DC, tracking off, clip check off
+ */
+void nru_cond_init(nru_cond_t *c);
+
+/**
+ * Condition interleaved float I/Q in one pass
+ * Removes DC, applies the correction, counts clips and emits the mean power
+ * of each block of the corrected output.
+ * @param out: 2 * n_samples corrected values (may alias in)
+ * @param block_power: n_samples / block_len block powers, or NULL
+ * @param track: Update DC, moments and clip count (0 = apply the correction only)
+ * @return: Number of full blocks
+ */
+size_t nru_condition_fc32(nru_cond_t *c, const float *in, size_t n_samples, size_t block_len,
+                          float *out, float *block_power, int track);
+
+/**
+ * Same as nru_condition_fc32(), from interleaved int16 (|x| = 32768 -> 1.0)
+ */
+size_t nru_condition_sc16(nru_cond_t *c, const int16_t *in, size_t n_samples, size_t block_len,
+                          float *out, float *block_power, int track);
+
+/* ============================================
+ *  CORRELATION
+ * ============================================ */
+
+/**
+ * Lag autocorrelation of interleaved float I/Q
+ * Sums x[k] * conj(x[k + lag]) for k in [0, n_samples - lag), plus the
+ * energies of both spans, so the caller can form a normalized coefficient.
+ * @param corr: Out, complex sum as {re, im}
+ * @param energy: Out, {sum |x[k]|^2, sum |x[k + lag]|^2}
+ */
+void nru_autocorr_fc32(const float *iq, size_t n_samples, size_t lag,
+                       float corr[2], float energy[2]);
+
+/**
+ * Normalized lag autocorrelation |R(lag)| / sqrt(E0 * E1), 0 if undefined
+ */
+float nru_autocorr_coeff_fc32(const float *iq, size_t n_samples, size_t lag);
+
+/* ============================================
+ *  FILTERING
+ * ============================================ */
+
+/**
+ * Decimating real-tap FIR over interleaved float I/Q
+ * Output k is the dot product of taps2 with the 2 * n_taps values ending
+ * at input sample first + k * decim, so the caller prepends n_taps - 1
+ * samples of history.
+ * @param taps2: Taps time-reversed and duplicated (h[N-1], h[N-1], ..., h[0], h[0]);
+ *               n_taps a multiple of 4 (zero-pad)
+ * @param first: Input index of the newest sample of output 0 (>= n_taps - 1)
+ * @return: Number of outputs written
+ */
+size_t nru_fir_decim_fc32(const float *iq, size_t n_samples, const float *taps2, size_t n_taps,
+                          size_t decim, size_t first, float *out);
+
+/**
+ * Linear power to dB (floored at -120 dB)
+ */
+static inline float nru_power_to_db(float p) {
+    return 10.0f * log10f(p > 1e-12f ? p : 1e-12f);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_DSP_H */
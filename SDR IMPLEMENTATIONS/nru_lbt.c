@@ -14,9 +14,28 @@
 #include <unistd.h>
 #include <string.h>
 #include <stddef.h>  
-#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/stat.h>
+
+#ifdef NRU_LBT_STANDALONE
+// Standalone build (nru_coexsim): decision logic only, no OAI MAC/PHY
+#include "nru_lbt.h"
+#include "nru_clock.h"
+#include "nru_stability.h"
+#include "nru_airtime.h"
+#include "nru_coord.h"
+#define LOG_E(c, ...) fprintf(stderr, __VA_ARGS__)
+#define LOG_W(c, ...) fprintf(stderr, __VA_ARGS__)
+#define LOG_I(c, ...) do { } while (0)
+#define LOG_D(c, ...) do { } while (0)
+#else
 #include "common/utils/nru_lbt.h"
+#include "common/utils/nru_clock.h"
+#include "common/utils/nru_stability.h"
+#include "common/utils/nru_airtime.h"
+#include "common/utils/nru_coord.h"
 #include "NR_MAC_gNB/mac_proto.h"
 #include "openair1/SCHED_NR/fapi_nr_l1.h"
 #include "openair2/NR_PHY_INTERFACE/NR_IF_Module.h"
@@ -26,6 +45,7 @@
 extern NR_IF_Module_t NR_IF_Module[];
 #define NR_IF_Module_get(i) (&NR_IF_Module[i])
 ;
+#endif
 
 // ---------------------------------------------------------------------
 // External UHD helper hooks (from nru_uhd_helper.cpp)
@@ -35,14 +55,25 @@ extern "C" {
 #endif
 void  nru_attach_usrp(void *priv);
 void  nru_calibrate_noise_floor(int samples);
+void  nru_start_noise_calibration(int max_measurements);
 float nru_get_current_energy_dbm(void);
 void  nru_set_ed_threshold(float threshold_dbm);
+float nru_get_ed_threshold(void);
 void  nru_stop_rx_stream(void);
 void  nru_restart_rx_stream(void);
 void  nru_cleanup(void);
+int   nru_lbt_check_timed(int sensing_time_us);
+void  nru_set_cca_sequential(bool enabled, float false_free, float false_busy, int min_us);
+void  nru_set_ed_bandwidth(double bw_hz, double offset_hz);
+void  nru_set_ingest_conditioning(bool dc_removal, bool iq_balance, bool clip_check, float margin_db);
+void  nru_set_spectrum_monitor(int fft_size, int n_avg, double frame_rate_hz);
+void  nru_note_tx_grant(uint64_t grant_us);
+uint32_t nru_get_rf_turnaround_us(void);
+bool  nru_own_tx_masked(void);
 extern float noise_floor_dbm;
 extern float nru_config_ed_threshold_dbm;
 
+#ifndef NRU_LBT_STANDALONE
 int nr_is_prach_slot(int module_idP, int frame, int slot);  // used in scheduler
 
 // ---------------------------------------------------------------------
@@ -91,41 +122,132 @@ int nr_is_prach_slot(int module_idP, int frame, int slot) {
     
     return 0;  // Not a PRACH slot
 }
+#endif
 
 #ifdef __cplusplus
 }
 #endif
 void gNB_trigger_tx_window(void);
+static void nru_log_csv(float energy, float threshold, bool free, const char *mode, uint64_t cot_us);
+static void csv_writer_start(void);
 // ---------------------------------------------------------------------
 // Global State
 // ---------------------------------------------------------------------
-static nru_cfg_t nru_cfg_global;
-static nru_fbe_cfg_t fbe_cfg_global;
-static bool nru_initialized = false;
+static NRU_TLS nru_cfg_t nru_cfg_global;
+static NRU_TLS nru_fbe_cfg_t fbe_cfg_global;
+static NRU_TLS bool nru_initialized = false;
+
+// LBE Cat-4 backoff RNG (window fixed at cw_min, no adaptation)
+#define NRU_LBE_SLOT_US 9
+#define NRU_LBE_DEFAULT_CW 15
+static NRU_TLS unsigned int lbe_rand_state = 1;
+
+// Type 2A (one-shot) sensing for discovery bursts
+#define NRU_TYPE2A_US 25
+#define NRU_DRS_DEFAULT_PERIOD_MS   20
+#define NRU_DRS_DEFAULT_DURATION_MS 5
+#define NRU_DRS_COT_US              1000   // Discovery burst after Type 2A (max 1 ms)
+
+// Blind RX/TX switch guards, only used while usrp_lib does not publish
+// TX bursts (nru_observe_tx_burst), i.e. nothing masks our own leakage
+#define NRU_FALLBACK_TX_SWITCH_US   1000   // After stopping RX for a grant
+#define NRU_FALLBACK_TX_SETTLE_US   2000   // After TX, before sensing again
+
+// LBT outcomes of the slot being scheduled (-1 = not sensed yet)
+typedef struct {
+    int frame;
+    int slot;
+    int cat4;
+    int type2a;
+} nru_slot_lbt_t;
+static NRU_TLS nru_slot_lbt_t slot_lbt = { -1, -1, -1, -1 };
+
+// DRS window whose COT we hold (-1 = none); valid while cot_active()
+static NRU_TLS long drs_held_window = -1;
+
+// Guard deadlines of the current COT (nru_clock us, radio time). Written
+// by the scheduler, read by the TX gate on the radio thread.
+static NRU_TLS atomic_ullong guard_tx_from_us;
+static NRU_TLS atomic_ullong guard_cot_end_us;
+
+// COTs are opened by the scheduler and by the async worker
+// (nru_lbt_async.cpp). Duty grants (the airtime reader side), coordination
+// claims and our published COT are single-caller state: every grant,
+// claim, COT change and release happens under this lock.
+static NRU_TLS pthread_mutex_t cot_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Airtime accounting windows (caps off unless duty_cap_percent is set)
+#define NRU_DUTY_DEFAULT_WINDOW_MS 1000
 
 // global gNB pointer (linked by MAC init)
 void *global_gNB_ptr = NULL;
 
 // ---------------------------------------------------------------------
-// Time utility
+// Time utility (single NR-U clock domain, see nru_clock.c)
 // ---------------------------------------------------------------------
 uint64_t nru_time_now_us(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+    return nru_clock_now_us();
 }
 
 // ---------------------------------------------------------------------
 // Initialization
 // ---------------------------------------------------------------------
+// Our air time is always tracked; duty_cap_percent caps every window
+static void configure_airtime(const nru_cfg_t *cfg) {
+    const double cap = (cfg->duty_cap_percent > 0.0) ? cfg->duty_cap_percent / 100.0 : 0.0;
+    nru_airtime_cfg_t air;
+    memset(&air, 0, sizeof(air));
+    air.horizon_ms[0] = (uint32_t)(cfg->duty_window_ms > 0 ? cfg->duty_window_ms
+                                                          : NRU_DUTY_DEFAULT_WINDOW_MS);
+    air.max_duty[0] = cap;
+    if (cfg->duty_window_long_ms > 0) {
+        air.horizon_ms[1] = (uint32_t)cfg->duty_window_long_ms;
+        air.max_duty[1] = cap;
+    }
+    nru_airtime_configure(&air);
+}
+
+// Join the co-located group when coord_mode is set, leave it otherwise
+static void configure_coord(const nru_cfg_t *cfg) {
+    if (cfg->coord_mode <= NRU_COORD_OFF || cfg->coord_mode > NRU_COORD_STAGGER) {
+        nru_coord_detach();
+        return;
+    }
+    const nru_coord_cfg_t cc = {
+        .mode = (nru_coord_mode_t)cfg->coord_mode,
+        .operator_id = (uint32_t)cfg->coord_operator_id,
+        .cell_id = cfg->coord_cell_id,
+    };
+    const char *shm = cfg->coord_shm[0] ? cfg->coord_shm : NRU_COORD_SHM_NAME;
+    int idx = nru_coord_attach(shm, &cc);
+    if (idx < 0)
+        LOG_E(MAC, "[NRU][COORD] Cannot join %s, coordination off\n", shm);
+    else
+        LOG_I(MAC, "[NRU][COORD] Member %d of %s (%s, operator %d)\n",
+              idx, shm, cc.mode == NRU_COORD_ALIGN ? "align" : "stagger", cfg->coord_operator_id);
+}
+
+static bool coord_changed(const nru_cfg_t *a, const nru_cfg_t *b) {
+    return a->coord_mode != b->coord_mode || a->coord_operator_id != b->coord_operator_id ||
+           a->coord_cell_id != b->coord_cell_id || strcmp(a->coord_shm, b->coord_shm) != 0;
+}
+
 int nru_lbt_init(const nru_cfg_t *cfg) {
     if (!cfg) {
         LOG_E(MAC, "[NRU] NULL configuration\n");
         return -1;
     }
 
+    nru_clock_init();
     nru_cfg_global = *cfg;
     nru_set_ed_threshold((float)cfg->ed_threshold_dbm);
+    nru_set_cca_sequential(cfg->cca_sequential, (float)cfg->cca_false_free,
+                           (float)cfg->cca_false_busy, cfg->cca_min_us);
+    nru_set_ed_bandwidth((cfg->ed_bandwidth_mhz ? cfg->ed_bandwidth_mhz : 20) * 1e6,
+                         cfg->ed_offset_mhz * 1e6);
+    nru_set_ingest_conditioning(cfg->rx_dc_removal, cfg->rx_iq_balance, cfg->rx_clip_check,
+                                (float)cfg->ed_margin_db);
+    nru_set_spectrum_monitor(cfg->spectrum_fft_size, cfg->spectrum_avg, cfg->spectrum_rate_hz);
 
     if (strcmp(cfg->mode, "FBE") == 0) {
         fbe_cfg_global.T_frame_us = cfg->frame_period_ms * 1000;
@@ -134,43 +256,117 @@ int nru_lbt_init(const nru_cfg_t *cfg) {
         fbe_cfg_global.gnb_id = 0;
         fbe_cfg_global.log_level = 1;
         fbe_cfg_global.start_time_us = nru_time_now_us();
-        printf("[NRU][FBE] %.2f ms frame | %.2f ms TX window | duty %.1f%%\n",
+        LOG_I(MAC, "[NRU][FBE] %.2f ms frame | %.2f ms TX window | duty %.1f%%\n",
                fbe_cfg_global.T_frame_us/1000.0,
                fbe_cfg_global.T_on_us/1000.0,
                fbe_cfg_global.duty.max_duty*100.0);
     }
 
-    nru_calibrate_noise_floor(400);
+    nru_stability_cfg_t stab = {
+        .horizon_ms = (uint32_t)(cfg->stab_horizon_ms > 0 ? cfg->stab_horizon_ms : 0),
+        .min_idle_us = (uint32_t)(cfg->stab_min_idle_us > 0 ? cfg->stab_min_idle_us : 0),
+        .max_busy_per_s = cfg->stab_max_busy_per_s,
+        .max_busy_fraction = cfg->stab_max_busy_fraction,
+    };
+    nru_stability_configure(&stab);
+    configure_airtime(cfg);
+    configure_coord(cfg);
+    if (cfg->log_lbt)
+        csv_writer_start();
+
+    // Calibrate in the background; the configured threshold applies meanwhile
+    nru_start_noise_calibration(400);
     nru_initialized = true;
     return 0;
 }
 
+void nru_lbt_set_seed(unsigned int seed) {
+    lbe_rand_state = seed ? seed : 1;
+}
+
 // ---------------------------------------------------------------------
-// TX Trigger Integration (for NR-U coexistence)
+// Guard deadlines
 // ---------------------------------------------------------------------
+// A grant opens a COT that starts one measured RF turnaround later.
+// Nothing waits for it: the TX gate drops blocks outside the window.
+static void set_cot(uint64_t from_us, uint64_t end_us) {
+    atomic_store_explicit(&guard_tx_from_us, from_us, memory_order_relaxed);
+    atomic_store_explicit(&guard_cot_end_us, end_us, memory_order_release);
+    nru_coord_publish_cot(from_us, end_us);
+}
 
+static void open_cot(uint64_t grant_us, uint64_t cot_us) {
+    nru_note_tx_grant(grant_us);
+    uint64_t from = grant_us + nru_get_rf_turnaround_us();
+    set_cot(from, from + cot_us);
+}
+
+static bool cot_active(uint64_t now_us) {
+    return now_us < atomic_load_explicit(&guard_cot_end_us, memory_order_acquire);
+}
+
+// Position in the FBE frame; the frame phase comes from the co-located
+// group when coordination is on (0 = aligned to the clock epoch)
+static uint64_t fbe_offset(uint64_t now_us) {
+    const uint64_t frame = fbe_cfg_global.T_frame_us;
+    const uint64_t phase = nru_coord_fbe_offset_us(now_us, frame, fbe_cfg_global.T_on_us, 0);
+    return (now_us + frame - phase) % frame;
+}
+
+void nru_lbt_get_guard(uint64_t *tx_from_us, uint64_t *cot_end_us) {
+    if (cot_end_us)
+        *cot_end_us = atomic_load_explicit(&guard_cot_end_us, memory_order_acquire);
+    if (tx_from_us)
+        *tx_from_us = atomic_load_explicit(&guard_tx_from_us, memory_order_relaxed);
+}
+
+// Duty-window grant for a COT of up to cot_us (cot_lock held)
+static uint64_t grant_locked(uint64_t now_us, uint64_t cot_us) {
+    uint64_t committed;
+    nru_lbt_get_guard(NULL, &committed);
+    return nru_airtime_grant_us(now_us, committed, cot_us);
+}
 
+uint64_t nru_lbt_open_cot(uint64_t grant_us, uint64_t cot_us) {
+    pthread_mutex_lock(&cot_lock);
+    uint64_t cot = grant_locked(grant_us, cot_us);
+    if (cot > 0 && !nru_coord_claim(grant_us, grant_us + nru_get_rf_turnaround_us() + cot))
+        cot = 0;
+    if (cot > 0)
+        open_cot(grant_us, cot);
+    pthread_mutex_unlock(&cot_lock);
+    return cot;
+}
 
-static int consecutive_free = 0;
-static const int FREE_TRIGGER_THRESHOLD = 3; // require 3 consecutive FREE detections
+int nru_lbt_tx_gate(int64_t device_ns) {
+    if (!nru_initialized || !nru_cfg_global.enabled)
+        return 1;
+    uint64_t t_us = nru_clock_device_to_host_ns(device_ns) / 1000ULL;
+    uint64_t from, end;
+    nru_lbt_get_guard(&from, &end);
+    return (t_us >= from && t_us < end) ? 1 : 0;
+}
 
+// ---------------------------------------------------------------------
+// TX Trigger Integration (for NR-U coexistence)
+// ---------------------------------------------------------------------
+
+
+
+// Trigger on a time-based idle run (nru_stability), not a count of calls
 void nru_lbt_try_trigger_tx(void) {
     if (!nru_initialized || !global_gNB_ptr)
         return;
 
     float energy = nru_get_current_energy_dbm();
-    float threshold = (float)nru_cfg_global.ed_threshold_dbm;
-    bool free = (energy < threshold);
-
-    if (free)
-        consecutive_free++;
-    else
-        consecutive_free = 0;
+    float threshold = nru_get_ed_threshold();
+    uint64_t now = nru_time_now_us();
+    nru_stability_observe(energy >= threshold, now);
 
-   if (consecutive_free >= FREE_TRIGGER_THRESHOLD) {
-    consecutive_free = 0;
+   if (nru_stability_ue_access_ok(now)) {
     nru_stop_rx_stream();
-    usleep(1000);
+    if (!nru_own_tx_masked())
+        nru_clock_sleep_us(NRU_FALLBACK_TX_SWITCH_US);
 
     LOG_I(MAC, "[NRU][LBT] 🚀 Channel FREE — calling gNB_trigger_tx_window()\n");
     gNB_trigger_tx_window();
@@ -190,25 +386,87 @@ int nru_lbt_sense_and_acquire(int gnb_id, int required_us) {
     // === FBE Mode ===
     if (strcmp(nru_cfg_global.mode, "FBE") == 0) {
         uint64_t now = nru_time_now_us();
-        uint64_t off = now % fbe_cfg_global.T_frame_us;
+        pthread_mutex_lock(&cot_lock);
+        uint64_t off = fbe_offset(now);
         bool tx_ok = (off < fbe_cfg_global.T_on_us);
 
+        if (tx_ok && !cot_active(now)) {
+            // Guard covers the fixed window in radio time (no turnaround:
+            // the frame grid is absolute), cut short where the duty
+            // windows run out
+            const uint64_t window_end = now - off + fbe_cfg_global.T_on_us;
+            uint64_t grant = grant_locked(now, window_end - now);
+            if (grant > 0) {
+                nru_note_tx_grant(now);
+                set_cot(now - off, now + grant < window_end ? now + grant : window_end);
+            } else {
+                tx_ok = false;
+            }
+        }
+        pthread_mutex_unlock(&cot_lock);
         if (tx_ok) {
             nru_stop_rx_stream();
-            usleep(500); // guard
         } else {
             nru_restart_rx_stream();
         }
 
-        if (nru_cfg_global.log_lbt)
+        if (nru_cfg_global.log_lbt) {
             LOG_I(MAC, "[NRU][FBE] offset=%.2fms TX=%s\n", off/1000.0, tx_ok?"":"");
+            uint64_t end;
+            nru_lbt_get_guard(NULL, &end);
+            nru_log_csv(nru_get_current_energy_dbm(), nru_get_ed_threshold(),
+                        tx_ok, "FBE", (tx_ok && end > now) ? end - now : 0);
+        }
         return tx_ok;
     }
 
     // === LBE Mode ===
+    // No contention while a duty window is at its cap
+    const uint64_t mcot_us = (uint64_t)nru_cfg_global.mcot_ms * 1000ULL;
+    const uint64_t start = nru_time_now_us();
+    pthread_mutex_lock(&cot_lock);
+    const uint64_t grant = grant_locked(start, mcot_us);
+    bool my_turn = grant > 0 && nru_coord_my_turn(start);
+    pthread_mutex_unlock(&cot_lock);
+    if (grant == 0) {
+        if (nru_cfg_global.log_lbt)
+            LOG_I(MAC, "[NRU][LBE] Duty cap reached, no access\n");
+        return 0;
+    }
+
+    // Co-located peers are not foreign energy: wait out a staggered
+    // peer's COT in sensing steps (as for a busy channel, not a backoff),
+    // or join an aligned peer's COT without contention
+    const int max_retries = (nru_cfg_global.mcot_ms * 1000 / nru_cfg_global.ed_sensing_time_us);
+    for (int waits = 0; !my_turn && waits < max_retries; waits++) {
+        nru_clock_sleep_us(nru_cfg_global.ed_sensing_time_us);
+        pthread_mutex_lock(&cot_lock);
+        my_turn = nru_coord_my_turn(nru_time_now_us());
+        pthread_mutex_unlock(&cot_lock);
+    }
+    if (!my_turn) {
+        if (nru_cfg_global.log_lbt)
+            LOG_I(MAC, "[NRU][COORD] Peer's turn, deferring\n");
+        return 0;
+    }
+    if (nru_coord_mode() == NRU_COORD_ALIGN) {
+        const uint64_t peer_end = nru_coord_peer_cot_end(start);
+        const uint64_t from = start + nru_get_rf_turnaround_us();
+        if (peer_end > from) {
+            const uint64_t cot = nru_lbt_open_cot(start, peer_end - from);
+            if (cot == 0)
+                return 0;
+            if (nru_cfg_global.log_lbt)
+                LOG_I(MAC, "[NRU][COORD] Joining peer COT for %.2f ms\n", cot / 1000.0);
+            nru_stop_rx_stream();
+            return 1;
+        }
+    }
+
     float energy = nru_get_current_energy_dbm();
-    float threshold = (float)nru_cfg_global.ed_threshold_dbm;
+    float threshold = nru_get_ed_threshold();
     bool free = (energy < threshold);
+    nru_stability_observe(!free, nru_time_now_us());
 
     if (nru_cfg_global.log_lbt) {
         LOG_I(MAC, "[NRU][LBE] Energy %.2f dBm | Thresh %.2f | %s\n",
@@ -218,28 +476,182 @@ int nru_lbt_sense_and_acquire(int gnb_id, int required_us) {
     // Try to trigger TX when channel is repeatedly free
    // nru_lbt_try_trigger_tx();
 
+    // Busy: defer in sensing steps. Free: count down the Cat-4 random
+    // backoff in 9 us observation slots, freezing while the channel is busy.
     int retries = 0;
-    const int max_retries = (nru_cfg_global.mcot_ms * 1000 / nru_cfg_global.ed_sensing_time_us);
-    while (!free && retries < max_retries) {
-        usleep(nru_cfg_global.ed_sensing_time_us);
+    const int cw = (nru_cfg_global.cw_min > 0) ? nru_cfg_global.cw_min : NRU_LBE_DEFAULT_CW;
+    int backoff = rand_r(&lbe_rand_state) % (cw + 1);
+    while (retries < max_retries && !(free && backoff == 0)) {
+        if (!free) {
+            nru_clock_sleep_us(nru_cfg_global.ed_sensing_time_us);
+            retries++;
+        } else {
+            nru_clock_sleep_us(NRU_LBE_SLOT_US);
+            backoff--;
+        }
         energy = nru_get_current_energy_dbm();
         free = (energy < threshold);
-        retries++;
+        nru_stability_observe(!free, nru_time_now_us());
+    }
+
+    bool acquired = free || retries >= max_retries;
+
+    // Granted again at the decision: the windows moved during the backoff,
+    // and a staggered peer may have taken the channel meanwhile
+    const uint64_t now = nru_time_now_us();
+    uint64_t cot = 0;
+    if (acquired) {
+        cot = nru_lbt_open_cot(now, mcot_us);
+        if (cot == 0) {
+            acquired = false;
+            if (nru_cfg_global.log_lbt)
+                LOG_I(MAC, "[NRU][LBE] Duty cap or co-located peer refused the COT\n");
+        }
     }
+    if (nru_cfg_global.log_lbt)
+        nru_log_csv(energy, threshold, acquired, "LBE", cot);
 
-    if (free || retries >= max_retries) {
+    if (acquired) {
         nru_stop_rx_stream();
-        usleep(1000);
+        if (!nru_own_tx_masked())
+            nru_clock_sleep_us(NRU_FALLBACK_TX_SWITCH_US);
         return 1;
     }
     return 0;
 }
 
+// ---------------------------------------------------------------------
+// Per-slot outcome cache and discovery burst window
+// ---------------------------------------------------------------------
+static nru_slot_lbt_t *slot_entry(int frame, int slot) {
+    if (slot_lbt.frame != frame || slot_lbt.slot != slot) {
+        slot_lbt.frame = frame;
+        slot_lbt.slot = slot;
+        slot_lbt.cat4 = -1;
+        slot_lbt.type2a = -1;
+    }
+    return &slot_lbt;
+}
+
+int nru_lbt_slot_acquire(int gnb_id, int frame, int slot, int required_us) {
+    nru_slot_lbt_t *e = slot_entry(frame, slot);
+    if (e->cat4 < 0)
+        e->cat4 = nru_lbt_sense_and_acquire(gnb_id, required_us);
+    return e->cat4;
+}
+
+// Absolute millisecond of the slot start (wraps with the SFN every 10.24 s)
+static long drs_slot_ms(int frame, int slot, int slots_per_frame) {
+    return (long)frame * 10 + (long)slot * 10 / slots_per_frame;
+}
+
+static int drs_period_ms(void) {
+    return nru_cfg_global.drs_period_ms > 0 ? nru_cfg_global.drs_period_ms
+                                            : NRU_DRS_DEFAULT_PERIOD_MS;
+}
+
+bool nru_drs_in_window(int frame, int slot, int slots_per_frame) {
+    if (slots_per_frame <= 0)
+        return false;
+    const int duration = nru_cfg_global.drs_duration_ms > 0 ? nru_cfg_global.drs_duration_ms
+                                                            : NRU_DRS_DEFAULT_DURATION_MS;
+    long pos = drs_slot_ms(frame, slot, slots_per_frame) % drs_period_ms();
+    return pos >= nru_cfg_global.drs_offset_ms &&
+           pos < nru_cfg_global.drs_offset_ms + duration;
+}
+
+int nru_drs_acquire(int gnb_id, int frame, int slot, int slots_per_frame) {
+    if (!nru_initialized || !nru_cfg_global.enabled)
+        return 1;
+    if (!nru_drs_in_window(frame, slot, slots_per_frame)) {
+        drs_held_window = -1;
+        return 0;
+    }
+
+    // FBE transmits only inside its fixed window, discovery bursts included
+    if (strcmp(nru_cfg_global.mode, "FBE") == 0)
+        return nru_lbt_slot_acquire(gnb_id, frame, slot, 0);
+
+    // A won window only covers the COT it was won with; later SSB slots of
+    // the window take a fresh Type 2A once that COT has ended
+    const long window = drs_slot_ms(frame, slot, slots_per_frame) / drs_period_ms();
+    if (window == drs_held_window && cot_active(nru_time_now_us()))
+        return 1;
+
+    nru_slot_lbt_t *e = slot_entry(frame, slot);
+    if (e->cat4 == 1) {
+        // Cat-4 already won this slot; the burst rides on that COT
+        drs_held_window = window;
+        return 1;
+    }
+    if (e->type2a < 0) {
+        e->type2a = (nru_lbt_check_timed(NRU_TYPE2A_US) == 1);
+        nru_stability_observe(!e->type2a, nru_time_now_us());
+        if (nru_cfg_global.log_lbt) {
+            LOG_I(MAC, "[NRU][DRS] %d.%d Type 2A %s\n", frame, slot,
+                  e->type2a ? "FREE" : "BUSY");
+            nru_log_csv(nru_get_current_energy_dbm(), nru_get_ed_threshold(),
+                        e->type2a, "DRS", e->type2a ? NRU_DRS_COT_US : 0);
+        }
+    }
+    if (!e->type2a)
+        return 0;
+
+    // The burst's COT is subject to the duty caps and co-located claims
+    uint64_t now = nru_time_now_us();
+    if (!cot_active(now) && nru_lbt_open_cot(now, NRU_DRS_COT_US) == 0) {
+        if (nru_cfg_global.log_lbt)
+            LOG_I(MAC, "[NRU][DRS] %d.%d COT refused (duty cap or co-located peer)\n", frame, slot);
+        return 0;
+    }
+    drs_held_window = window;
+    return 1;
+}
+
+// ---------------------------------------------------------------------
+// Channel stability (UE access gating, see nru_stability.c)
+// ---------------------------------------------------------------------
+int nru_lbt_is_stable_for_ue_access(void) {
+    if (!nru_initialized || !nru_cfg_global.enabled)
+        return 1;
+    // FBE only observes once per frame; its fixed windows are the gate
+    if (strcmp(nru_cfg_global.mode, "FBE") == 0)
+        return 1;
+    return nru_stability_ue_access_ok(nru_time_now_us()) ? 1 : 0;
+}
+
+int nru_lbt_get_consecutive_free(void) {
+    uint64_t idle_us = nru_stability_idle_run_us(nru_time_now_us());
+    return idle_us > (uint64_t)INT32_MAX ? INT32_MAX : (int)idle_us;
+}
+
+bool nru_lbt_is_channel_stable(void) {
+    if (!nru_initialized || !nru_cfg_global.enabled)
+        return true;
+    return nru_stability_channel_stable();
+}
+
+void nru_lbt_reset_stability(void) {
+    nru_stability_reset();
+}
+
 // ---------------------------------------------------------------------
 // TX lifecycle (called from scheduler)
 // ---------------------------------------------------------------------
+// No blind settling wait once the RX ingest masks our published TX bursts
+// plus the measured settling tail; until then keep the fixed guard.
 void nru_lbt_on_tx_complete(void) {
-    usleep(2000);
+    // Our burst is over: close the COT so the gate stops TX from here on
+    uint64_t now = nru_time_now_us();
+    pthread_mutex_lock(&cot_lock);
+    if (cot_active(now)) {
+        atomic_store_explicit(&guard_cot_end_us, now, memory_order_release);
+        nru_coord_publish_cot(atomic_load_explicit(&guard_tx_from_us, memory_order_relaxed), now);
+        nru_coord_release(now);
+    }
+    pthread_mutex_unlock(&cot_lock);
+    if (!nru_own_tx_masked())
+        nru_clock_sleep_us(NRU_FALLBACK_TX_SETTLE_US);
     nru_restart_rx_stream();
     if (nru_cfg_global.log_lbt)
         LOG_I(MAC, "[NRU] TX complete → RX resumed\n");
@@ -248,19 +660,113 @@ void nru_lbt_on_tx_complete(void) {
 // ---------------------------------------------------------------------
 // CSV Logging
 // ---------------------------------------------------------------------
-static void nru_log_csv(float energy, float threshold, bool free, const char *mode) {
-    static FILE *f = NULL;
-    if (!f) {
-        mkdir("/tmp/nru_logs", 0777);
-        f = fopen("/tmp/nru_logs/lbt_log.csv", "w");
-        if (f)
-            fprintf(f, "timestamp_us,energy_dbm,threshold_dbm,status,mode\n");
+// One row per LBT outcome (log_lbt), read by nru_timeline. FREE rows carry
+// the COT they opened. The scheduler thread only copies the row into a
+// single-producer ring; a writer thread formats it and flushes the file
+// every NRU_CSV_FLUSH_US, so no stdio work runs under NR_SCHED_LOCK.
+#define NRU_CSV_RING       4096     // Rows in flight (~2 s of 0.5 ms slots)
+#define NRU_CSV_FLUSH_US   100000
+
+typedef struct {
+    uint64_t t_us;
+    float energy;
+    float threshold;
+    bool free;
+    const char *mode;                  // String literal
+    uint64_t cot_us;
+} nru_csv_row_t;
+
+static nru_csv_row_t csv_ring[NRU_CSV_RING];
+static atomic_uint csv_head;           // Written by the scheduler
+static atomic_uint csv_tail;           // Written by the writer
+static atomic_ullong csv_dropped;
+static atomic_bool csv_started;
+static atomic_bool csv_running;
+static pthread_t csv_thread;
+static FILE *csv_file;
+
+static void csv_drain(void) {
+    unsigned int tail = atomic_load_explicit(&csv_tail, memory_order_relaxed);
+    const unsigned int head = atomic_load_explicit(&csv_head, memory_order_acquire);
+    for (; tail != head; tail++) {
+        const nru_csv_row_t *r = &csv_ring[tail % NRU_CSV_RING];
+        fprintf(csv_file, "%llu,%.2f,%.2f,%s,%s,%llu\n",
+                (unsigned long long)r->t_us, r->energy, r->threshold,
+                r->free ? "FREE" : "BUSY", r->mode, (unsigned long long)r->cot_us);
+    }
+    atomic_store_explicit(&csv_tail, tail, memory_order_release);
+    fflush(csv_file);
+}
+
+static void *csv_writer_main(void *arg) {
+    (void)arg;
+    while (atomic_load_explicit(&csv_running, memory_order_acquire)) {
+        csv_drain();
+        usleep(NRU_CSV_FLUSH_US);    // Wall time, also under a simulated clock
+    }
+    csv_drain();
+    return NULL;
+}
+
+static void csv_writer_stop(void) {
+    if (!atomic_exchange(&csv_started, false))
+        return;
+    atomic_store_explicit(&csv_running, false, memory_order_release);
+    pthread_join(csv_thread, NULL);
+    unsigned long long dropped = atomic_load(&csv_dropped);
+    if (dropped)
+        LOG_W(MAC, "[NRU][LBT] CSV log dropped %llu rows\n", dropped);
+}
+
+static void csv_writer_start(void) {
+    if (atomic_exchange(&csv_started, true))
+        return;
+    mkdir("/tmp/nru_logs", 0777);
+    csv_file = fopen("/tmp/nru_logs/lbt_log.csv", "w");
+    if (!csv_file) {
+        LOG_E(MAC, "[NRU][LBT] Cannot open /tmp/nru_logs/lbt_log.csv\n");
+        atomic_store(&csv_started, false);
+        return;
+    }
+    fprintf(csv_file, "timestamp_us,energy_dbm,threshold_dbm,status,mode,cot_us\n");
+
+    // Explicit SCHED_OTHER: the scheduler thread that calls nru_lbt_init()
+    // may be real-time
+    pthread_attr_t attr;
+    struct sched_param param = { .sched_priority = 0 };
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+    atomic_store(&csv_running, true);
+    if (pthread_create(&csv_thread, &attr, csv_writer_main, NULL) != 0) {
+        LOG_E(MAC, "[NRU][LBT] Failed to start CSV writer thread\n");
+        atomic_store(&csv_running, false);
+        atomic_store(&csv_started, false);
+        fclose(csv_file);
+        csv_file = NULL;
+    } else {
+        atexit(csv_writer_stop);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+static void nru_log_csv(float energy, float threshold, bool free, const char *mode, uint64_t cot_us) {
+    if (!atomic_load_explicit(&csv_running, memory_order_relaxed))
+        return;
+    const unsigned int head = atomic_load_explicit(&csv_head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&csv_tail, memory_order_acquire) >= NRU_CSV_RING) {
+        atomic_fetch_add_explicit(&csv_dropped, 1, memory_order_relaxed);
+        return;
     }
-    if (!f) return;
-    fprintf(f, "%llu,%.2f,%.2f,%s,%s\n",
-            (unsigned long long)nru_time_now_us(), energy, threshold,
-            free?"FREE":"BUSY", mode);
-    fflush(f);
+    nru_csv_row_t *r = &csv_ring[head % NRU_CSV_RING];
+    r->t_us = nru_time_now_us();
+    r->energy = energy;
+    r->threshold = threshold;
+    r->free = free;
+    r->mode = mode;
+    r->cot_us = cot_us;
+    atomic_store_explicit(&csv_head, head + 1, memory_order_release);
 }
 
 // ---------------------------------------------------------------------
@@ -269,7 +775,7 @@ static void nru_log_csv(float energy, float threshold, bool free, const char *mo
 void nru_fbe_heartbeat(void) {
     if (strcmp(nru_cfg_global.mode, "FBE") != 0) return;
     uint64_t now = nru_time_now_us();
-    bool tx_allowed = ((now % fbe_cfg_global.T_frame_us) < fbe_cfg_global.T_on_us);
+    bool tx_allowed = (fbe_offset(now) < fbe_cfg_global.T_on_us);
     if (tx_allowed) nru_stop_rx_stream(); else nru_restart_rx_stream();
 }
 
@@ -280,7 +786,11 @@ const nru_cfg_t* nru_get_cfg(void) { return &nru_cfg_global; }
 
 int nru_lbt_update_cfg(const nru_cfg_t *cfg) {
     if (!cfg) return -1;
+    const bool rejoin = coord_changed(&nru_cfg_global, cfg);
     nru_cfg_global = *cfg;
+    configure_airtime(cfg);
+    if (rejoin)
+        configure_coord(cfg);
     return 0;
 }
 
@@ -291,7 +801,7 @@ int nru_lbt_process_usrp_samples(void *samples, int len) {
     if (!samples || len <= 0) return -1;
 
     float energy = nru_get_current_energy_dbm();
-    float threshold = (float)nru_cfg_global.ed_threshold_dbm;
+    float threshold = nru_get_ed_threshold();
     bool free = (energy < threshold);
 
     if (nru_cfg_global.log_lbt) {
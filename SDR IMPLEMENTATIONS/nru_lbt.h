@@ -60,6 +60,9 @@ typedef struct {
     int frame_period_ms;               // Frame period (milliseconds)
     int tx_window_ms;                  // TX window size (milliseconds)
     double duty_cycle_percent;         // Duty cycle percentage
+    double duty_cap_percent;           // Measured airtime cap, LBE and FBE (0 = track only)
+    int duty_window_ms;                // Sliding window of the cap (0 = 1000)
+    int duty_window_long_ms;           // Optional second window (0 = none)
     nru_fbe_cfg_t fbe_cfg;            // FBE-specific configuration
     
     // Load-Based Equipment (LBE) Parameters
@@ -67,7 +70,45 @@ typedef struct {
     int defer_period_us;               // Defer period before sensing (μs)
     int backoff_slots;                 // Number of backoff slots
     int cw_min;                        // Contention window minimum
-    int cw_max;                        // Contention window maximum
+    int cw_max;                        // Unused: backoff is drawn from [0, cw_min]
+
+    // Discovery Burst (DRS) Window - SSB/SIB1 candidates
+    int drs_period_ms;                 // Window period (match SSB periodicity, 0 = 20)
+    int drs_offset_ms;                 // Window start within the period
+    int drs_duration_ms;               // Window length (0 = 5, ETSI max)
+
+    // Sequential CCA (early-terminating, see nru_set_cca_sequential)
+    bool cca_sequential;               // Enable the SPRT decision
+    double cca_false_free;             // Target P(FREE | signal at threshold), 0 = 1e-3
+    double cca_false_busy;             // Target P(BUSY | 2 dB below threshold), 0 = 1e-2
+    int cca_min_us;                    // Minimum evidence before FREE (0 = 9)
+
+    // ED channelizer (see nru_set_ed_bandwidth)
+    int ed_bandwidth_mhz;              // LBT channel bandwidth (0 = 20, < 0 = whole capture)
+    double ed_offset_mhz;              // Channel centre relative to the RX centre
+
+    // Ingest conditioning (see nru_set_ingest_conditioning)
+    bool rx_dc_removal;                // Track and remove the RX DC offset
+    bool rx_iq_balance;                // Blind IQ gain/phase correction
+    bool rx_clip_check;                // Count ADC clipping
+    double ed_margin_db;               // ED threshold above the calibrated floor (0 = 8)
+
+    // Live spectrum monitor (see nru_set_spectrum_monitor)
+    int spectrum_fft_size;             // PSD bins (0 = off)
+    int spectrum_avg;                  // FFTs averaged per frame (0 = every sample)
+    double spectrum_rate_hz;           // Frames per second (0 = 10)
+
+    // Co-located gNB coordination (see nru_coord.h)
+    int coord_mode;                    // 0 = off, 1 = align, 2 = stagger
+    int coord_operator_id;             // Only cells with the same id coordinate
+    int coord_cell_id;                 // Shown to peers and tools
+    char coord_shm[32];                // Shared-memory name ("" = /nru_coord)
+
+    // Channel stability (UE access gating, 0 = nru_stability.h defaults)
+    int stab_horizon_ms;               // Sliding horizon for busy statistics
+    int stab_min_idle_us;              // Idle run required before PRACH / UE access
+    double stab_max_busy_per_s;        // Max busy runs per second
+    double stab_max_busy_fraction;     // Max busy time fraction
     
     // Logging
     bool log_lbt;                      // Enable LBT event logging
@@ -96,17 +137,96 @@ int nru_lbt_init(const nru_cfg_t *cfg);
  * @return: 1 if channel acquired, 0 if busy
  */
 int nru_lbt_sense_and_acquire(int gnb_id, int required_us);
-// === ADD THESE NEW DECLARATIONS ===
-// Channel stability checking (for UE access control)
+
+/**
+ * Seed the LBE random backoff generator (reproducible simulation runs)
+ */
+void nru_lbt_set_seed(unsigned int seed);
+
+/**
+ * Per-slot channel access (cached)
+ * Runs nru_lbt_sense_and_acquire() at most once per (frame, slot);
+ * later calls in the same slot return the cached outcome.
+ * @return: 1 if channel acquired, 0 if busy
+ */
+int nru_lbt_slot_acquire(int gnb_id, int frame, int slot, int required_us);
+
+/**
+ * Is (frame, slot) inside the configured discovery burst window?
+ */
+bool nru_drs_in_window(int frame, int slot, int slots_per_frame);
+
+/**
+ * Gate SSB/SIB1 scheduling for one slot
+ * Outside the DRS window: 0. Inside: one Type 2A (25 us) LBT per slot; a
+ * clear result is held for later slots of the window only while its COT
+ * (at most 1 ms) runs, after which the next slot senses again. A slot that
+ * already acquired the channel with Cat-4 is not sensed again. The COT
+ * goes through nru_lbt_open_cot(), so duty caps and co-located claims can
+ * still refuse it. In FBE the burst is only sent inside the fixed window.
+ * @return: 1 if SSB/SIB1 may be scheduled in this slot (always 1 when LBT is disabled)
+ */
+int nru_drs_acquire(int gnb_id, int frame, int slot, int slots_per_frame);
+
+/* ============================================
+ *  CHANNEL STABILITY (nru_stability.c)
+ * ============================================ */
+
+/**
+ * Gate PRACH / UE access on channel stability
+ * @return: 1 if the horizon statistics are within limits and the channel
+ *          has been idle for at least stab_min_idle_us; 1 when LBT is
+ *          disabled, in FBE mode, or while history is too short to judge
+ */
 int nru_lbt_is_stable_for_ue_access(void);
+
+/**
+ * @return: Length of the current idle run in microseconds (0 while busy)
+ */
 int nru_lbt_get_consecutive_free(void);
+
+/**
+ * @return: true if busy-run rate and busy fraction over the horizon are within limits
+ */
 bool nru_lbt_is_channel_stable(void);
+
+/**
+ * Clear the stability statistics
+ */
 void nru_lbt_reset_stability(void);
+
 /**
  * Called after transmission completes
+ * Returns at once when self-interference is masked at ingest
+ * (nru_observe_tx_burst); without that hook it waits a fixed 2 ms guard
  */
 void nru_lbt_on_tx_complete(void);
 
+/**
+ * Guard deadlines of the current COT (nru_clock us, radio time)
+ * A grant opens [tx_from, cot_end): TX may start one measured RF
+ * turnaround after the grant (LBE) or the FBE window start and must end
+ * by the MCOT / window end. Nothing sleeps on these; callers compare.
+ */
+void nru_lbt_get_guard(uint64_t *tx_from_us, uint64_t *cot_end_us);
+
+/**
+ * Open a COT for a grant decided outside nru_lbt.c (nru_lbt_async.cpp),
+ * subject to the same duty caps and co-located claims as the LBE path
+ * @param grant_us: nru_clock time of the grant
+ * @param cot_us: Channel occupancy time wanted
+ * @return: COT opened in microseconds (shortened by the duty windows),
+ *          0 if the duty cap or a co-located peer refused it
+ */
+uint64_t nru_lbt_open_cot(uint64_t grant_us, uint64_t cot_us);
+
+/**
+ * TX gate for one block, called from trx_usrp_write()
+ * @param device_ns: Device time of the block's first sample
+ * @return: 1 if the block lies inside the current COT (always 1 when LBT is disabled)
+ */
+int nru_lbt_tx_gate(int64_t device_ns);
+
 /**
  * FBE heartbeat (periodic call for duty cycle management)
  */
@@ -133,7 +253,7 @@ int nru_update_ed_threshold(float new_threshold_dbm);
 int nru_lbt_process_usrp_samples(void *samples, int len);
 
 /**
- * Get current time in microseconds
+ * Get current time in microseconds (nru_clock time base)
  */
 uint64_t nru_time_now_us(void);
 
@@ -169,6 +289,52 @@ void nru_feed_samples(const void *samples, size_t count);
  */
 void nru_feed_samples_int16(const int16_t *samples, size_t count);
 
+/**
+ * Update the USRP device-time mapping from an RX timestamp
+ * Called from trx_usrp_read() after receiving samples
+ * @param sample_ts: Device time of the first sample (in samples)
+ * @param count: Number of samples received
+ */
+void nru_observe_rx_timestamp(uint64_t sample_ts, size_t count);
+
+/**
+ * Publish one transmitted block for own-TX masking
+ * Called from trx_usrp_write() with the block's TX timestamp. Ingest drops
+ * RX samples that overlap our bursts plus a settling tail, so sensing is
+ * not blinded by TX leakage.
+ * @param sample_ts: Device time of the first sample (in samples)
+ * @param count: Number of samples written
+ */
+void nru_observe_tx_burst(uint64_t sample_ts, size_t count);
+
+/**
+ * Record an LBT grant (start of the RX-to-TX turnaround measurement)
+ * @param grant_us: nru_clock time of the grant
+ */
+void nru_note_tx_grant(uint64_t grant_us);
+
+/**
+ * @return: Measured grant-to-air RF turnaround (μs), used as guard length
+ */
+uint32_t nru_get_rf_turnaround_us(void);
+
+/**
+ * Override the post-TX settling tail
+ * @param settle_us: Fixed tail in microseconds, 0 = measured (default)
+ */
+void nru_set_tx_settling_us(uint32_t settle_us);
+
+/**
+ * @return: Settling tail currently applied after each burst (μs)
+ */
+uint32_t nru_get_tx_settling_us(void);
+
+/**
+ * @return: true once usrp_lib has published a TX burst, i.e. ingest masks
+ *          our own TX; until then nru_lbt.c keeps fixed RX/TX switch guards
+ */
+bool nru_own_tx_masked(void);
+
 /**
  * Get current energy level
  * @return: Energy in dBm (uses cached value if recent)
@@ -188,6 +354,50 @@ float nru_get_current_energy_dbm_no_cache(void);
  */
 int nru_lbt_check_timed(int sensing_time_us);
 
+/**
+ * Configure the sequential (SPRT) CCA used by nru_lbt_check_timed()
+ * Decides as soon as the block-power evidence crosses the error bounds;
+ * FREE needs at least min_us, and the sensing time stays the maximum.
+ * @param enabled: false = fixed-window CCA
+ * @param false_free: Target probability of FREE for a signal at the threshold
+ * @param false_busy: Target probability of BUSY 2 dB below the threshold
+ * @param min_us: Minimum observation before FREE
+ */
+void nru_set_cca_sequential(bool enabled, float false_free, float false_busy, int min_us);
+
+/**
+ * Restrict energy detection to the LBT channel (nru_channelizer.h)
+ * The filter is designed from the live RX rate; a capture that is not
+ * wider than the channel is used as is.
+ * @param bw_hz: Channel bandwidth, <= 0 to measure the whole capture
+ * @param offset_hz: Channel centre relative to the RX centre frequency
+ */
+void nru_set_ed_bandwidth(double bw_hz, double offset_hz);
+
+/**
+ * Configure the ingest conditioning pass (nru_condition_fc32/sc16)
+ * Every RX batch is DC-corrected and IQ-balanced before classification,
+ * channelization and energy detection; the noise floor measured after it
+ * is lower and steadier, which is what the ED margin is added to.
+ * @param dc_removal: Track the DC offset (10 ms running mean) and subtract it
+ * @param iq_balance: Estimate and correct IQ gain/phase imbalance
+ * @param clip_check: Count samples at ADC full scale (nru_print_stats)
+ * @param margin_db: ED threshold = noise floor + margin (<= 0 = 8 dB)
+ */
+void nru_set_ingest_conditioning(bool dc_removal, bool iq_balance, bool clip_check, float margin_db);
+
+/**
+ * Configure the live spectrum monitor (nru_spectrum.h)
+ * Averaged PSD frames of the sensing stream are published to the shared
+ * memory ring /dev/shm/nru_spectrum for nru_spectrum_view or any local
+ * viewer. Runs on its own thread while a USRP is attached.
+ * @param fft_size: Bins per frame (power of two, 64-8192), 0 = off
+ * @param n_avg: FFTs per frame from the newest samples, 0 = all samples
+ *               since the previous frame (CPU grows with the RX rate)
+ * @param frame_rate_hz: Frames per second (<= 0 = 10)
+ */
+void nru_set_spectrum_monitor(int fft_size, int n_avg, double frame_rate_hz);
+
 /**
  * Standard FBE LBT check (25μs sensing)
  * @return: 1 if FREE, 0 if BUSY
@@ -217,10 +427,23 @@ int nru_lbt_extended_cca(int defer_duration_us, int max_attempts);
 /**
  * Calibrate noise floor
  * Should be called with no signal present
- * @param samples: Number of measurements to average
+ * @param samples: Maximum number of measurements (stops early once converged)
  */
 void nru_calibrate_noise_floor(int samples);
 
+/**
+ * Calibrate the noise floor on the sensing worker (non-blocking)
+ * Stops as soon as the estimate's 95% confidence interval is tight; the
+ * new noise floor and ED threshold are then swapped in atomically.
+ * @param max_measurements: Upper bound on energy readings
+ */
+void nru_start_noise_calibration(int max_measurements);
+
+/**
+ * @return: true while a background calibration is running
+ */
+bool nru_calibration_in_progress(void);
+
 /**
  * Set manual calibration offset
  * @param offset_db: Offset in dB (dBm = dBFS + offset)
@@ -235,12 +458,13 @@ void nru_auto_calibrate_offset(float known_power_dbm);
 
 /**
  * Set energy detection threshold
+ * Also the ceiling for the noise-floor-derived threshold from calibration.
  * @param threshold_dbm: Threshold in dBm
  */
 void nru_set_ed_threshold(float threshold_dbm);
 
 /**
- * Get current ED threshold
+ * Get current ED threshold (calibrated once the noise floor is known)
  * @return: Threshold in dBm
  */
 float nru_get_ed_threshold(void);
@@ -284,6 +508,13 @@ size_t nru_get_buffer_size(void);
  */
 void nru_clear_buffer(void);
 
+/**
+ * Sensing sample ring (nru_sample_ring.h), for detectors that need the
+ * conditioned RX stream; each registers its own reader
+ * @return: NULL before the USRP is attached or samples are fed
+ */
+struct nru_sample_ring *nru_get_sample_ring(void);
+
 /**
  * Print USRP information
  */
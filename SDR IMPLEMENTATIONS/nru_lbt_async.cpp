@@ -0,0 +1,286 @@
+/*
+ * NR-U Asynchronous LBT (C++20 coroutines)
+ * ----------------------------------------
+ * Sensing worker behind nru::acquire(). Procedures follow TS 37.213:
+ *   - Type 1 (Cat-4): idle for Td = 16 + m_p * 9 us, then count down a
+ *     backoff drawn from [0, CW_p] in 9 us idle slots. A busy slot freezes
+ *     the counter; the countdown resumes after another idle Td.
+ *   - Type 2A: 25 us continuously idle.
+ * The backoff is drawn from CW_min,p of the request's direction and
+ * priority class. As in the blocking LBE path (nru_lbt.c) the window is
+ * not adapted: sensing a busy channel is no evidence of a collision.
+ *
+ * Build (C++20, outside the OAI tree):
+ *   g++ -O2 -std=c++20 -DNRU_LBT_STANDALONE -c nru_lbt_async.cpp
+ *
+ * Location: common/utils/nru_lbt_async.cpp
+ */
+
+#include <algorithm>
+#ifdef NRU_LBT_STANDALONE
+#include "nru_lbt_async.hpp"
+#include "nru_lbt.h"
+#include "nru_clock.h"
+#else
+#include "common/utils/nru_lbt_async.hpp"
+#include "common/utils/nru_lbt.h"
+#include "common/utils/nru_clock.h"
+#endif
+
+namespace nru {
+
+/* ============================================
+ *  CHANNEL ACCESS PRIORITY CLASSES
+ * ============================================ */
+
+#define NRU_ASYNC_SLOT_US   9
+#define NRU_ASYNC_TYPE2A_US 25
+
+struct cap_params {
+    int m_p;
+    int cw_min;
+    int cw_max;
+    int mcot_ms;
+};
+
+// TS 37.213 Table 4.1.1-1 (DL) and Table 4.2.1-1 (UL)
+static const cap_params CAP_TABLE[2][4] = {
+    { { 1, 3, 7, 2 }, { 1, 7, 15, 3 }, { 3, 15, 63, 8 }, { 7, 15, 1023, 8 } },
+    { { 2, 3, 7, 2 }, { 2, 7, 15, 4 }, { 3, 15, 1023, 6 }, { 7, 15, 1023, 6 } },
+};
+
+static const cap_params &cap_of(const acquire_request &req) {
+    const int p = std::clamp(req.priority_class, 1, 4) - 1;
+    return CAP_TABLE[req.dir == link_dir::ul ? 1 : 0][p];
+}
+
+// Channel 0: the USRP energy detector (nru_uhd_helper.cpp)
+static float usrp_energy(void *, float *threshold_dbm) {
+    *threshold_dbm = nru_get_ed_threshold();
+    return nru_get_current_energy_dbm();
+}
+
+/* ============================================
+ *  AWAITER
+ * ============================================ */
+
+bool acquire_awaiter::await_ready() {
+    const nru_cfg_t *cfg = nru_get_cfg();
+    if (!cfg || !cfg->enabled) {
+        result_.status = acquire_status::acquired;
+        result_.granted_us = nru_time_now_us();
+        result_.mcot_us = static_cast<uint64_t>(cap_of(req_).mcot_ms) * 1000ULL;
+        return true;
+    }
+    std::lock_guard<std::mutex> lk(worker_->mtx_);
+    if (!worker_->find_channel(req_.channel)) {
+        result_.status = acquire_status::no_channel;
+        return true;
+    }
+    return false;
+}
+
+void acquire_awaiter::await_suspend(std::coroutine_handle<> h) {
+    handle_ = h;
+    defer_us_ = (req_.type == access_type::type2a)
+                    ? NRU_ASYNC_TYPE2A_US
+                    : 16 + static_cast<uint64_t>(cap_of(req_).m_p) * NRU_ASYNC_SLOT_US;
+    // May resume on the worker before this returns: nothing after submit
+    worker_->submit(this);
+}
+
+/* ============================================
+ *  WORKER
+ * ============================================ */
+
+lbt_worker::lbt_worker() : rng_(1) {
+    register_channel(0, usrp_energy, nullptr, true);
+}
+
+lbt_worker::~lbt_worker() {
+    stop();
+}
+
+lbt_worker &lbt_worker::global() {
+    static lbt_worker worker;
+    return worker;
+}
+
+void lbt_worker::register_channel(int channel, energy_fn fn, void *ctx, bool cot_arms_gate) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    channel_t *ch = find_channel(channel);
+    if (!ch) {
+        channels_.push_back(channel_t{});
+        ch = &channels_.back();
+        ch->id = channel;
+    }
+    ch->fn = fn;
+    ch->ctx = ctx;
+    ch->arms_gate = cot_arms_gate;
+}
+
+lbt_worker::channel_t *lbt_worker::find_channel(int id) {
+    for (auto &ch : channels_)
+        if (ch.id == id)
+            return &ch;
+    return nullptr;
+}
+
+void lbt_worker::set_seed(unsigned int seed) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    rng_.seed(seed ? seed : 1);
+}
+
+size_t lbt_worker::pending() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return waiters_.size();
+}
+
+void lbt_worker::submit(acquire_awaiter *a) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        waiters_.push_back(a);
+    }
+    cv_.notify_one();
+}
+
+void lbt_worker::complete(acquire_awaiter *a, channel_t *ch, acquire_status st, uint64_t now_us) {
+    a->result_.status = st;
+    a->result_.granted_us = now_us;
+    if (st == acquire_status::acquired && ch) {
+        const cap_params &cap = cap_of(a->req_);
+        uint64_t mcot_us = static_cast<uint64_t>(cap.mcot_ms) * 1000ULL;
+        const nru_cfg_t *cfg = nru_get_cfg();
+        if (cfg && cfg->mcot_ms > 0)
+            mcot_us = std::min<uint64_t>(mcot_us, static_cast<uint64_t>(cfg->mcot_ms) * 1000ULL);
+        a->result_.mcot_us = mcot_us;
+
+        if (a->req_.type == access_type::cat4)
+            a->result_.cw = cap.cw_min;
+        if (ch->arms_gate) {
+            a->result_.mcot_us = nru_lbt_open_cot(now_us, mcot_us);
+            if (a->result_.mcot_us == 0)
+                a->result_.status = acquire_status::refused;
+        }
+    }
+    ready_.push_back(a);
+}
+
+// Advance one waiter by the observation at now_us; true when it completed
+bool lbt_worker::step(acquire_awaiter *a, channel_t &ch, bool busy, uint64_t now_us) {
+    // The previous observation is taken to hold until now
+    const uint64_t dt = a->last_us_ ? now_us - a->last_us_ : 0;
+    a->last_us_ = now_us;
+
+    if (busy) {
+        a->idle_us_ = 0;
+        a->credit_us_ = 0;
+        a->result_.busy_slots++;
+    } else {
+        a->idle_us_ += dt;
+        if (a->idle_us_ >= a->defer_us_) {
+            if (a->req_.type == access_type::type2a) {
+                complete(a, &ch, acquire_status::acquired, now_us);
+                return true;
+            }
+            if (a->backoff_ < 0) {
+                const int cw = cap_of(a->req_).cw_min;
+                a->backoff_ = static_cast<int>(rng_() % static_cast<unsigned>(cw + 1));
+            }
+            // Idle time beyond Td counts down the backoff in whole slots
+            a->credit_us_ += std::min(dt, a->idle_us_ - a->defer_us_);
+            while (a->backoff_ > 0 && a->credit_us_ >= NRU_ASYNC_SLOT_US) {
+                a->backoff_--;
+                a->credit_us_ -= NRU_ASYNC_SLOT_US;
+            }
+            if (a->backoff_ == 0) {
+                complete(a, &ch, acquire_status::acquired, now_us);
+                return true;
+            }
+        }
+    }
+
+    if (a->req_.deadline_us && now_us >= a->req_.deadline_us) {
+        complete(a, &ch, acquire_status::deadline, now_us);
+        return true;
+    }
+    return false;
+}
+
+int lbt_worker::poll(uint64_t now_us) {
+    std::vector<acquire_awaiter *> resume;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (waiters_.empty())
+            return 0;
+
+        // One energy read per channel with waiters
+        for (auto &ch : channels_) {
+            bool sensed = false, busy = false;
+            auto it = waiters_.begin();
+            while (it != waiters_.end()) {
+                if ((*it)->req_.channel != ch.id) {
+                    ++it;
+                    continue;
+                }
+                if (!sensed) {
+                    float threshold = 0.0f;
+                    const float energy = ch.fn(ch.ctx, &threshold);
+                    busy = (energy >= threshold);
+                    sensed = true;
+                }
+                it = step(*it, ch, busy, now_us) ? waiters_.erase(it) : it + 1;
+            }
+        }
+        resume.swap(ready_);
+    }
+
+    // Outside the lock: resumed coroutines may co_await again
+    for (acquire_awaiter *a : resume)
+        a->handle_.resume();
+    return static_cast<int>(resume.size());
+}
+
+void lbt_worker::cancel_all() {
+    std::vector<acquire_awaiter *> resume;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        const uint64_t now = nru_time_now_us();
+        for (acquire_awaiter *a : waiters_)
+            complete(a, nullptr, acquire_status::cancelled, now);
+        waiters_.clear();
+        resume.swap(ready_);
+    }
+    for (acquire_awaiter *a : resume)
+        a->handle_.resume();
+}
+
+void lbt_worker::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cv_.wait(lk, [this] {
+                return !waiters_.empty() || !running_.load(std::memory_order_relaxed);
+            });
+        }
+        poll(nru_time_now_us());
+        nru_clock_sleep_us(NRU_ASYNC_SLOT_US);
+    }
+}
+
+void lbt_worker::start() {
+    if (running_.exchange(true))
+        return;
+    thread_ = std::thread([this] { run(); });
+}
+
+void lbt_worker::stop() {
+    if (running_.exchange(false)) {
+        cv_.notify_all();
+        if (thread_.joinable())
+            thread_.join();
+    }
+    cancel_all();
+}
+
+} // namespace nru
@@ -0,0 +1,235 @@
+/*
+ * NR-U Asynchronous LBT (C++20 coroutines)
+ * ----------------------------------------
+ * Awaitable channel access on top of the energy detector:
+ *
+ *     nru::acquire_result r = co_await nru::acquire(0, 3, deadline_us);
+ *     if (r.status == nru::acquire_status::acquired) ...
+ *
+ * One sensing worker multiplexes every outstanding request (carriers, DL
+ * and UL, DRS). Each 9 us observation slot it reads the energy of each
+ * channel that has waiters once, steps every waiter's Cat-4 or Type 2A
+ * procedure and resumes the coroutines whose procedure completed or whose
+ * deadline passed. The blocking calls in nru_lbt.h are unchanged.
+ *
+ * Coroutines resume on the worker thread (or inside poll()); they must
+ * hand long work to another thread before the next co_await.
+ *
+ * Location: common/utils/nru_lbt_async.hpp
+ */
+
+#ifndef NRU_LBT_ASYNC_HPP
+#define NRU_LBT_ASYNC_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace nru {
+
+/* ============================================
+ *  TYPES
+ * ============================================ */
+
+enum class link_dir { dl, ul };
+
+enum class access_type {
+    cat4,                              // Type 1: defer + random backoff (priority class 1..4)
+    type2a                             // 25 us one-shot (DRS, COT sharing)
+};
+
+enum class acquire_status {
+    acquired,
+    deadline,                          // Deadline passed before the procedure completed
+    cancelled,                         // Worker stopped or cancel_all()
+    no_channel,                        // Channel id not registered
+    refused                            // Won, but the duty cap or a co-located peer refused the COT
+};
+
+struct acquire_request {
+    int channel = 0;
+    access_type type = access_type::cat4;
+    int priority_class = 3;            // 1..4 (TS 37.213 Tables 4.1.1-1 / 4.2.1-1)
+    link_dir dir = link_dir::dl;
+    uint64_t deadline_us = 0;          // nru_clock time, 0 = none
+};
+
+struct acquire_result {
+    acquire_status status = acquire_status::cancelled;
+    uint64_t granted_us = 0;           // nru_clock time of the decision
+    uint64_t mcot_us = 0;              // COT allowed by the priority class (and duty cap)
+    int cw = 0;                        // Contention window used (Cat-4)
+    int busy_slots = 0;                // Observation slots found busy
+};
+
+/**
+ * Energy source of one channel
+ * @return: Energy in dBm; *threshold_dbm receives the ED threshold
+ */
+using energy_fn = float (*)(void *ctx, float *threshold_dbm);
+
+/* ============================================
+ *  SENSING WORKER
+ * ============================================ */
+
+class lbt_worker;
+
+/**
+ * Awaitable returned by lbt_worker::acquire()
+ * Lives in the awaiting coroutine's frame while the worker holds it.
+ */
+class acquire_awaiter {
+public:
+    acquire_awaiter(lbt_worker *w, const acquire_request &req) : worker_(w), req_(req) {}
+
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    acquire_result await_resume() const { return result_; }
+
+private:
+    friend class lbt_worker;
+
+    lbt_worker *worker_;
+    acquire_request req_;
+    acquire_result result_;
+    std::coroutine_handle<> handle_;
+
+    // Procedure state (worker only)
+    uint64_t last_us_ = 0;             // Previous observation, 0 = none yet
+    uint64_t idle_us_ = 0;             // Continuous idle time in the current defer
+    uint64_t defer_us_ = 0;            // Required defer (Td or 25 us)
+    int backoff_ = -1;                 // Remaining Cat-4 slots, -1 = not drawn
+    uint64_t credit_us_ = 0;           // Idle time after the defer not yet counted down
+};
+
+class lbt_worker {
+public:
+    lbt_worker();
+    ~lbt_worker();
+
+    lbt_worker(const lbt_worker &) = delete;
+    lbt_worker &operator=(const lbt_worker &) = delete;
+
+    /**
+     * Register an energy source (channel 0 is the USRP detector by default)
+     * @param cot_arms_gate: Grants on this channel arm the TX gate (nru_lbt_tx_gate)
+     */
+    void register_channel(int channel, energy_fn fn, void *ctx, bool cot_arms_gate = false);
+
+    /**
+     * Awaitable channel access
+     */
+    acquire_awaiter acquire(const acquire_request &req) { return acquire_awaiter(this, req); }
+
+    /**
+     * Run the sensing loop on a dedicated thread
+     */
+    void start();
+    void stop();
+
+    /**
+     * One observation slot at now_us, for callers that drive the worker
+     * themselves (simulation, or a thread that already ticks)
+     * @return: Number of coroutines resumed
+     */
+    int poll(uint64_t now_us);
+
+    /**
+     * Resume every waiter with acquire_status::cancelled
+     */
+    void cancel_all();
+
+    /**
+     * Seed the backoff generator (reproducible runs)
+     */
+    void set_seed(unsigned int seed);
+
+    size_t pending() const;
+
+    /**
+     * Process-wide worker used by nru::acquire()
+     * Starts nothing; the owner calls start() or poll().
+     */
+    static lbt_worker &global();
+
+private:
+    friend class acquire_awaiter;
+
+    struct channel_t {
+        int id;
+        energy_fn fn;
+        void *ctx;
+        bool arms_gate;
+    };
+
+    channel_t *find_channel(int id);
+    void submit(acquire_awaiter *a);
+    bool step(acquire_awaiter *a, channel_t &ch, bool busy, uint64_t now_us);
+    void complete(acquire_awaiter *a, channel_t *ch, acquire_status st, uint64_t now_us);
+    void run();
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<channel_t> channels_;
+    std::vector<acquire_awaiter *> waiters_;
+    std::vector<acquire_awaiter *> ready_;
+    std::minstd_rand rng_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+/**
+ * co_await nru::acquire(channel, priority_class, deadline_us) on the global worker
+ */
+inline acquire_awaiter acquire(int channel, int priority_class, uint64_t deadline_us,
+                               link_dir dir = link_dir::dl) {
+    acquire_request req;
+    req.channel = channel;
+    req.priority_class = priority_class;
+    req.dir = dir;
+    req.deadline_us = deadline_us;
+    return lbt_worker::global().acquire(req);
+}
+
+/**
+ * co_await nru::acquire_type2a(channel, deadline_us) (discovery bursts)
+ */
+inline acquire_awaiter acquire_type2a(int channel, uint64_t deadline_us) {
+    acquire_request req;
+    req.channel = channel;
+    req.type = access_type::type2a;
+    req.deadline_us = deadline_us;
+    return lbt_worker::global().acquire(req);
+}
+
+/* ============================================
+ *  TASK TYPE
+ * ============================================ */
+
+/**
+ * Fire-and-forget coroutine: starts at once, frees itself when done
+ *
+ *     nru::lbt_task dl_burst(int ch) {
+ *         auto r = co_await nru::acquire(ch, 3, deadline);
+ *         ...
+ *     }
+ */
+struct lbt_task {
+    struct promise_type {
+        lbt_task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace nru
+
+#endif /* NRU_LBT_ASYNC_HPP */
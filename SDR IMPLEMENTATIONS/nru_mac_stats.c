@@ -0,0 +1,239 @@
+/*
+ * NR-U MAC Statistics Offload
+ * ---------------------------
+ * Replaces the in-scheduler dump_mac_stats() call. The scheduler only
+ * copies counters into a slot of a single-producer/single-consumer ring;
+ * the formatter thread turns each slot into the usual per-UE log block.
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_mac_stats.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "common/utils/LOG/log.h"
+#include "NR_MAC_gNB/nru_mac_stats.h"
+#include "NR_MAC_gNB/nru_ue_rate.h"
+#include "NR_MAC_gNB/nru_sched_prof.h"
+
+// Snapshots in flight (one every 128 frames, so 4 is plenty)
+#define NRU_MAC_STATS_SLOTS     4
+// Formatter poll period (the RT side never signals)
+#define NRU_MAC_STATS_POLL_US   50000
+// Same budget the scheduler used to reserve on its stack
+#define NRU_MAC_STATS_TEXT_SIZE 32656
+
+typedef struct {
+    frame_t frame;
+    slot_t slot;
+    int n_ue;
+    nru_ue_stats_snap_t ue[MAX_MOBILES_PER_GNB];
+} nru_stats_batch_t;
+
+static nru_stats_batch_t stats_ring[NRU_MAC_STATS_SLOTS];
+static atomic_uint stats_head;       // written by the scheduler
+static atomic_uint stats_tail;       // written by the formatter
+static atomic_ullong stats_dropped;
+
+static atomic_bool formatter_started = false;
+static atomic_bool formatter_running = false;
+static pthread_t formatter_thread;
+static char stats_text[NRU_MAC_STATS_TEXT_SIZE];
+
+// ---------------------------------------------------------------------
+// Formatter (background thread)
+// ---------------------------------------------------------------------
+// Append to stats_text; false once it is full
+static bool append(size_t *len, const char *fmt, ...) {
+    if (*len >= sizeof(stats_text))
+        return false;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(stats_text + *len, sizeof(stats_text) - *len, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return false;
+    *len += (size_t)n;
+    return *len < sizeof(stats_text);
+}
+
+// Same lines as dump_mac_stats(), plus the NR-U rate window
+static void format_batch(const nru_stats_batch_t *b) {
+    size_t len = 0;
+    stats_text[0] = '\0';
+
+    for (int i = 0; i < b->n_ue; i++) {
+        const nru_ue_stats_snap_t *u = &b->ue[i];
+        int avg_rsrp = u->num_rsrp_meas > 0 ? (int)(u->cumul_rsrp / u->num_rsrp_meas) : 0;
+        if (!append(&len,
+                    "UE RNTI %04x CU-UE-ID %d %s PH %d dB PCMAX %d dBm, average RSRP %d (%d meas)\n"
+                    "UE %04x: dlsch_rounds %lu/%lu/%lu/%lu, dlsch_errors %lu, pucch0_DTX %d, BLER %.5f MCS (%d) %d\n"
+                    "UE %04x: ulsch_rounds %lu/%lu/%lu/%lu, ulsch_DTX %d, ulsch_errors %lu, BLER %.5f MCS (%d) %d NPRB %d SNR %d.%d dB\n"
+                    "UE %04x: PUCCH SNR %d.%d dB, raw RSSI %d\n"
+                    "UE %04x: MAC:    TX %14lu RX %14lu bytes, RBs DL %lu UL %lu, rate DL %.2f UL %.2f Mbit/s\n",
+                    u->rnti, u->uid, u->ul_failure ? "out-of-sync" : "in-sync",
+                    u->ph, u->pcmax, avg_rsrp, u->num_rsrp_meas,
+                    u->rnti,
+                    (unsigned long)u->dl_rounds[0], (unsigned long)u->dl_rounds[1],
+                    (unsigned long)u->dl_rounds[2], (unsigned long)u->dl_rounds[3],
+                    (unsigned long)u->dl_errors, u->pucch0_DTX, u->dl_bler, u->dl_mcs_table, u->dl_mcs,
+                    u->rnti,
+                    (unsigned long)u->ul_rounds[0], (unsigned long)u->ul_rounds[1],
+                    (unsigned long)u->ul_rounds[2], (unsigned long)u->ul_rounds[3],
+                    u->ulsch_DTX, (unsigned long)u->ul_errors, u->ul_bler, u->ul_mcs_table, u->ul_mcs,
+                    u->nprb, u->pusch_snrx10 / 10, abs(u->pusch_snrx10 % 10),
+                    u->rnti, u->pucch_snrx10 / 10, abs(u->pucch_snrx10 % 10), u->raw_rssi,
+                    u->rnti,
+                    (unsigned long)u->dl_total_bytes, (unsigned long)u->ul_total_bytes,
+                    (unsigned long)u->dl_total_rbs, (unsigned long)u->ul_total_rbs,
+                    u->dl_rate_mbps, u->ul_rate_mbps))
+            break;
+        for (int lc = 0; lc < NRU_MAC_STATS_LCIDS; lc++) {
+            if (u->dl_lc_bytes[lc] == 0 && u->ul_lc_bytes[lc] == 0)
+                continue;
+            if (!append(&len, "UE %04x: LCID %d: TX %14lu RX %14lu bytes\n", u->rnti, lc,
+                        (unsigned long)u->dl_lc_bytes[lc], (unsigned long)u->ul_lc_bytes[lc]))
+                break;
+        }
+    }
+
+    LOG_I(NR_MAC, "Frame.Slot %d.%d\n%s\n", b->frame, b->slot, stats_text);
+}
+
+static void drain_ring(void) {
+    unsigned int tail = atomic_load_explicit(&stats_tail, memory_order_relaxed);
+    while (tail != atomic_load_explicit(&stats_head, memory_order_acquire)) {
+        format_batch(&stats_ring[tail % NRU_MAC_STATS_SLOTS]);
+        nru_sched_prof_log_report();
+        tail++;
+        atomic_store_explicit(&stats_tail, tail, memory_order_release);
+    }
+}
+
+static void *formatter_main(void *arg) {
+    (void)arg;
+    while (atomic_load_explicit(&formatter_running, memory_order_acquire)) {
+        drain_ring();
+        usleep(NRU_MAC_STATS_POLL_US);
+    }
+    drain_ring();
+    return NULL;
+}
+
+// ---------------------------------------------------------------------
+// Lifecycle
+// ---------------------------------------------------------------------
+void nru_mac_stats_init(void) {
+    if (atomic_load_explicit(&formatter_started, memory_order_relaxed) ||
+        atomic_exchange(&formatter_started, true))
+        return;
+
+    // Explicit SCHED_OTHER: threads created from the RT scheduler would
+    // otherwise inherit its SCHED_FIFO policy
+    pthread_attr_t attr;
+    struct sched_param param = { .sched_priority = 0 };
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    pthread_attr_setschedparam(&attr, &param);
+
+    atomic_store(&formatter_running, true);
+    if (pthread_create(&formatter_thread, &attr, formatter_main, NULL) != 0) {
+        LOG_E(NR_MAC, "[NRU][STATS] Failed to start formatter thread\n");
+        atomic_store(&formatter_running, false);
+        atomic_store(&formatter_started, false);
+    } else {
+        atexit(nru_mac_stats_stop);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+// ---------------------------------------------------------------------
+// Capture (scheduler thread, NR_SCHED_LOCK held)
+// ---------------------------------------------------------------------
+void nru_mac_stats_capture(gNB_MAC_INST *gNB, frame_t frame, slot_t slot) {
+    // No formatter (not initialized or stopped): nothing would drain the ring
+    if (!atomic_load_explicit(&formatter_running, memory_order_acquire)) {
+        atomic_fetch_add_explicit(&stats_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    unsigned int head = atomic_load_explicit(&stats_head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&stats_tail, memory_order_acquire) >= NRU_MAC_STATS_SLOTS) {
+        atomic_fetch_add_explicit(&stats_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    nru_stats_batch_t *b = &stats_ring[head % NRU_MAC_STATS_SLOTS];
+    b->frame = frame;
+    b->slot = slot;
+    b->n_ue = 0;
+
+    UE_iterator(gNB->UE_info.connected_ue_list, UE) {
+        if (b->n_ue >= MAX_MOBILES_PER_GNB)
+            break;
+        NR_UE_sched_ctrl_t *sched_ctrl = &UE->UE_sched_ctrl;
+        NR_mac_stats_t *stats = &UE->mac_stats;
+        nru_ue_stats_snap_t *u = &b->ue[b->n_ue++];
+
+        u->rnti = UE->rnti;
+        u->uid = UE->uid;
+        u->ph = sched_ctrl->ph;
+        u->pcmax = sched_ctrl->pcmax;
+        u->raw_rssi = sched_ctrl->raw_rssi;
+        u->pusch_snrx10 = sched_ctrl->pusch_snrx10;
+        u->pucch_snrx10 = sched_ctrl->pucch_snrx10;
+        u->ul_failure = sched_ctrl->ul_failure;
+        u->cumul_rsrp = stats->cumul_rsrp;
+        u->num_rsrp_meas = stats->num_rsrp_meas;
+        u->pucch0_DTX = stats->pucch0_DTX;
+        u->ulsch_DTX = stats->ulsch_DTX;
+        for (int r = 0; r < 4; r++) {
+            u->dl_rounds[r] = stats->dl.rounds[r];
+            u->ul_rounds[r] = stats->ul.rounds[r];
+        }
+        u->dl_errors = stats->dl.errors;
+        u->dl_total_bytes = stats->dl.total_bytes;
+        u->dl_total_rbs = stats->dl.total_rbs;
+        u->ul_errors = stats->ul.errors;
+        u->ul_total_bytes = stats->ul.total_bytes;
+        u->ul_total_rbs = stats->ul.total_rbs;
+        u->nprb = stats->NPRB;
+        for (int lc = 0; lc < NRU_MAC_STATS_LCIDS; lc++) {
+            u->dl_lc_bytes[lc] = stats->dl.lc_bytes[lc];
+            u->ul_lc_bytes[lc] = stats->ul.lc_bytes[lc];
+        }
+        u->dl_bler = sched_ctrl->dl_bler_stats.bler;
+        u->dl_mcs = sched_ctrl->dl_bler_stats.mcs;
+        u->ul_bler = sched_ctrl->ul_bler_stats.bler;
+        u->ul_mcs = sched_ctrl->ul_bler_stats.mcs;
+        u->dl_mcs_table = UE->current_DL_BWP.mcsTableIdx;
+        u->ul_mcs_table = UE->current_UL_BWP.mcs_table;
+
+        nru_ue_rate_t rate;
+        bool have_rate = nru_ue_rate_get(UE->uid, UE->rnti, &rate) == 0;
+        u->dl_rate_mbps = have_rate ? (float)rate.dl_window_mbps : 0.0f;
+        u->ul_rate_mbps = have_rate ? (float)rate.ul_window_mbps : 0.0f;
+
+        // dump_mac_stats(..., reset_rsrp = true) semantics
+        stats->num_rsrp_meas = 0;
+        stats->cumul_rsrp = 0;
+    }
+
+    atomic_store_explicit(&stats_head, head + 1, memory_order_release);
+}
+
+void nru_mac_stats_stop(void) {
+    if (!atomic_exchange(&formatter_started, false))
+        return;
+    atomic_store_explicit(&formatter_running, false, memory_order_release);
+    pthread_join(formatter_thread, NULL);
+}
+
+uint64_t nru_mac_stats_dropped(void) {
+    return atomic_load_explicit(&stats_dropped, memory_order_relaxed);
+}
@@ -0,0 +1,100 @@
+/*
+ * NR-U MAC Statistics Offload Header
+ * ----------------------------------
+ * The scheduler copies raw per-UE counters into a preallocated snapshot
+ * while it holds NR_SCHED_LOCK. A background thread formats and logs the
+ * snapshot, so no string work runs on the slot path.
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_mac_stats.h
+ */
+
+#ifndef NRU_MAC_STATS_H
+#define NRU_MAC_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NR_MAC_gNB/nr_mac_gNB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  SNAPSHOT LAYOUT
+ * ============================================ */
+
+#define NRU_MAC_STATS_LCIDS 64          // Per-LCID byte counters copied
+
+/**
+ * Raw counters of one UE (no pointers, no strings)
+ */
+typedef struct {
+    rnti_t rnti;
+    int uid;
+    int ph;                            // Power headroom (dB)
+    int pcmax;                         // Max UE TX power (dBm)
+    bool ul_failure;                   // Printed as out-of-sync
+    int raw_rssi;
+    int pusch_snrx10;
+    int pucch_snrx10;
+    int64_t cumul_rsrp;
+    int num_rsrp_meas;
+    int pucch0_DTX;
+    int ulsch_DTX;
+    uint64_t dl_rounds[4];
+    uint64_t dl_errors;
+    uint64_t dl_total_bytes;
+    uint64_t dl_total_rbs;
+    uint64_t ul_rounds[4];
+    uint64_t ul_errors;
+    uint64_t ul_total_bytes;
+    uint64_t ul_total_rbs;
+    uint64_t dl_lc_bytes[NRU_MAC_STATS_LCIDS];
+    uint64_t ul_lc_bytes[NRU_MAC_STATS_LCIDS];
+    int nprb;                          // UL PRBs of the last grant
+    float dl_bler;
+    float ul_bler;
+    int dl_mcs;
+    int ul_mcs;
+    int dl_mcs_table;
+    int ul_mcs_table;
+    float dl_rate_mbps;                // Sliding-window rate (nru_ue_rate)
+    float ul_rate_mbps;
+} nru_ue_stats_snap_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Start the formatter thread (SCHED_OTHER, whatever the caller's policy)
+ * Call once at MAC start-up, outside NR_SCHED_LOCK; also registers
+ * nru_mac_stats_stop() with atexit(). Further calls do nothing.
+ */
+void nru_mac_stats_init(void);
+
+/**
+ * Capture one stats snapshot (call with NR_SCHED_LOCK held)
+ * Copies counters only and resets the RSRP accumulators like
+ * dump_mac_stats(..., true). Drops the snapshot if the formatter is
+ * still behind or not running.
+ * @param gNB: MAC instance
+ * @param frame, slot: Capture time, printed in the log header
+ */
+void nru_mac_stats_capture(gNB_MAC_INST *gNB, frame_t frame, slot_t slot);
+
+/**
+ * Flush pending snapshots and stop the formatter thread
+ */
+void nru_mac_stats_stop(void);
+
+/**
+ * @return: Snapshots dropped because the formatter was behind
+ */
+uint64_t nru_mac_stats_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_MAC_STATS_H */
@@ -0,0 +1,277 @@
+/*
+ * NR-U Broadcast Sample Ring
+ * --------------------------
+ * Stream index p lives at buf[p & mask]. The producer publishes two
+ * counters:
+ *   claim - end of the samples it is about to write (stored first)
+ *   head  - end of the samples written (stored last, release)
+ * A reader copies [s, e) with no lock, then reads claim: everything below
+ * claim - capacity may have been overwritten during the copy and is
+ * discarded. Both are position counters of nru_seqlock.h.
+ *
+ * Reader slots are fixed, each on its own cache line, so readers never
+ * touch shared state the producer writes to beyond the two counters.
+ *
+ * Location: common/utils/nru_sample_ring.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "common/utils/nru_sample_ring.h"
+#include "common/utils/nru_seqlock.h"
+
+#define READER_FREE     0
+#define READER_OPENING  1
+#define READER_OPEN     2
+#define READER_NAME_LEN 32
+
+struct alignas(64) nru_ring_reader {
+    std::atomic<int> state{READER_FREE};
+    std::atomic<uint64_t> cursor{0};
+    std::atomic<uint64_t> overrun{0};
+    char name[READER_NAME_LEN];
+};
+
+struct nru_sample_ring {
+    std::vector<float> buf;            // Interleaved I/Q, 2 * capacity
+    size_t capacity;
+    uint64_t mask;
+
+    alignas(64) uint64_t claim = 0;
+    uint64_t head = 0;
+
+    nru_ring_reader readers[NRU_RING_MAX_READERS];
+};
+
+// Copy stream samples [s, s + n) out of the ring (at most two pieces)
+static void copy_out(const nru_sample_ring *r, uint64_t s, size_t n, float *dst) {
+    const size_t i = static_cast<size_t>(s & r->mask);
+    const size_t n0 = std::min(n, r->capacity - i);
+    std::memcpy(dst, r->buf.data() + 2 * i, 2 * n0 * sizeof(float));
+    if (n > n0)
+        std::memcpy(dst + 2 * n0, r->buf.data(), 2 * (n - n0) * sizeof(float));
+}
+
+// Oldest stream index not yet overwritten (or being overwritten)
+static uint64_t oldest_valid(const nru_sample_ring *r) {
+    const uint64_t c = nru_seq64_read_end(&r->claim);
+    return (c > r->capacity) ? c - r->capacity : 0;
+}
+
+static nru_ring_reader *reader_slot(nru_sample_ring *r, int id) {
+    if (!r || id < 0 || id >= NRU_RING_MAX_READERS)
+        return nullptr;
+    nru_ring_reader *rd = &r->readers[id];
+    return (rd->state.load(std::memory_order_acquire) == READER_OPEN) ? rd : nullptr;
+}
+
+extern "C" {
+
+/* ============================================
+ *  RING
+ * ============================================ */
+
+nru_sample_ring_t *nru_ring_create(size_t min_samples) {
+    if (min_samples == 0)
+        return nullptr;
+    size_t cap = 1;
+    while (cap < min_samples)
+        cap <<= 1;
+
+    auto *r = new nru_sample_ring();
+    r->buf.assign(2 * cap, 0.0f);
+    r->capacity = cap;
+    r->mask = cap - 1;
+    return r;
+}
+
+void nru_ring_destroy(nru_sample_ring_t *r) {
+    delete r;
+}
+
+size_t nru_ring_capacity(const nru_sample_ring_t *r) {
+    return r ? r->capacity : 0;
+}
+
+uint64_t nru_ring_head(const nru_sample_ring_t *r) {
+    return r ? nru_seq64_read_begin(&r->head) : 0;
+}
+
+void nru_ring_write(nru_sample_ring_t *r, const float *iq, size_t n_samples) {
+    if (!r || !iq || n_samples == 0)
+        return;
+
+    const uint64_t h = r->head;                // Producer only
+    const uint64_t end = h + n_samples;
+
+    // A write longer than the ring keeps only its tail
+    size_t skip = 0;
+    if (n_samples > r->capacity) {
+        skip = n_samples - r->capacity;
+        iq += 2 * skip;
+    }
+
+    nru_seq64_write_mark(&r->claim, end);
+
+    const uint64_t s = h + skip;
+    const size_t n = n_samples - skip;
+    const size_t i = static_cast<size_t>(s & r->mask);
+    const size_t n0 = std::min(n, r->capacity - i);
+    std::memcpy(r->buf.data() + 2 * i, iq, 2 * n0 * sizeof(float));
+    if (n > n0)
+        std::memcpy(r->buf.data(), iq + 2 * n0, 2 * (n - n0) * sizeof(float));
+
+    nru_seq64_write_set(&r->head, end);
+}
+
+size_t nru_ring_read_from(const nru_sample_ring_t *r, uint64_t *seq, float *dst,
+                          size_t max_samples, uint64_t *lost) {
+    if (!r || !seq || !dst || max_samples == 0)
+        return 0;
+
+    const uint64_t h = nru_seq64_read_begin(&r->head);
+    uint64_t s = std::min(*seq, h);
+    uint64_t skipped = 0;
+    if (h - s > r->capacity) {
+        skipped = h - r->capacity - s;
+        s = h - r->capacity;
+    }
+
+    size_t n = static_cast<size_t>(std::min<uint64_t>(max_samples, h - s));
+    if (n > 0) {
+        copy_out(r, s, n, dst);
+
+        // Drop whatever the producer lapped while we copied
+        const uint64_t lo = oldest_valid(r);
+        if (s < lo) {
+            const size_t drop = static_cast<size_t>(std::min<uint64_t>(lo - s, n));
+            std::memmove(dst, dst + 2 * drop, 2 * (n - drop) * sizeof(float));
+            n -= drop;
+            s += drop;
+            skipped += drop;
+        }
+    }
+
+    *seq = s + n;
+    if (lost)
+        *lost += skipped;
+    return n;
+}
+
+size_t nru_ring_read_latest(const nru_sample_ring_t *r, float *dst, size_t n_samples,
+                            uint64_t *seq) {
+    if (!r || !dst)
+        return 0;
+    const uint64_t h = nru_seq64_read_begin(&r->head);
+    const size_t n = static_cast<size_t>(std::min<uint64_t>({n_samples, h, r->capacity}));
+    uint64_t s = h - n;
+    const uint64_t first = s;
+    uint64_t lost = 0;
+    const size_t got = nru_ring_read_from(r, &s, dst, n, &lost);
+    if (seq)
+        *seq = first + lost;
+    return got;
+}
+
+/* ============================================
+ *  READERS
+ * ============================================ */
+
+int nru_ring_reader_open(nru_sample_ring_t *r, size_t backlog, const char *name) {
+    if (!r)
+        return -1;
+    for (int id = 0; id < NRU_RING_MAX_READERS; id++) {
+        nru_ring_reader *rd = &r->readers[id];
+        int expected = READER_FREE;
+        if (!rd->state.compare_exchange_strong(expected, READER_OPENING))
+            continue;
+
+        const uint64_t h = nru_seq64_read_begin(&r->head);
+        rd->cursor.store(h - std::min<uint64_t>({backlog, h, r->capacity}),
+                         std::memory_order_relaxed);
+        rd->overrun.store(0, std::memory_order_relaxed);
+        std::snprintf(rd->name, sizeof(rd->name), "%s", name ? name : "reader");
+        rd->state.store(READER_OPEN, std::memory_order_release);
+        return id;
+    }
+    return -1;
+}
+
+void nru_ring_reader_close(nru_sample_ring_t *r, int id) {
+    nru_ring_reader *rd = reader_slot(r, id);
+    if (rd)
+        rd->state.store(READER_FREE, std::memory_order_release);
+}
+
+size_t nru_ring_read(nru_sample_ring_t *r, int id, float *dst, size_t max_samples) {
+    nru_ring_reader *rd = reader_slot(r, id);
+    if (!rd)
+        return 0;
+    uint64_t seq = rd->cursor.load(std::memory_order_relaxed);
+    uint64_t lost = 0;
+    const size_t n = nru_ring_read_from(r, &seq, dst, max_samples, &lost);
+    rd->cursor.store(seq, std::memory_order_relaxed);
+    if (lost)
+        rd->overrun.fetch_add(lost, std::memory_order_relaxed);
+    return n;
+}
+
+size_t nru_ring_peek(nru_sample_ring_t *r, int id, size_t max_samples, nru_ring_span_t *span) {
+    nru_ring_reader *rd = reader_slot(r, id);
+    if (!rd || !span)
+        return 0;
+
+    const uint64_t h = nru_seq64_read_begin(&r->head);
+    uint64_t s = std::min(rd->cursor.load(std::memory_order_relaxed), h);
+    if (h - s > r->capacity) {
+        rd->overrun.fetch_add(h - r->capacity - s, std::memory_order_relaxed);
+        s = h - r->capacity;
+        rd->cursor.store(s, std::memory_order_relaxed);
+    }
+
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(max_samples, h - s));
+    const size_t i = static_cast<size_t>(s & r->mask);
+    const size_t n0 = std::min(n, r->capacity - i);
+    span->iq[0] = r->buf.data() + 2 * i;
+    span->n[0] = n0;
+    span->iq[1] = r->buf.data();
+    span->n[1] = n - n0;
+    span->seq = s;
+    return n;
+}
+
+bool nru_ring_release(nru_sample_ring_t *r, int id, const nru_ring_span_t *span) {
+    nru_ring_reader *rd = reader_slot(r, id);
+    if (!rd || !span)
+        return false;
+
+    const uint64_t n = span->n[0] + span->n[1];
+    const uint64_t lo = oldest_valid(r);
+    const bool intact = span->seq >= lo;
+    if (!intact)
+        rd->overrun.fetch_add(std::min(lo - span->seq, n), std::memory_order_relaxed);
+    rd->cursor.store(span->seq + n, std::memory_order_relaxed);
+    return intact;
+}
+
+const char *nru_ring_reader_stats(const nru_sample_ring_t *r, int id, uint64_t *lag,
+                                  uint64_t *overrun) {
+    if (!r || id < 0 || id >= NRU_RING_MAX_READERS)
+        return nullptr;
+    const nru_ring_reader *rd = &r->readers[id];
+    if (rd->state.load(std::memory_order_acquire) != READER_OPEN)
+        return nullptr;
+
+    const uint64_t h = nru_seq64_read_begin(&r->head);
+    const uint64_t c = rd->cursor.load(std::memory_order_relaxed);
+    if (lag)
+        *lag = (h > c) ? h - c : 0;
+    if (overrun)
+        *overrun = rd->overrun.load(std::memory_order_relaxed);
+    return rd->name;
+}
+
+} // extern "C"
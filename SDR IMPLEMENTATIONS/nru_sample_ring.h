@@ -0,0 +1,128 @@
+/*
+ * NR-U Broadcast Sample Ring Header
+ * ---------------------------------
+ * One producer (the ingest thread) and any number of readers see the same
+ * conditioned, channelized RX stream. Every sample has a stream index
+ * (seq); a reader keeps its own cursor, so reading never removes samples
+ * from the others. The producer never waits: a reader that falls more than
+ * the capacity behind loses the oldest samples, and the loss is counted
+ * against that reader only.
+ *
+ * Copies are validated after the fact (seqlock style): samples the
+ * producer overwrote while they were being copied are dropped from the
+ * result and counted as lost.
+ *
+ * Location: common/utils/nru_sample_ring.h
+ */
+
+#ifndef NRU_SAMPLE_RING_H
+#define NRU_SAMPLE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_RING_MAX_READERS   16
+
+typedef struct nru_sample_ring nru_sample_ring_t;
+
+/**
+ * Zero-copy view of unread samples
+ * Up to two contiguous runs (the second after the ring wraps).
+ */
+typedef struct {
+    const float *iq[2];        // Interleaved I/Q
+    size_t n[2];               // Complex samples in each run
+    uint64_t seq;              // Stream index of the first sample
+} nru_ring_span_t;
+
+/* ============================================
+ *  RING
+ * ============================================ */
+
+/**
+ * @param min_samples: Capacity, rounded up to a power of two
+ */
+nru_sample_ring_t *nru_ring_create(size_t min_samples);
+void nru_ring_destroy(nru_sample_ring_t *r);
+
+size_t nru_ring_capacity(const nru_sample_ring_t *r);
+
+/**
+ * Samples ever written (stream index of the next one)
+ */
+uint64_t nru_ring_head(const nru_sample_ring_t *r);
+
+/**
+ * Append interleaved float I/Q (producer only, never blocks)
+ */
+void nru_ring_write(nru_sample_ring_t *r, const float *iq, size_t n_samples);
+
+/**
+ * Copy from stream index *seq onward and advance *seq
+ * Samples older than the ring holds are skipped and added to *lost.
+ * @return: Complex samples copied to dst (at most max_samples)
+ */
+size_t nru_ring_read_from(const nru_sample_ring_t *r, uint64_t *seq, float *dst,
+                          size_t max_samples, uint64_t *lost);
+
+/**
+ * Copy the latest n_samples (fewer if not yet written)
+ * @param seq: Out, stream index of dst[0] (may be NULL)
+ */
+size_t nru_ring_read_latest(const nru_sample_ring_t *r, float *dst, size_t n_samples,
+                            uint64_t *seq);
+
+/* ============================================
+ *  READERS
+ * ============================================ */
+
+/**
+ * Register a reader
+ * @param backlog: Start this many samples before the head (0 = new samples only)
+ * @return: Reader id, -1 if all NRU_RING_MAX_READERS slots are taken
+ */
+int nru_ring_reader_open(nru_sample_ring_t *r, size_t backlog, const char *name);
+void nru_ring_reader_close(nru_sample_ring_t *r, int id);
+
+/**
+ * Copy unread samples and advance the reader (memcpy-style access)
+ */
+size_t nru_ring_read(nru_sample_ring_t *r, int id, float *dst, size_t max_samples);
+
+/**
+ * View unread samples without copying
+ * The view stays valid until the producer laps it; check with release.
+ * @return: Complex samples in the span (at most max_samples)
+ */
+size_t nru_ring_peek(nru_sample_ring_t *r, int id, size_t max_samples, nru_ring_span_t *span);
+
+/**
+ * Advance the reader past a span from nru_ring_peek()
+ * @return: false if the producer overwrote part of the span while it was
+ *          in use (its contents are unreliable; counted as overrun)
+ */
+bool nru_ring_release(nru_sample_ring_t *r, int id, const nru_ring_span_t *span);
+
+/**
+ * Reader statistics
+ * @param lag: Samples written but not yet read
+ * @param overrun: Samples lost because the reader fell behind
+ * @return: Reader name, NULL if the slot is not open
+ */
+const char *nru_ring_reader_stats(const nru_sample_ring_t *r, int id, uint64_t *lag,
+                                  uint64_t *overrun);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_SAMPLE_RING_H */
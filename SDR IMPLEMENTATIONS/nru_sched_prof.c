@@ -0,0 +1,217 @@
+/*
+ * NR-U Scheduler Phase Profiler
+ * -----------------------------
+ * Single writer (the scheduler thread). Readers on the stats thread see
+ * counters that may be one slot stale, which is fine for reporting.
+ * Resets are requested by readers and applied by the writer at the next
+ * slot boundary.
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_sched_prof.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "common/utils/LOG/log.h"
+#include "common/utils/nru_clock.h"
+#include "NR_MAC_gNB/nru_sched_prof.h"
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t overruns;                 // Slots this phase dominated and overran
+    uint64_t hist[NRU_PROF_HIST_BUCKETS];
+} prof_phase_stats_t;
+
+typedef struct {
+    int frame;
+    int slot;
+    uint32_t total_us;
+    uint32_t budget_us;
+    nru_prof_phase_t worst;
+    uint32_t worst_us;
+} prof_overrun_t;
+
+static const char *const phase_names[NRU_PROF_PHASE_COUNT] = {
+    "lock", "nru_lbt", "ssb_lbt", "clear", "stats", "timers", "mib_sib",
+    "prach", "csirs", "csi_report", "srs", "ra", "ulsch", "dlsch",
+    "ue_rate", "pucch", "ul_tti"
+};
+
+bool nru_sched_prof_active = false;
+
+static atomic_bool prof_enabled = false;
+static atomic_bool prof_reset_pending = false;
+static atomic_uint prof_budget_override_us;
+static bool prof_env_checked = false;
+
+// Writer state
+static prof_phase_stats_t phase_stats[NRU_PROF_PHASE_COUNT];
+static uint64_t slot_phase_ns[NRU_PROF_PHASE_COUNT];
+static uint64_t slot_start_ticks;
+static uint64_t last_ticks;
+static int cur_frame, cur_slot;
+static uint32_t cur_budget_us;
+static uint64_t slots_profiled;
+
+// Overrun log (writer advances head, reporter follows with its own cursor)
+static prof_overrun_t overrun_log[NRU_PROF_OVERRUN_LOG];
+static atomic_ullong overrun_head;
+static uint64_t overrun_reported;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static inline int hist_bucket(uint64_t ns) {
+    int b = ns ? 63 - __builtin_clzll(ns) : 0;
+    return b < NRU_PROF_HIST_BUCKETS ? b : NRU_PROF_HIST_BUCKETS - 1;
+}
+
+static void apply_reset(void) {
+    memset(phase_stats, 0, sizeof(phase_stats));
+    slots_profiled = 0;
+    atomic_store(&overrun_head, 0);
+}
+
+// ---------------------------------------------------------------------
+// Slot probes
+// ---------------------------------------------------------------------
+void nru_sched_prof_slot_begin(int frame, int slot, uint32_t slot_budget_us) {
+    if (!prof_env_checked) {
+        const char *env = getenv("NRU_SCHED_PROF");
+        if (env && atoi(env) > 0)
+            atomic_store(&prof_enabled, true);
+        prof_env_checked = true;
+    }
+
+    nru_sched_prof_active = atomic_load_explicit(&prof_enabled, memory_order_relaxed);
+    if (!nru_sched_prof_active)
+        return;
+
+    if (atomic_exchange(&prof_reset_pending, false))
+        apply_reset();
+
+    uint32_t override_us = atomic_load_explicit(&prof_budget_override_us, memory_order_relaxed);
+    cur_frame = frame;
+    cur_slot = slot;
+    cur_budget_us = override_us ? override_us : slot_budget_us;
+    memset(slot_phase_ns, 0, sizeof(slot_phase_ns));
+    slot_start_ticks = last_ticks = nru_clock_ticks();
+}
+
+void nru_sched_prof_lap(nru_prof_phase_t phase) {
+    uint64_t now = nru_clock_ticks();
+    slot_phase_ns[phase] += nru_clock_ticks_to_ns(now - last_ticks);
+    last_ticks = now;
+}
+
+void nru_sched_prof_slot_end(void) {
+    uint64_t total_ns = nru_clock_ticks_to_ns(nru_clock_ticks() - slot_start_ticks);
+    nru_prof_phase_t worst = NRU_PROF_LOCK;
+
+    for (int p = 0; p < NRU_PROF_PHASE_COUNT; p++) {
+        uint64_t ns = slot_phase_ns[p];
+        if (ns > slot_phase_ns[worst])
+            worst = (nru_prof_phase_t)p;
+        if (ns == 0)
+            continue;
+        prof_phase_stats_t *s = &phase_stats[p];
+        s->calls++;
+        s->total_ns += ns;
+        if (ns > s->max_ns)
+            s->max_ns = ns;
+        s->hist[hist_bucket(ns)]++;
+    }
+    slots_profiled++;
+
+    if (cur_budget_us && total_ns > (uint64_t)cur_budget_us * 1000ULL) {
+        phase_stats[worst].overruns++;
+        uint64_t head = atomic_load_explicit(&overrun_head, memory_order_relaxed);
+        prof_overrun_t *o = &overrun_log[head % NRU_PROF_OVERRUN_LOG];
+        o->frame = cur_frame;
+        o->slot = cur_slot;
+        o->total_us = (uint32_t)(total_ns / 1000ULL);
+        o->budget_us = cur_budget_us;
+        o->worst = worst;
+        o->worst_us = (uint32_t)(slot_phase_ns[worst] / 1000ULL);
+        atomic_store_explicit(&overrun_head, head + 1, memory_order_release);
+    }
+    nru_sched_prof_active = false;
+}
+
+// ---------------------------------------------------------------------
+// Control
+// ---------------------------------------------------------------------
+void nru_sched_prof_set_enabled(bool enabled) {
+    prof_env_checked = true;
+    atomic_store(&prof_enabled, enabled);
+}
+
+bool nru_sched_prof_is_enabled(void) {
+    return atomic_load(&prof_enabled);
+}
+
+void nru_sched_prof_set_budget_us(uint32_t budget_us) {
+    atomic_store(&prof_budget_override_us, budget_us);
+}
+
+void nru_sched_prof_reset(void) {
+    atomic_store(&prof_reset_pending, true);
+}
+
+const char *nru_sched_prof_phase_name(nru_prof_phase_t phase) {
+    return (phase >= 0 && phase < NRU_PROF_PHASE_COUNT) ? phase_names[phase] : "?";
+}
+
+// ---------------------------------------------------------------------
+// Reporting (stats thread)
+// ---------------------------------------------------------------------
+void nru_sched_prof_log_report(void) {
+    if (!nru_sched_prof_is_enabled())
+        return;
+
+    char line[512];
+    LOG_I(NR_MAC, "[NRU][PROF] %lu slots profiled (budget %u us)\n",
+          (unsigned long)slots_profiled, cur_budget_us);
+
+    for (int p = 0; p < NRU_PROF_PHASE_COUNT; p++) {
+        const prof_phase_stats_t *s = &phase_stats[p];
+        if (s->calls == 0)
+            continue;
+        // Histogram as "<upper bound>:count" over non-empty buckets
+        size_t len = 0;
+        for (int b = 0; b < NRU_PROF_HIST_BUCKETS && len < sizeof(line); b++) {
+            if (!s->hist[b])
+                continue;
+            uint64_t upper_ns = 2ULL << b;
+            int n = (upper_ns >= 10000ULL)
+                        ? snprintf(line + len, sizeof(line) - len, " <%luus:%lu",
+                                   (unsigned long)(upper_ns / 1000ULL), (unsigned long)s->hist[b])
+                        : snprintf(line + len, sizeof(line) - len, " <%luns:%lu",
+                                   (unsigned long)upper_ns, (unsigned long)s->hist[b]);
+            if (n < 0)
+                break;
+            len += (size_t)n;
+        }
+        if (len == 0)
+            line[0] = '\0';
+        LOG_I(NR_MAC, "[NRU][PROF] %-10s calls %8lu mean %7.2f us max %8.2f us overruns %lu |%s\n",
+              phase_names[p], (unsigned long)s->calls,
+              s->total_ns / 1000.0 / s->calls, s->max_ns / 1000.0,
+              (unsigned long)s->overruns, line);
+    }
+
+    uint64_t head = atomic_load_explicit(&overrun_head, memory_order_acquire);
+    if (head < overrun_reported)        // a reset happened in between
+        overrun_reported = 0;
+    if (head - overrun_reported > NRU_PROF_OVERRUN_LOG)
+        overrun_reported = head - NRU_PROF_OVERRUN_LOG;
+    for (; overrun_reported < head; overrun_reported++) {
+        const prof_overrun_t *o = &overrun_log[overrun_reported % NRU_PROF_OVERRUN_LOG];
+        LOG_W(NR_MAC, "[NRU][PROF] Overrun %d.%d: %u us > %u us, dominated by %s (%u us)\n",
+              o->frame, o->slot, o->total_us, o->budget_us,
+              phase_names[o->worst], o->worst_us);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * NR-U Scheduler Phase Profiler Header
+ * ------------------------------------
+ * Splits gNB_dlsch_ulsch_scheduler() into phases and keeps, per phase, a
+ * log2-scaled latency histogram plus the phase that dominated every slot
+ * which overran its budget. Timestamps are raw nru_clock ticks (TSC);
+ * when disabled each probe is one predictable branch.
+ *
+ * Enable with NRU_SCHED_PROF=1 in the environment or at runtime with
+ * nru_sched_prof_set_enabled(). Reports are written by the MAC stats
+ * thread, never from the slot path.
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_sched_prof.h
+ */
+
+#ifndef NRU_SCHED_PROF_H
+#define NRU_SCHED_PROF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  PHASES
+ * ============================================ */
+
+typedef enum {
+    NRU_PROF_LOCK = 0,                 // Waiting for NR_SCHED_LOCK
+    NRU_PROF_LBT,                      // Per-slot NR-U LBT block
+    NRU_PROF_SSB_LBT,                  // DRS window (SSB/SIB1) Type 2A LBT
+    NRU_PROF_CLEAR,                    // VRB maps, beams, nFAPI reset
+    NRU_PROF_STATS,                    // MAC stats snapshot
+    NRU_PROF_TIMERS,                   // Measurement gaps, MAC timers
+    NRU_PROF_MIB_SIB,                  // MIB / SIB1 / other SIBs
+    NRU_PROF_PRACH,
+    NRU_PROF_CSIRS,
+    NRU_PROF_CSI_REPORT,
+    NRU_PROF_SRS,
+    NRU_PROF_RA,
+    NRU_PROF_ULSCH,
+    NRU_PROF_DLSCH,
+    NRU_PROF_UE_RATE,
+    NRU_PROF_PUCCH,                    // SR reporting + PUCCH
+    NRU_PROF_UL_TTI,                   // UL TTI handoff to L1
+    NRU_PROF_PHASE_COUNT
+} nru_prof_phase_t;
+
+#define NRU_PROF_HIST_BUCKETS  32      // Bucket k holds [2^k, 2^(k+1)) ns
+#define NRU_PROF_OVERRUN_LOG   64      // Most recent overruns kept
+
+/* ============================================
+ *  SLOT PROBES (scheduler thread)
+ * ============================================ */
+
+extern bool nru_sched_prof_active;     // Set per slot by slot_begin
+
+/**
+ * Start timing one slot
+ * @param slot_budget_us: Deadline for the whole scheduler call
+ */
+void nru_sched_prof_slot_begin(int frame, int slot, uint32_t slot_budget_us);
+
+/**
+ * Attribute the time since the previous probe to a phase
+ */
+void nru_sched_prof_lap(nru_prof_phase_t phase);
+
+/**
+ * Close the slot, update histograms and record an overrun if any
+ */
+void nru_sched_prof_slot_end(void);
+
+#define NRU_PROF_LAP(phase) \
+    do { if (nru_sched_prof_active) nru_sched_prof_lap(phase); } while (0)
+#define NRU_PROF_SLOT_END() \
+    do { if (nru_sched_prof_active) nru_sched_prof_slot_end(); } while (0)
+
+/* ============================================
+ *  CONTROL AND REPORTING (any thread)
+ * ============================================ */
+
+/**
+ * Runtime toggle (takes effect at the next slot)
+ */
+void nru_sched_prof_set_enabled(bool enabled);
+bool nru_sched_prof_is_enabled(void);
+
+/**
+ * Override the per-slot budget (0 = use the slot duration)
+ */
+void nru_sched_prof_set_budget_us(uint32_t budget_us);
+
+/**
+ * Clear histograms and overrun history
+ */
+void nru_sched_prof_reset(void);
+
+/**
+ * Log per-phase histograms and overruns seen since the last report
+ */
+void nru_sched_prof_log_report(void);
+
+/**
+ * Human-readable phase name
+ */
+const char *nru_sched_prof_phase_name(nru_prof_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_SCHED_PROF_H */
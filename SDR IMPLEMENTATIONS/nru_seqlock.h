@@ -0,0 +1,107 @@
+/*
+ * NR-U Seqlock Header
+ * -------------------
+ * Single-writer sequence counters for data that readers must see whole
+ * (statistics snapshots, clock mappings, shared-memory slots). The writer
+ * makes the counter odd, updates the data and makes it even again; a
+ * reader copies the data between two counter loads and retries if the
+ * counter was odd or moved. Readers never hold up the writer.
+ *
+ * Ordering: the release fence after the first increment keeps the data
+ * stores behind it, and the acquire fence after the copy keeps the data
+ * loads ahead of the second counter load. A copy is only meaningful once
+ * validated.
+ *
+ * Counters are plain integers used through the GCC __atomic builtins, so
+ * they may live in shared memory and be shared by C and C++. Shared
+ * layouts fix the width, hence the 32- and 64-bit variants.
+ *
+ * Location: common/utils/nru_seqlock.h
+ */
+
+#ifndef NRU_SEQLOCK_H
+#define NRU_SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  32-BIT COUNTER
+ * ============================================ */
+
+static inline void nru_seq_write_begin(uint32_t *seq) {
+    __atomic_fetch_add(seq, 1, __ATOMIC_RELAXED);                // Odd: writing
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void nru_seq_write_end(uint32_t *seq) {
+    __atomic_fetch_add(seq, 1, __ATOMIC_RELEASE);                // Even: stable
+}
+
+/**
+ * Counter before the copy
+ */
+static inline uint32_t nru_seq_read_begin(const uint32_t *seq) {
+    return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Whether the copy made since nru_seq_read_begin() returned start is torn
+ */
+static inline bool nru_seq_read_retry(const uint32_t *seq, uint32_t start) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (start & 1u) || start != __atomic_load_n(seq, __ATOMIC_RELAXED);
+}
+
+/* ============================================
+ *  64-BIT COUNTER
+ * ============================================ */
+
+static inline void nru_seq64_write_begin(uint64_t *seq) {
+    __atomic_fetch_add(seq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void nru_seq64_write_end(uint64_t *seq) {
+    __atomic_fetch_add(seq, 1, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t nru_seq64_read_begin(const uint64_t *seq) {
+    return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Counter after the copy (for counters that are not odd/even, see below)
+ */
+static inline uint64_t nru_seq64_read_end(const uint64_t *seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(seq, __ATOMIC_RELAXED);
+}
+
+static inline bool nru_seq64_read_retry(const uint64_t *seq, uint64_t start) {
+    return (start & 1u) || start != nru_seq64_read_end(seq);
+}
+
+/*
+ * Position counters: a stream writer announces the end of what it is
+ * about to overwrite (mark) and then what it has written (set); readers
+ * compare positions instead of testing for odd values.
+ */
+static inline void nru_seq64_write_mark(uint64_t *seq, uint64_t value) {
+    __atomic_store_n(seq, value, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void nru_seq64_write_set(uint64_t *seq, uint64_t value) {
+    __atomic_store_n(seq, value, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_SEQLOCK_H */
@@ -0,0 +1,322 @@
+/*
+ * NR-U Spectrum Monitor
+ * ---------------------
+ * Welch PSD without overlap: Hann-windowed radix-2 FFTs are accumulated
+ * in linear power until publish, which writes the mean (and the per-bin
+ * maximum, so short bursts stay visible) in dBm to the next shm slot.
+ *
+ * Bin power is |X_k|^2 / (N * sum w^2): the bins of a frame add up to the
+ * mean power of the stream, the same quantity the energy detector uses.
+ *
+ * Fields shared with viewers are accessed with the GCC __atomic builtins
+ * (the layout is plain C so any process can map it); each slot is a
+ * seqlock (nru_seqlock.h).
+ *
+ * Location: common/utils/nru_spectrum.cpp
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "nru_seqlock.h"
+#include "nru_spectrum.h"
+
+struct nru_spectrum {
+    std::string shm_name;
+    void *map;
+    size_t map_bytes;
+    nru_spectrum_shm_t *hdr;
+
+    size_t n;                                  // FFT size
+    std::vector<float> window;
+    float bin_scale;                           // 1 / (N * sum w^2)
+    std::vector<std::complex<float>> twiddle;  // exp(-j 2 pi k / N), k < N/2
+    std::vector<uint32_t> bitrev;
+
+    std::vector<std::complex<float>> fft;      // Work buffer
+    size_t fill;                               // Samples of the partial FFT
+    std::vector<double> acc;                   // Sum of bin powers
+    std::vector<float> peak;                   // Max bin power
+    uint32_t n_ffts;
+
+    double rate_hz;
+    double center_hz;
+    float cal_offset_db;
+    float ed_threshold_dbm;
+};
+
+struct nru_spectrum_view {
+    void *map;
+    size_t map_bytes;
+    const nru_spectrum_shm_t *hdr;
+};
+
+static size_t slot_bytes_for(size_t n) {
+    const size_t bytes = sizeof(nru_spectrum_frame_t) + 2 * n * sizeof(float);
+    return (bytes + 63) / 64 * 64;
+}
+
+static uint8_t *slot_ptr(const nru_spectrum_shm_t *hdr, uint64_t frame) {
+    return (uint8_t *)hdr + NRU_SPECTRUM_HDR_BYTES + (frame % hdr->n_slots) * hdr->slot_bytes;
+}
+
+// In-place iterative radix-2 FFT
+static void fft_forward(nru_spectrum *s) {
+    std::complex<float> *x = s->fft.data();
+    const size_t n = s->n;
+    for (size_t i = 0; i < n; i++)
+        if (s->bitrev[i] > i)
+            std::swap(x[i], x[s->bitrev[i]]);
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const size_t half = len / 2, stride = n / len;
+        for (size_t i = 0; i < n; i += len)
+            for (size_t k = 0; k < half; k++) {
+                const std::complex<float> t = x[i + k + half] * s->twiddle[k * stride];
+                x[i + k + half] = x[i + k] - t;
+                x[i + k] += t;
+            }
+    }
+}
+
+extern "C" {
+
+/* ============================================
+ *  PRODUCER
+ * ============================================ */
+
+nru_spectrum_t *nru_spectrum_create(const char *shm_name, int fft_size) {
+    size_t n = NRU_SPECTRUM_MIN_FFT;
+    while (n < static_cast<size_t>(std::max(fft_size, 0)) && n < NRU_SPECTRUM_MAX_FFT)
+        n <<= 1;
+
+    const char *name = shm_name ? shm_name : NRU_SPECTRUM_SHM_NAME;
+    const size_t slot_bytes = slot_bytes_for(n);
+    const size_t bytes = NRU_SPECTRUM_HDR_BYTES + NRU_SPECTRUM_SLOTS * slot_bytes;
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+        return nullptr;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    void *map = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return nullptr;
+
+    auto *s = new nru_spectrum();
+    s->shm_name = name;
+    s->map = map;
+    s->map_bytes = bytes;
+    s->hdr = static_cast<nru_spectrum_shm_t *>(map);
+    std::memset(map, 0, bytes);
+    s->hdr->version = NRU_SPECTRUM_VERSION;
+    s->hdr->fft_size = static_cast<uint32_t>(n);
+    s->hdr->n_slots = NRU_SPECTRUM_SLOTS;
+    s->hdr->slot_bytes = static_cast<uint32_t>(slot_bytes);
+    __atomic_store_n(&s->hdr->magic, NRU_SPECTRUM_MAGIC, __ATOMIC_RELEASE);
+
+    s->n = n;
+    s->window.resize(n);
+    double sum_w2 = 0.0;
+    for (size_t k = 0; k < n; k++) {
+        s->window[k] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * k / n));
+        sum_w2 += s->window[k] * s->window[k];
+    }
+    s->bin_scale = static_cast<float>(1.0 / (n * sum_w2));
+    s->twiddle.resize(n / 2);
+    for (size_t k = 0; k < n / 2; k++)
+        s->twiddle[k] = std::polar(1.0f, static_cast<float>(-2.0 * M_PI * k / n));
+    s->bitrev.resize(n);
+    int bits = 0;
+    while ((size_t(1) << bits) < n) bits++;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; b++)
+            if (i & (size_t(1) << b)) r |= 1u << (bits - 1 - b);
+        s->bitrev[i] = r;
+    }
+
+    s->fft.resize(n);
+    s->fill = 0;
+    s->acc.assign(n, 0.0);
+    s->peak.assign(n, 0.0f);
+    s->n_ffts = 0;
+    s->rate_hz = 0.0;
+    s->center_hz = 0.0;
+    s->cal_offset_db = 0.0f;
+    s->ed_threshold_dbm = 0.0f;
+    return s;
+}
+
+void nru_spectrum_destroy(nru_spectrum_t *s) {
+    if (!s) return;
+    __atomic_store_n(&s->hdr->magic, 0u, __ATOMIC_RELEASE);
+    munmap(s->map, s->map_bytes);
+    shm_unlink(s->shm_name.c_str());
+    delete s;
+}
+
+int nru_spectrum_fft_size(const nru_spectrum_t *s) {
+    return s ? static_cast<int>(s->n) : 0;
+}
+
+void nru_spectrum_set_stream(nru_spectrum_t *s, double rate_hz, double center_hz,
+                             float cal_offset_db, float ed_threshold_dbm) {
+    if (!s) return;
+    s->rate_hz = rate_hz;
+    s->center_hz = center_hz;
+    s->cal_offset_db = cal_offset_db;
+    s->ed_threshold_dbm = ed_threshold_dbm;
+}
+
+size_t nru_spectrum_feed(nru_spectrum_t *s, const float *iq, size_t n_samples) {
+    if (!s || !iq) return 0;
+    size_t done = 0;
+    while (n_samples > 0) {
+        const size_t take = std::min(n_samples, s->n - s->fill);
+        for (size_t k = 0; k < take; k++) {
+            const float w = s->window[s->fill + k];
+            s->fft[s->fill + k] = std::complex<float>(iq[2 * k] * w, iq[2 * k + 1] * w);
+        }
+        s->fill += take;
+        iq += 2 * take;
+        n_samples -= take;
+        if (s->fill < s->n)
+            break;
+
+        fft_forward(s);
+        for (size_t k = 0; k < s->n; k++) {
+            const float p = std::norm(s->fft[k]) * s->bin_scale;
+            s->acc[k] += p;
+            s->peak[k] = std::max(s->peak[k], p);
+        }
+        s->fill = 0;
+        s->n_ffts++;
+        done++;
+    }
+    return done;
+}
+
+void nru_spectrum_restart(nru_spectrum_t *s) {
+    if (s) s->fill = 0;
+}
+
+int nru_spectrum_publish(nru_spectrum_t *s, uint64_t time_us) {
+    if (!s || s->n_ffts == 0) return 0;
+
+    nru_spectrum_shm_t *hdr = s->hdr;
+    const uint64_t frame = __atomic_load_n(&hdr->frames, __ATOMIC_RELAXED);
+    uint8_t *slot = slot_ptr(hdr, frame);
+    auto *info = reinterpret_cast<nru_spectrum_frame_t *>(slot);
+    float *avg = reinterpret_cast<float *>(slot + sizeof(nru_spectrum_frame_t));
+    float *peak = avg + s->n;
+
+    nru_seq64_write_begin(&info->seq);
+    info->frame = frame;
+    info->time_us = time_us;
+    info->rate_hz = s->rate_hz;
+    info->center_hz = s->center_hz;
+    info->n_ffts = s->n_ffts;
+    info->ed_threshold_dbm = s->ed_threshold_dbm;
+    const size_t half = s->n / 2;
+    for (size_t k = 0; k < s->n; k++) {
+        const size_t b = (k + half) % s->n;                    // DC to the centre
+        avg[k] = 10.0f * log10f(std::max(static_cast<float>(s->acc[b] / s->n_ffts), 1e-15f))
+                 + s->cal_offset_db;
+        peak[k] = 10.0f * log10f(std::max(s->peak[b], 1e-15f)) + s->cal_offset_db;
+    }
+    nru_seq64_write_end(&info->seq);
+    __atomic_store_n(&hdr->frames, frame + 1, __ATOMIC_RELEASE);
+
+    std::fill(s->acc.begin(), s->acc.end(), 0.0);
+    std::fill(s->peak.begin(), s->peak.end(), 0.0f);
+    s->n_ffts = 0;
+    return 1;
+}
+
+/* ============================================
+ *  VIEWER
+ * ============================================ */
+
+nru_spectrum_view_t *nru_spectrum_view_open(const char *shm_name) {
+    int fd = shm_open(shm_name ? shm_name : NRU_SPECTRUM_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < NRU_SPECTRUM_HDR_BYTES) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return nullptr;
+
+    auto *hdr = static_cast<const nru_spectrum_shm_t *>(map);
+    if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != NRU_SPECTRUM_MAGIC ||
+        hdr->version != NRU_SPECTRUM_VERSION || hdr->n_slots == 0 ||
+        NRU_SPECTRUM_HDR_BYTES + static_cast<size_t>(hdr->n_slots) * hdr->slot_bytes > bytes ||
+        hdr->slot_bytes < slot_bytes_for(hdr->fft_size)) {
+        munmap(map, bytes);
+        return nullptr;
+    }
+    auto *v = new nru_spectrum_view();
+    v->map = map;
+    v->map_bytes = bytes;
+    v->hdr = hdr;
+    return v;
+}
+
+void nru_spectrum_view_close(nru_spectrum_view_t *v) {
+    if (!v) return;
+    munmap(v->map, v->map_bytes);
+    delete v;
+}
+
+int nru_spectrum_view_fft_size(const nru_spectrum_view_t *v) {
+    if (!v || __atomic_load_n(&v->hdr->magic, __ATOMIC_ACQUIRE) != NRU_SPECTRUM_MAGIC)
+        return 0;
+    return static_cast<int>(v->hdr->fft_size);
+}
+
+uint64_t nru_spectrum_view_frames(const nru_spectrum_view_t *v) {
+    return v ? __atomic_load_n(&v->hdr->frames, __ATOMIC_ACQUIRE) : 0;
+}
+
+int nru_spectrum_view_read(const nru_spectrum_view_t *v, uint64_t frame,
+                           nru_spectrum_frame_t *info, float *avg_dbm, float *peak_dbm) {
+    if (!v || frame >= nru_spectrum_view_frames(v))
+        return 0;
+    const size_t n = v->hdr->fft_size;
+    const uint8_t *slot = slot_ptr(v->hdr, frame);
+    const auto *src = reinterpret_cast<const nru_spectrum_frame_t *>(slot);
+    const float *avg = reinterpret_cast<const float *>(slot + sizeof(nru_spectrum_frame_t));
+
+    for (int attempt = 0; attempt < 4; attempt++) {
+        const uint64_t seq = nru_seq64_read_begin(&src->seq);
+        if (seq & 1)
+            continue;
+        nru_spectrum_frame_t copy;
+        std::memcpy(&copy, src, sizeof(copy));
+        if (avg_dbm) std::memcpy(avg_dbm, avg, n * sizeof(float));
+        if (peak_dbm) std::memcpy(peak_dbm, avg + n, n * sizeof(float));
+        if (nru_seq64_read_retry(&src->seq, seq))
+            continue;
+        if (copy.frame != frame)
+            return 0;                       // Slot reused by a newer frame
+        if (info) *info = copy;
+        return 1;
+    }
+    return 0;
+}
+
+} // extern "C"
@@ -0,0 +1,152 @@
+/*
+ * NR-U Spectrum Monitor Header
+ * ----------------------------
+ * Averaged PSD frames of the sensing stream, published to a POSIX
+ * shared-memory ring so a local viewer (nru_spectrum_view, or anything
+ * that can mmap /dev/shm/nru_spectrum) watches the channel live without
+ * touching the RX or ingest threads.
+ *
+ * The helper runs the monitor on its own thread with a reader on the
+ * sample ring (nru_sample_ring.h); this module only turns samples into
+ * frames and handles the shared memory, so viewers link it alone.
+ *
+ * Shared-memory layout (native endianness):
+ *   nru_spectrum_shm_t                      header, NRU_SPECTRUM_HDR_BYTES
+ *   n_slots x slot_bytes                    frame slots, newest = (frames - 1) % n_slots
+ *     nru_spectrum_frame_t                  frame info
+ *     float avg_dbm[fft_size]               mean power per bin
+ *     float peak_dbm[fft_size]              max power per bin over the frame
+ * Bins run from -rate/2 to +rate/2 (DC at fft_size / 2). Each slot is a
+ * seqlock: seq is odd while the producer writes it.
+ *
+ * Location: common/utils/nru_spectrum.h
+ */
+
+#ifndef NRU_SPECTRUM_H
+#define NRU_SPECTRUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_SPECTRUM_SHM_NAME     "/nru_spectrum"
+#define NRU_SPECTRUM_MAGIC        0x5355524eu    // "NRUS"
+#define NRU_SPECTRUM_VERSION      1
+#define NRU_SPECTRUM_SLOTS        64
+#define NRU_SPECTRUM_HDR_BYTES    64
+#define NRU_SPECTRUM_MIN_FFT      64
+#define NRU_SPECTRUM_MAX_FFT      8192
+
+/* ============================================
+ *  SHARED-MEMORY LAYOUT
+ * ============================================ */
+
+typedef struct {
+    uint32_t magic;            // NRU_SPECTRUM_MAGIC while the producer is alive
+    uint32_t version;
+    uint32_t fft_size;
+    uint32_t n_slots;
+    uint32_t slot_bytes;       // Stride between slots (64-byte multiple)
+    uint32_t reserved;
+    uint64_t frames;           // Frames published
+} nru_spectrum_shm_t;
+
+typedef struct {
+    uint64_t seq;              // Odd while being written
+    uint64_t frame;            // Frame number (0-based)
+    uint64_t time_us;          // nru_clock time of publication
+    double rate_hz;            // Sample rate of the analysed stream
+    double center_hz;          // RF frequency of bin fft_size / 2
+    uint32_t n_ffts;           // FFTs averaged into this frame
+    float ed_threshold_dbm;    // ED threshold at publication (viewer overlay)
+} nru_spectrum_frame_t;
+
+/* ============================================
+ *  PRODUCER
+ * ============================================ */
+
+typedef struct nru_spectrum nru_spectrum_t;
+
+/**
+ * Create the shared-memory ring and the FFT state
+ * @param shm_name: POSIX shm name (NULL = NRU_SPECTRUM_SHM_NAME)
+ * @param fft_size: Bins, rounded up to a power of two in [64, 8192]
+ * @return: NULL if the shared memory cannot be created
+ */
+nru_spectrum_t *nru_spectrum_create(const char *shm_name, int fft_size);
+
+/**
+ * Unmap and unlink the shared memory (viewers see magic = 0)
+ */
+void nru_spectrum_destroy(nru_spectrum_t *s);
+
+int nru_spectrum_fft_size(const nru_spectrum_t *s);
+
+/**
+ * Stream description stamped on the following frames
+ * @param cal_offset_db: dBm = dBFS + offset
+ */
+void nru_spectrum_set_stream(nru_spectrum_t *s, double rate_hz, double center_hz,
+                             float cal_offset_db, float ed_threshold_dbm);
+
+/**
+ * Add contiguous interleaved float I/Q (Hann-windowed FFTs, no overlap)
+ * A partial FFT is kept for the next call.
+ * @return: FFTs completed
+ */
+size_t nru_spectrum_feed(nru_spectrum_t *s, const float *iq, size_t n_samples);
+
+/**
+ * Drop a partial FFT (call at a gap in the input)
+ */
+void nru_spectrum_restart(nru_spectrum_t *s);
+
+/**
+ * Publish the FFTs accumulated since the last frame
+ * @return: 1 published, 0 nothing accumulated
+ */
+int nru_spectrum_publish(nru_spectrum_t *s, uint64_t time_us);
+
+/* ============================================
+ *  VIEWER
+ * ============================================ */
+
+typedef struct nru_spectrum_view nru_spectrum_view_t;
+
+/**
+ * Map a producer's ring read-only
+ * @return: NULL if no producer (or a different layout version) is there
+ */
+nru_spectrum_view_t *nru_spectrum_view_open(const char *shm_name);
+void nru_spectrum_view_close(nru_spectrum_view_t *v);
+
+/**
+ * Bins per frame, 0 once the producer is gone (reopen to follow a restart)
+ */
+int nru_spectrum_view_fft_size(const nru_spectrum_view_t *v);
+
+/**
+ * Frames published so far (the newest is frames - 1)
+ */
+uint64_t nru_spectrum_view_frames(const nru_spectrum_view_t *v);
+
+/**
+ * Copy one frame
+ * @param avg_dbm, peak_dbm: fft_size values each (either may be NULL)
+ * @return: 1 copied, 0 not published yet or already overwritten
+ */
+int nru_spectrum_view_read(const nru_spectrum_view_t *v, uint64_t frame,
+                           nru_spectrum_frame_t *info, float *avg_dbm, float *peak_dbm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_SPECTRUM_H */
@@ -0,0 +1,189 @@
+/*
+ * NR-U Live Spectrum Viewer
+ * -------------------------
+ * Terminal waterfall of the PSD frames the gNB publishes to shared memory
+ * (nru_spectrum.h). One line per frame, newest at the bottom; bins are
+ * merged to the terminal width by their maximum, so a narrow burst is not
+ * averaged away. '|' marks bins at or above the ED threshold in peak mode.
+ *
+ * Reads only the shared memory: it can be started, stopped and restarted
+ * at any time without affecting the RX path. With -o the frames are also
+ * written as CSV (one row per frame: frame, time, centre, rate, FFTs,
+ * then the average bins).
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 nru_spectrum_view.cpp nru_spectrum.cpp -lrt -o nru_spectrum_view
+ *
+ * Example:
+ *   ./nru_spectrum_view --min-dbm -100 --max-dbm -50 --width 120
+ *   ./nru_spectrum_view --peak --frames 600 -o spectrum.csv
+ *
+ * Author: Integration for OAI NR-U Makhubela Innocent(MKHINN011)
+ * Date: 2025
+ */
+
+#include <getopt.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "nru_spectrum.h"
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+static const char SHADES[] = " .:-=+*#%@";
+static const int POLL_US = 10000;
+
+struct ViewParams {
+    std::string shm_name = NRU_SPECTRUM_SHM_NAME;
+    int width = 100;
+    double min_dbm = -110.0;
+    double max_dbm = -40.0;
+    bool peak = false;
+    long frames = 0;                 // 0 = until interrupted
+    std::string output;
+};
+
+static void print_axis(const nru_spectrum_frame_t &info, int width) {
+    printf("[NRU][SPECTRUM] %.3f MHz centre, %.2f MSps span, %u FFTs/frame\n",
+           info.center_hz / 1e6, info.rate_hz / 1e6, info.n_ffts);
+    printf("%-*.1f|%*.1f\n", width / 2, (info.center_hz - info.rate_hz / 2) / 1e6,
+           width - width / 2 - 1, (info.center_hz + info.rate_hz / 2) / 1e6);
+}
+
+static void print_row(const ViewParams &p, const nru_spectrum_frame_t &info,
+                      const std::vector<float> &bins) {
+    const size_t n = bins.size();
+    std::string line(p.width, ' ');
+    for (int c = 0; c < p.width; c++) {
+        const size_t lo = c * n / p.width, hi = std::max(lo + 1, (c + 1) * n / p.width);
+        float v = bins[lo];
+        for (size_t k = lo + 1; k < hi; k++)
+            v = std::max(v, bins[k]);
+        if (p.peak && v >= info.ed_threshold_dbm) {
+            line[c] = '|';
+            continue;
+        }
+        double x = (v - p.min_dbm) / (p.max_dbm - p.min_dbm);
+        x = std::min(1.0, std::max(0.0, x));
+        line[c] = SHADES[static_cast<int>(x * (sizeof(SHADES) - 2) + 0.5)];
+    }
+    printf("%s %6.1f\n", line.c_str(), *std::max_element(bins.begin(), bins.end()));
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [OPTIONS]\n"
+           "  -n, --name NAME          Shared-memory name (default %s)\n"
+           "      --width N            Columns (default 100)\n"
+           "      --min-dbm X          Bottom of the colour scale (default -110)\n"
+           "      --max-dbm X          Top of the colour scale (default -40)\n"
+           "      --peak               Show the per-frame peak instead of the average\n"
+           "      --frames N           Stop after N frames (default: run until interrupted)\n"
+           "  -o, --output FILE        Also write frames as CSV\n", prog, NRU_SPECTRUM_SHM_NAME);
+}
+
+int main(int argc, char **argv) {
+    ViewParams p;
+    enum { OPT_WIDTH = 256, OPT_MIN, OPT_MAX, OPT_PEAK, OPT_FRAMES };
+    static const struct option opts[] = {
+        {"name", required_argument, nullptr, 'n'},
+        {"width", required_argument, nullptr, OPT_WIDTH},
+        {"min-dbm", required_argument, nullptr, OPT_MIN},
+        {"max-dbm", required_argument, nullptr, OPT_MAX},
+        {"peak", no_argument, nullptr, OPT_PEAK},
+        {"frames", required_argument, nullptr, OPT_FRAMES},
+        {"output", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "n:o:h", opts, nullptr)) != -1) {
+        switch (c) {
+            case 'n': p.shm_name = optarg; break;
+            case OPT_WIDTH: p.width = atoi(optarg); break;
+            case OPT_MIN: p.min_dbm = atof(optarg); break;
+            case OPT_MAX: p.max_dbm = atof(optarg); break;
+            case OPT_PEAK: p.peak = true; break;
+            case OPT_FRAMES: p.frames = atol(optarg); break;
+            case 'o': p.output = optarg; break;
+            case 'h': usage(argv[0]); return 0;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (p.width < 8 || p.max_dbm <= p.min_dbm) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *csv = nullptr;
+    if (!p.output.empty() && !(csv = fopen(p.output.c_str(), "w"))) {
+        perror(p.output.c_str());
+        return 1;
+    }
+
+    nru_spectrum_view_t *view = nullptr;
+    std::vector<float> avg, peak;
+    uint64_t next = 0;
+    double shown_center = -1.0, shown_rate = -1.0;
+    long shown = 0;
+    bool waiting = false;
+
+    while (p.frames == 0 || shown < p.frames) {
+        // (Re)attach: the producer may not be up yet, or may have restarted
+        if (!view || nru_spectrum_view_fft_size(view) == 0) {
+            nru_spectrum_view_close(view);
+            view = nru_spectrum_view_open(p.shm_name.c_str());
+            if (!view) {
+                if (!waiting)
+                    fprintf(stderr, "[NRU][SPECTRUM] Waiting for %s...\n", p.shm_name.c_str());
+                waiting = true;
+                usleep(10 * POLL_US);
+                continue;
+            }
+            waiting = false;
+            const size_t n = nru_spectrum_view_fft_size(view);
+            avg.resize(n);
+            peak.resize(n);
+            next = nru_spectrum_view_frames(view);
+            shown_center = shown_rate = -1.0;
+        }
+
+        const uint64_t frames = nru_spectrum_view_frames(view);
+        if (next >= frames) {
+            usleep(POLL_US);
+            continue;
+        }
+        if (frames - next > NRU_SPECTRUM_SLOTS / 2)
+            next = frames - 1;                  // Fell behind: jump to the newest
+
+        nru_spectrum_frame_t info;
+        if (!nru_spectrum_view_read(view, next++, &info, avg.data(), peak.data()))
+            continue;
+        if (info.center_hz != shown_center || info.rate_hz != shown_rate) {
+            print_axis(info, p.width);
+            shown_center = info.center_hz;
+            shown_rate = info.rate_hz;
+        }
+        print_row(p, info, p.peak ? peak : avg);
+        fflush(stdout);
+
+        if (csv) {
+            fprintf(csv, "%llu,%llu,%.0f,%.0f,%u", (unsigned long long)info.frame,
+                    (unsigned long long)info.time_us, info.center_hz, info.rate_hz, info.n_ffts);
+            for (float v : avg)
+                fprintf(csv, ",%.2f", v);
+            fprintf(csv, "\n");
+        }
+        shown++;
+    }
+
+    nru_spectrum_view_close(view);
+    if (csv) fclose(csv);
+    return 0;
+}
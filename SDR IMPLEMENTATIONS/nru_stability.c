@@ -0,0 +1,232 @@
+/*
+ * NR-U Channel Stability Engine
+ * -----------------------------
+ * Single writer (the thread making LBT decisions). Every observation
+ * closes the interval since the previous one and books it, with the
+ * previous state, into a ring of time buckets with running sums. The
+ * result is published behind a seqlock.
+ *
+ * Location: common/utils/nru_stability.c
+ */
+
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#ifdef NRU_LBT_STANDALONE
+#include "nru_clock.h"
+#include "nru_seqlock.h"
+#include "nru_stability.h"
+#else
+#include "common/utils/nru_clock.h"
+#include "common/utils/nru_seqlock.h"
+#include "common/utils/nru_stability.h"
+#endif
+
+#define IDLE_RUN_EWMA_WEIGHT 0.125
+
+typedef struct {
+    uint64_t busy_us;
+    uint64_t seen_us;
+    uint32_t busy_runs;
+} stab_bucket_t;
+
+// Criteria
+static NRU_TLS nru_stability_cfg_t stab_cfg = {
+    NRU_STAB_DEFAULT_HORIZON_MS, NRU_STAB_DEFAULT_MIN_IDLE_US,
+    NRU_STAB_DEFAULT_MAX_BUSY_PER_S, NRU_STAB_DEFAULT_MAX_BUSY_FRAC
+};
+static NRU_TLS uint64_t bucket_us = NRU_STAB_DEFAULT_HORIZON_MS * 1000ULL / NRU_STAB_BUCKETS;
+
+// Writer state
+static NRU_TLS bool have_obs;
+static NRU_TLS bool cur_busy;
+static NRU_TLS uint64_t last_us;
+static NRU_TLS uint64_t run_start_us;
+static NRU_TLS uint64_t bucket_idx;      // Absolute index of the current bucket
+static NRU_TLS stab_bucket_t buckets[NRU_STAB_BUCKETS];
+static NRU_TLS uint64_t sum_busy_us, sum_seen_us, sum_busy_runs;
+static NRU_TLS double idle_mean, idle_var;
+static NRU_TLS uint64_t idle_runs;
+
+// Published statistics
+static NRU_TLS uint32_t pub_seq;
+static NRU_TLS nru_stability_t pub;
+static NRU_TLS atomic_bool reset_pending;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static void clear_state(void) {
+    have_obs = false;
+    memset(buckets, 0, sizeof(buckets));
+    sum_busy_us = sum_seen_us = sum_busy_runs = 0;
+    idle_mean = idle_var = 0.0;
+    idle_runs = 0;
+}
+
+// Retire buckets that fell out of the horizon (at most NRU_STAB_BUCKETS)
+static void advance_buckets(uint64_t t_us) {
+    uint64_t idx = t_us / bucket_us;
+    if (idx <= bucket_idx)
+        return;
+    uint64_t steps = idx - bucket_idx;
+    if (steps > NRU_STAB_BUCKETS)
+        steps = NRU_STAB_BUCKETS;
+    for (uint64_t k = 1; k <= steps; k++) {
+        stab_bucket_t *b = &buckets[(bucket_idx + k) % NRU_STAB_BUCKETS];
+        sum_busy_us -= b->busy_us;
+        sum_seen_us -= b->seen_us;
+        sum_busy_runs -= b->busy_runs;
+        memset(b, 0, sizeof(*b));
+    }
+    bucket_idx = idx;
+}
+
+// Book [from, to) with state busy, split at bucket edges
+static void book_interval(uint64_t from, uint64_t to, bool busy) {
+    while (from < to) {
+        advance_buckets(from);
+        uint64_t edge = (from / bucket_us + 1) * bucket_us;
+        uint64_t end = to < edge ? to : edge;
+        stab_bucket_t *b = &buckets[bucket_idx % NRU_STAB_BUCKETS];
+        b->seen_us += end - from;
+        sum_seen_us += end - from;
+        if (busy) {
+            b->busy_us += end - from;
+            sum_busy_us += end - from;
+        }
+        from = end;
+    }
+}
+
+static void close_idle_run(uint64_t len_us) {
+    double x = (double)len_us;
+    if (idle_runs == 0) {
+        idle_mean = x;
+        idle_var = 0.0;
+    } else {
+        double d = x - idle_mean;
+        idle_mean += IDLE_RUN_EWMA_WEIGHT * d;
+        idle_var = (1.0 - IDLE_RUN_EWMA_WEIGHT) * (idle_var + IDLE_RUN_EWMA_WEIGHT * d * d);
+    }
+    idle_runs++;
+}
+
+static void publish(uint64_t now_us) {
+    // Rates over at least half a horizon, so a short history cannot look calm
+    const uint64_t horizon_us = (uint64_t)stab_cfg.horizon_ms * 1000ULL;
+    const uint64_t rate_span_us = sum_seen_us > horizon_us / 2 ? sum_seen_us : horizon_us / 2;
+
+    nru_seq_write_begin(&pub_seq);
+    pub.busy = cur_busy;
+    pub.state_since_us = run_start_us;
+    pub.updated_us = now_us;
+    pub.window_us = sum_seen_us;
+    pub.busy_fraction = sum_seen_us ? (double)sum_busy_us / sum_seen_us : 0.0;
+    pub.busy_runs_per_s = rate_span_us ? sum_busy_runs * 1e6 / (double)rate_span_us : 0.0;
+    pub.idle_run_mean_us = idle_mean;
+    pub.idle_run_std_us = sqrt(idle_var);
+    pub.idle_runs = idle_runs;
+    nru_seq_write_end(&pub_seq);
+}
+
+// ---------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------
+void nru_stability_configure(const nru_stability_cfg_t *cfg) {
+    if (cfg) {
+        stab_cfg.horizon_ms = cfg->horizon_ms ? cfg->horizon_ms : NRU_STAB_DEFAULT_HORIZON_MS;
+        stab_cfg.min_idle_us = cfg->min_idle_us ? cfg->min_idle_us : NRU_STAB_DEFAULT_MIN_IDLE_US;
+        stab_cfg.max_busy_per_s = cfg->max_busy_per_s > 0.0 ? cfg->max_busy_per_s
+                                                            : NRU_STAB_DEFAULT_MAX_BUSY_PER_S;
+        stab_cfg.max_busy_fraction = cfg->max_busy_fraction > 0.0 ? cfg->max_busy_fraction
+                                                                  : NRU_STAB_DEFAULT_MAX_BUSY_FRAC;
+    }
+    bucket_us = (uint64_t)stab_cfg.horizon_ms * 1000ULL / NRU_STAB_BUCKETS;
+    if (bucket_us == 0)
+        bucket_us = 1;
+    nru_stability_reset();
+}
+
+void nru_stability_observe(bool busy, uint64_t now_us) {
+    if (atomic_exchange_explicit(&reset_pending, false, memory_order_acq_rel))
+        clear_state();
+
+    if (!have_obs || now_us < last_us || now_us - last_us > NRU_STAB_MAX_GAP_US) {
+        // First sample or a silence we cannot vouch for: start a new run
+        have_obs = true;
+        cur_busy = busy;
+        run_start_us = now_us;
+        bucket_idx = now_us / bucket_us;
+        if (busy) {
+            buckets[bucket_idx % NRU_STAB_BUCKETS].busy_runs++;
+            sum_busy_runs++;
+        }
+    } else {
+        // The previous state held until now
+        book_interval(last_us, now_us, cur_busy);
+        advance_buckets(now_us);
+        if (busy != cur_busy) {
+            if (!cur_busy)
+                close_idle_run(now_us - run_start_us);
+            if (busy) {
+                buckets[bucket_idx % NRU_STAB_BUCKETS].busy_runs++;
+                sum_busy_runs++;
+            }
+            cur_busy = busy;
+            run_start_us = now_us;
+        }
+    }
+    last_us = now_us;
+    publish(now_us);
+}
+
+void nru_stability_reset(void) {
+    atomic_store_explicit(&reset_pending, true, memory_order_release);
+}
+
+// ---------------------------------------------------------------------
+// Readers (any thread)
+// ---------------------------------------------------------------------
+void nru_stability_get(nru_stability_t *out) {
+    uint32_t seq;
+    do {
+        seq = nru_seq_read_begin(&pub_seq);
+        *out = pub;
+    } while (nru_seq_read_retry(&pub_seq, seq));
+}
+
+uint64_t nru_stability_idle_run_us(uint64_t now_us) {
+    nru_stability_t s;
+    nru_stability_get(&s);
+    if (s.busy || s.updated_us == 0 || now_us < s.state_since_us ||
+        now_us - s.updated_us > NRU_STAB_MAX_GAP_US)
+        return 0;
+    return now_us - s.state_since_us;
+}
+
+static bool stable_in(const nru_stability_t *s) {
+    const uint64_t horizon_us = (uint64_t)stab_cfg.horizon_ms * 1000ULL;
+    return s->window_us >= horizon_us / 2 &&
+           s->busy_runs_per_s <= stab_cfg.max_busy_per_s &&
+           s->busy_fraction <= stab_cfg.max_busy_fraction;
+}
+
+bool nru_stability_channel_stable(void) {
+    nru_stability_t s;
+    nru_stability_get(&s);
+    return stable_in(&s);
+}
+
+bool nru_stability_ue_access_ok(uint64_t now_us) {
+    nru_stability_t s;
+    nru_stability_get(&s);
+    const uint64_t horizon_us = (uint64_t)stab_cfg.horizon_ms * 1000ULL;
+
+    // Too little history to judge (start-up, or observations sparser than
+    // NRU_STAB_MAX_GAP_US): only a fresh busy observation holds access back
+    if (s.window_us < horizon_us / 2)
+        return !(s.busy && s.updated_us && now_us >= s.updated_us &&
+                 now_us - s.updated_us <= NRU_STAB_MAX_GAP_US);
+    return stable_in(&s) && nru_stability_idle_run_us(now_us) >= stab_cfg.min_idle_us;
+}
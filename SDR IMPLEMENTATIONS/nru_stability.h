@@ -0,0 +1,110 @@
+/*
+ * NR-U Channel Stability Engine Header
+ * ------------------------------------
+ * Turns the busy/idle decisions of the LBT core into time-based
+ * statistics: length of the current idle run, mean/std of completed idle
+ * runs, and busy-run frequency and busy fraction over a sliding horizon.
+ * Each observation holds until the next one, so results do not depend on
+ * how often the LBT core is called. Updates are O(1) (bounded by the
+ * bucket count); reads are lock-free from any thread.
+ *
+ * Backs nru_lbt_is_stable_for_ue_access() and friends in nru_lbt.h.
+ *
+ * Location: common/utils/nru_stability.h
+ */
+
+#ifndef NRU_STABILITY_H
+#define NRU_STABILITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_STAB_BUCKETS           20        // Horizon split into this many buckets
+#define NRU_STAB_MAX_GAP_US        10000     // Longer silences restart the current run
+#define NRU_STAB_DEFAULT_HORIZON_MS  1000
+#define NRU_STAB_DEFAULT_MIN_IDLE_US 2000
+#define NRU_STAB_DEFAULT_MAX_BUSY_PER_S 100.0   // Wi-Fi beacons alone give ~10/s
+#define NRU_STAB_DEFAULT_MAX_BUSY_FRAC  0.3
+
+/**
+ * Stability criteria (0 fields take the defaults above)
+ */
+typedef struct {
+    uint32_t horizon_ms;               // Sliding window for rates and fractions
+    uint32_t min_idle_us;              // Idle run required for UE access
+    double max_busy_per_s;             // Busy runs started per second
+    double max_busy_fraction;          // Busy time / observed time
+} nru_stability_cfg_t;
+
+/**
+ * Published statistics
+ */
+typedef struct {
+    bool busy;                         // State of the latest observation
+    uint64_t state_since_us;           // Start of the current run
+    uint64_t updated_us;               // Latest observation
+    uint64_t window_us;                // Observed time inside the horizon
+    double busy_fraction;
+    double busy_runs_per_s;
+    double idle_run_mean_us;           // EWMA over completed idle runs
+    double idle_run_std_us;
+    uint64_t idle_runs;                // Completed idle runs since reset
+} nru_stability_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Set criteria and horizon (resets the statistics)
+ */
+void nru_stability_configure(const nru_stability_cfg_t *cfg);
+
+/**
+ * Feed one busy/idle decision (single writer: the LBT caller)
+ * @param busy: Channel state seen at now_us
+ * @param now_us: nru_clock time of the decision
+ */
+void nru_stability_observe(bool busy, uint64_t now_us);
+
+/**
+ * Read the latest statistics
+ */
+void nru_stability_get(nru_stability_t *out);
+
+/**
+ * Length of the current idle run at now_us (0 while busy or unknown)
+ */
+uint64_t nru_stability_idle_run_us(uint64_t now_us);
+
+/**
+ * Horizon statistics within the configured limits (enough data, few
+ * busy runs, low busy fraction)
+ */
+bool nru_stability_channel_stable(void);
+
+/**
+ * Stable channel and an idle run of at least min_idle_us right now; with
+ * less than half a horizon observed, true unless the latest observation
+ * was busy
+ */
+bool nru_stability_ue_access_ok(uint64_t now_us);
+
+/**
+ * Clear statistics (applied by the writer at its next observation)
+ */
+void nru_stability_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_STABILITY_H */
@@ -0,0 +1,480 @@
+/*
+ * NR-U Coexistence Timeline
+ * -------------------------
+ * Puts the three records of a coexistence run on one time axis:
+ *   - iPerf3 server logs (results/, e.g. LBTserver_TCP500.txt), UTF-16 as
+ *     saved by PowerShell or plain ASCII, one row per reporting interval
+ *   - the LBT trace written with log_lbt (/tmp/nru_logs/lbt_log.csv):
+ *     one row per LBE/FBE/DRS outcome, FREE rows carry the COT they opened
+ *   - the scheduler's NR-U events from the gNB log
+ *     ("[NRU][SCHED] Frame F Slot S: Channel BUSY ..."), SFN unwrapped
+ *
+ * For every iPerf interval it reports the fraction of time covered by
+ * NR-U COTs (union of grants), the LBT busy fraction and the number of
+ * slots the scheduler skipped. Intervals are then grouped by COT
+ * occupancy and the Wi-Fi throughput dip is given per group, relative to
+ * the median throughput of intervals with (almost) no NR-U activity.
+ *
+ * Alignment: iPerf intervals are relative to each test's start and the
+ * gNB log only has frame/slot, so both are anchored to the first LBT
+ * row unless --iperf-start-us / --sched-start-us give the nru_clock time
+ * of their origin. Several tests in one log follow each other.
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 nru_timeline.cpp -o nru_timeline
+ *
+ * Example:
+ *   ./nru_timeline --lbt /tmp/nru_logs/lbt_log.csv --sched gnb.log \
+ *       --iperf-offset-s 2.5 -o timeline.csv results/LBTserver_TCP500.txt
+ *
+ * Author: Integration for OAI NR-U Makhubela Innocent(MKHINN011)
+ * Date: 2025
+ */
+
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+struct TimelineParams {
+    std::vector<std::string> iperf;
+    std::string lbt;
+    std::string sched;
+    int64_t iperf_start_us = -1;       // -1 = first LBT row
+    double iperf_offset_s = 0.0;
+    int64_t sched_start_us = -1;       // -1 = first LBT row
+    int slots_per_frame = 20;          // 30 kHz SCS
+    double low_cot = 0.05;             // Baseline: intervals below this COT fraction
+    double dip_pct = 20.0;             // A dip is a drop of at least this much
+    std::string output = "timeline.csv";
+};
+
+// COT occupancy groups of the summary (upper bounds)
+static const double COT_GROUPS[] = {0.05, 0.25, 0.5, 1.0 + 1e-9};
+static const int N_COT_GROUPS = sizeof(COT_GROUPS) / sizeof(COT_GROUPS[0]);
+
+/* ============================================
+ *  INPUT DECODING
+ * ============================================ */
+
+static bool read_file(const std::string &path, std::string &out) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        perror(path.c_str());
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(n > 0 ? static_cast<size_t>(n) : 0);
+    size_t got = out.empty() ? 0 : fread(&out[0], 1, out.size(), f);
+    fclose(f);
+    out.resize(got);
+    return true;
+}
+
+// UTF-16 (BOM or NUL pattern) to ASCII; iPerf output is ASCII only
+static std::string to_ascii(const std::string &raw) {
+    const auto *b = reinterpret_cast<const unsigned char *>(raw.data());
+    const size_t n = raw.size();
+    bool le = n >= 2 && b[0] == 0xFF && b[1] == 0xFE;
+    bool be = n >= 2 && b[0] == 0xFE && b[1] == 0xFF;
+    size_t start = (le || be) ? 2 : 0;
+    if (!le && !be && n >= 4) {
+        le = b[1] == 0 && b[3] == 0 && b[0] != 0;
+        be = b[0] == 0 && b[2] == 0 && b[1] != 0;
+    }
+    if (!le && !be) {
+        start = (n >= 3 && b[0] == 0xEF && b[1] == 0xBB && b[2] == 0xBF) ? 3 : 0;
+        return raw.substr(start);
+    }
+
+    std::string out;
+    out.reserve(n / 2);
+    for (size_t k = start; k + 1 < n; k += 2) {
+        const unsigned cu = le ? (b[k] | (b[k + 1] << 8)) : ((b[k] << 8) | b[k + 1]);
+        out.push_back(cu < 0x80 ? static_cast<char>(cu) : '?');
+    }
+    return out;
+}
+
+template <typename Fn>
+static void for_each_line(const std::string &text, Fn fn) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string::npos) end = text.size();
+        size_t len = end - pos;
+        if (len && text[pos + len - 1] == '\r') len--;
+        fn(text.c_str() + pos, len);
+        pos = end + 1;
+    }
+}
+
+/* ============================================
+ *  IPERF3 LOGS
+ * ============================================ */
+
+struct IperfInterval {
+    size_t file;
+    int test;
+    double t0_s, t1_s;                 // Relative to the test start
+    double mbps;
+    double jitter_ms;                  // UDP only, NAN otherwise
+    long lost, total;                  // UDP only, -1 otherwise
+};
+
+static double to_mbps(double v, const char *unit) {
+    switch (unit[0]) {
+        case 'G': return v * 1e3;
+        case 'M': return v;
+        case 'K': return v * 1e-3;
+        default:  return v * 1e-6;     // bits/sec
+    }
+}
+
+static void parse_iperf(const std::string &text, size_t file, std::vector<IperfInterval> &out) {
+    int test = -1;
+    bool in_summary = false;
+    double test_base_s = 0.0, last_end_s = 0.0;
+    for_each_line(text, [&](const char *s, size_t len) {
+        std::string line(s, len);
+        if (line.find("Accepted connection") != std::string::npos) {
+            test++;
+            test_base_s = last_end_s;               // Tests follow each other
+            in_summary = false;
+            return;
+        }
+        if (line.rfind("- - -", 0) == 0) {
+            in_summary = true;                      // Per-test totals follow
+            return;
+        }
+        if (in_summary || line.empty() || line[0] != '[' || test < 0)
+            return;
+
+        double t0, t1, xfer, rate;
+        char xunit[16], runit[16];
+        int used = 0;
+        if (sscanf(line.c_str(), "[%*[^]]] %lf-%lf sec %lf %15s %lf %15s%n",
+                   &t0, &t1, &xfer, xunit, &rate, runit, &used) != 6)
+            return;
+        if (strstr(runit, "/sec") == nullptr)
+            return;
+
+        IperfInterval iv;
+        iv.file = file;
+        iv.test = test;
+        iv.t0_s = test_base_s + t0;
+        iv.t1_s = test_base_s + t1;
+        iv.mbps = to_mbps(rate, runit);
+        iv.jitter_ms = NAN;
+        iv.lost = iv.total = -1;
+        double jitter;
+        long lost, total;
+        if (sscanf(line.c_str() + used, " %lf ms %ld/%ld", &jitter, &lost, &total) == 3) {
+            iv.jitter_ms = jitter;
+            iv.lost = lost;
+            iv.total = total;
+        }
+        out.push_back(iv);
+        last_end_s = std::max(last_end_s, iv.t1_s);
+    });
+}
+
+/* ============================================
+ *  LBT TRACE AND SCHEDULER EVENTS
+ * ============================================ */
+
+struct LbtTrace {
+    std::vector<uint64_t> t_us;                    // Every decision, sorted
+    std::vector<uint32_t> busy_prefix;             // BUSY decisions, size + 1
+    std::vector<std::pair<uint64_t, uint64_t>> cots;  // Union of COTs, sorted
+    std::vector<uint64_t> cot_prefix;              // Covered us before cots[k]
+};
+
+static bool load_lbt(const std::string &path, uint64_t default_cot_us, LbtTrace &tr) {
+    std::string text;
+    if (!read_file(path, text))
+        return false;
+    std::vector<std::pair<uint64_t, uint64_t>> grants;
+    std::vector<std::pair<uint64_t, bool>> rows;
+    for_each_line(text, [&](const char *s, size_t len) {
+        if (!len || s[0] < '0' || s[0] > '9')
+            return;                                 // Header
+        std::string line(s, len);
+        unsigned long long t, cot = 0;
+        float e, thr;
+        char status[8], mode[8];
+        int n = sscanf(line.c_str(), "%llu,%f,%f,%7[^,],%7[^,],%llu", &t, &e, &thr, status, mode, &cot);
+        if (n < 5)
+            return;
+        const bool free = strcmp(status, "FREE") == 0;
+        rows.emplace_back(t, !free);
+        if (free) {
+            if (n < 6) cot = default_cot_us;
+            if (cot) grants.emplace_back(t, t + cot);
+        }
+    });
+
+    std::sort(rows.begin(), rows.end());
+    tr.t_us.reserve(rows.size());
+    tr.busy_prefix.assign(1, 0);
+    for (const auto &r : rows) {
+        tr.t_us.push_back(r.first);
+        tr.busy_prefix.push_back(tr.busy_prefix.back() + (r.second ? 1 : 0));
+    }
+
+    std::sort(grants.begin(), grants.end());
+    for (const auto &g : grants) {
+        if (!tr.cots.empty() && g.first <= tr.cots.back().second)
+            tr.cots.back().second = std::max(tr.cots.back().second, g.second);
+        else
+            tr.cots.push_back(g);
+    }
+    tr.cot_prefix.assign(1, 0);
+    for (const auto &c : tr.cots)
+        tr.cot_prefix.push_back(tr.cot_prefix.back() + (c.second - c.first));
+
+    printf("[NRU][TIMELINE] %s: %zu decisions, %zu COTs\n", path.c_str(), tr.t_us.size(), tr.cots.size());
+    return true;
+}
+
+// Time covered by COTs in [a, b)
+static uint64_t cot_overlap(const LbtTrace &tr, uint64_t a, uint64_t b) {
+    auto cover_before = [&](uint64_t t) {
+        // Whole COTs ending before t, plus the part of the one containing t
+        size_t k = std::upper_bound(tr.cots.begin(), tr.cots.end(), std::make_pair(t, UINT64_MAX)) - tr.cots.begin();
+        uint64_t c = tr.cot_prefix[k];
+        if (k > 0 && tr.cots[k - 1].second > t)
+            c -= tr.cots[k - 1].second - t;
+        return c;
+    };
+    return b > a ? cover_before(b) - cover_before(a) : 0;
+}
+
+// Skipped slots from the gNB log, SFN (10.24 s) unwrapped
+static bool load_sched(const std::string &path, int slots_per_frame, std::vector<uint64_t> &rel_us) {
+    std::string text;
+    if (!read_file(path, text))
+        return false;
+    text = to_ascii(text);
+    const double slot_us = 10000.0 / slots_per_frame;
+    int64_t wraps = 0;
+    int last_frame = -1;
+    for_each_line(text, [&](const char *s, size_t len) {
+        std::string line(s, len);
+        size_t at = line.find("[NRU][SCHED]");
+        if (at == std::string::npos || line.find("BUSY", at) == std::string::npos)
+            return;
+        int frame, slot;
+        if (sscanf(line.c_str() + at, "[NRU][SCHED] Frame %d Slot %d", &frame, &slot) != 2)
+            return;
+        if (last_frame >= 0 && frame < last_frame)
+            wraps++;
+        last_frame = frame;
+        const double t = (wraps * 1024.0 + frame) * 10000.0 + slot * slot_us;
+        rel_us.push_back(static_cast<uint64_t>(t));
+    });
+    std::sort(rel_us.begin(), rel_us.end());
+    printf("[NRU][TIMELINE] %s: %zu skipped slots\n", path.c_str(), rel_us.size());
+    return true;
+}
+
+static size_t count_in(const std::vector<uint64_t> &v, uint64_t a, uint64_t b) {
+    return std::lower_bound(v.begin(), v.end(), b) - std::lower_bound(v.begin(), v.end(), a);
+}
+
+/* ============================================
+ *  DIP REPORT
+ * ============================================ */
+
+static void report_dips(const TimelineParams &p, const std::vector<IperfInterval> &ivs,
+                        const std::vector<double> &cot_frac, size_t file) {
+    auto in_file = [&](size_t k) { return ivs[k].file == file && !std::isnan(cot_frac[k]); };
+
+    std::vector<double> base;
+    for (size_t k = 0; k < ivs.size(); k++)
+        if (in_file(k) && cot_frac[k] < p.low_cot)
+            base.push_back(ivs[k].mbps);
+    if (base.empty())
+        for (size_t k = 0; k < ivs.size(); k++)
+            if (in_file(k))
+                base.push_back(ivs[k].mbps);
+    if (base.empty()) {
+        printf("[NRU][TIMELINE] %s: no interval overlaps the LBT trace (check alignment)\n",
+               p.iperf[file].c_str());
+        return;
+    }
+    std::nth_element(base.begin(), base.begin() + base.size() / 2, base.end());
+    const double baseline = base[base.size() / 2];
+
+    printf("[NRU][TIMELINE] %s: Wi-Fi baseline %.2f Mbit/s (median, COT < %.0f%%)\n",
+           p.iperf[file].c_str(), baseline, p.low_cot * 100.0);
+    printf("[NRU][TIMELINE]   COT occupancy   intervals   mean Mbit/s   mean dip   dips >= %.0f%%\n", p.dip_pct);
+    double lo = 0.0;
+    for (int g = 0; g < N_COT_GROUPS; g++) {
+        const double hi = COT_GROUPS[g];
+        size_t n = 0, dips = 0;
+        double sum = 0.0;
+        for (size_t k = 0; k < ivs.size(); k++) {
+            if (!in_file(k) || cot_frac[k] < lo || cot_frac[k] >= hi)
+                continue;
+            n++;
+            sum += ivs[k].mbps;
+            if (baseline > 0.0 && ivs[k].mbps <= baseline * (1.0 - p.dip_pct / 100.0))
+                dips++;
+        }
+        const double mean = n ? sum / n : NAN;
+        printf("[NRU][TIMELINE]   %3.0f%% - %3.0f%%     %9zu   %11.2f   %7.1f%%   %9.1f%%\n",
+               lo * 100.0, std::min(hi, 1.0) * 100.0, n, mean,
+               (n && baseline > 0.0) ? 100.0 * (1.0 - mean / baseline) : NAN,
+               n ? 100.0 * dips / n : NAN);
+        lo = hi;
+    }
+}
+
+/* ============================================
+ *  COMMAND LINE
+ * ============================================ */
+
+static void usage(const char *prog) {
+    printf("Usage: %s [OPTIONS] IPERF_LOG...\n"
+           "      --lbt FILE             LBT trace (lbt_log.csv)\n"
+           "      --sched FILE           gNB log with [NRU][SCHED] events\n"
+           "      --iperf-start-us T     nru_clock time of iPerf t=0 (default: first LBT row)\n"
+           "      --iperf-offset-s S     Shift iPerf intervals by S seconds (default 0)\n"
+           "      --sched-start-us T     nru_clock time of frame 0 slot 0 (default: first LBT row)\n"
+           "      --slots-per-frame N    Scheduler numerology (default 20)\n"
+           "      --mcot-ms N            COT of FREE rows without cot_us (default 8)\n"
+           "      --low-cot F            Baseline intervals: COT fraction below F (default 0.05)\n"
+           "      --dip-pct P            Count drops of at least P%% as dips (default 20)\n"
+           "  -o, --output FILE          Per-interval CSV (default timeline.csv)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    TimelineParams p;
+    int mcot_ms = 8;
+    enum { OPT_LBT = 256, OPT_SCHED, OPT_ISTART, OPT_IOFF, OPT_SSTART, OPT_SPF, OPT_MCOT, OPT_LOW, OPT_DIP };
+    static const struct option opts[] = {
+        {"lbt", required_argument, nullptr, OPT_LBT},
+        {"sched", required_argument, nullptr, OPT_SCHED},
+        {"iperf-start-us", required_argument, nullptr, OPT_ISTART},
+        {"iperf-offset-s", required_argument, nullptr, OPT_IOFF},
+        {"sched-start-us", required_argument, nullptr, OPT_SSTART},
+        {"slots-per-frame", required_argument, nullptr, OPT_SPF},
+        {"mcot-ms", required_argument, nullptr, OPT_MCOT},
+        {"low-cot", required_argument, nullptr, OPT_LOW},
+        {"dip-pct", required_argument, nullptr, OPT_DIP},
+        {"output", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "o:h", opts, nullptr)) != -1) {
+        switch (c) {
+            case OPT_LBT: p.lbt = optarg; break;
+            case OPT_SCHED: p.sched = optarg; break;
+            case OPT_ISTART: p.iperf_start_us = atoll(optarg); break;
+            case OPT_IOFF: p.iperf_offset_s = atof(optarg); break;
+            case OPT_SSTART: p.sched_start_us = atoll(optarg); break;
+            case OPT_SPF: p.slots_per_frame = atoi(optarg); break;
+            case OPT_MCOT: mcot_ms = atoi(optarg); break;
+            case OPT_LOW: p.low_cot = atof(optarg); break;
+            case OPT_DIP: p.dip_pct = atof(optarg); break;
+            case 'o': p.output = optarg; break;
+            case 'h': usage(argv[0]); return 0;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    for (int i = optind; i < argc; i++)
+        p.iperf.push_back(argv[i]);
+    if (p.iperf.empty() || p.slots_per_frame <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const auto t_begin = std::chrono::steady_clock::now();
+
+    std::vector<IperfInterval> ivs;
+    for (size_t i = 0; i < p.iperf.size(); i++) {
+        std::string raw;
+        if (!read_file(p.iperf[i], raw))
+            return 1;
+        const size_t before = ivs.size();
+        parse_iperf(to_ascii(raw), i, ivs);
+        printf("[NRU][TIMELINE] %s: %zu intervals\n", p.iperf[i].c_str(), ivs.size() - before);
+    }
+
+    LbtTrace lbt;
+    const bool have_lbt = !p.lbt.empty();
+    if (have_lbt && !load_lbt(p.lbt, static_cast<uint64_t>(std::max(0, mcot_ms)) * 1000ULL, lbt))
+        return 1;
+    const uint64_t origin = (have_lbt && !lbt.t_us.empty()) ? lbt.t_us.front() : 0;
+
+    std::vector<uint64_t> skipped;
+    if (!p.sched.empty() && !load_sched(p.sched, p.slots_per_frame, skipped))
+        return 1;
+    const uint64_t sched_base = p.sched_start_us >= 0 ? static_cast<uint64_t>(p.sched_start_us) : origin;
+    for (auto &t : skipped)
+        t += sched_base;
+
+    const double iperf_base = (p.iperf_start_us >= 0 ? static_cast<double>(p.iperf_start_us)
+                                                     : static_cast<double>(origin)) +
+                              p.iperf_offset_s * 1e6;
+
+    // Per-interval correlation
+    FILE *f = fopen(p.output.c_str(), "w");
+    if (!f) {
+        perror(p.output.c_str());
+        return 1;
+    }
+    fprintf(f, "log,test,start_us,end_us,wifi_mbps,jitter_ms,lost,total,"
+               "nru_cot_frac,lbt_decisions,lbt_busy_frac,sched_skipped_slots\n");
+
+    std::vector<double> cot_frac(ivs.size(), NAN);
+    for (size_t k = 0; k < ivs.size(); k++) {
+        const IperfInterval &iv = ivs[k];
+        const double a_d = iperf_base + iv.t0_s * 1e6;
+        const double b_d = iperf_base + iv.t1_s * 1e6;
+        const uint64_t a = a_d > 0 ? static_cast<uint64_t>(a_d) : 0;
+        const uint64_t b = b_d > 0 ? static_cast<uint64_t>(b_d) : 0;
+
+        size_t decisions = 0;
+        double busy_frac = NAN;
+        if (have_lbt && b > a) {
+            const size_t i0 = std::lower_bound(lbt.t_us.begin(), lbt.t_us.end(), a) - lbt.t_us.begin();
+            const size_t i1 = std::lower_bound(lbt.t_us.begin(), lbt.t_us.end(), b) - lbt.t_us.begin();
+            decisions = i1 - i0;
+            if (decisions)
+                busy_frac = static_cast<double>(lbt.busy_prefix[i1] - lbt.busy_prefix[i0]) / decisions;
+            cot_frac[k] = static_cast<double>(cot_overlap(lbt, a, b)) / (b - a);
+        }
+
+        fprintf(f, "%s,%d,%llu,%llu,%.3f,%.3f,%ld,%ld,%.4f,%zu,%.4f,%zu\n",
+                p.iperf[iv.file].c_str(), iv.test, (unsigned long long)a, (unsigned long long)b,
+                iv.mbps, iv.jitter_ms, iv.lost, iv.total, cot_frac[k], decisions, busy_frac,
+                skipped.empty() ? 0 : count_in(skipped, a, b));
+    }
+    fclose(f);
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_begin).count();
+    printf("[NRU][TIMELINE] Wrote %zu intervals to %s in %.3f s\n", ivs.size(), p.output.c_str(), elapsed);
+    if (!have_lbt)
+        return 0;
+
+    // Throughput dips conditioned on COT occupancy, per log (each has its own rate)
+    for (size_t file = 0; file < p.iperf.size(); file++)
+        report_dips(p, ivs, cot_frac, file);
+    return 0;
+}
@@ -0,0 +1,506 @@
+/*
+ * NR-U IQ Trace Analyzer
+ * ----------------------
+ * Offline occupancy report for large field captures:
+ *   - busy fraction, burst starts and noise floor per time bin
+ *   - busy-burst duration histogram (log2 bins in us)
+ *   - per-technology burst counts and Wi-Fi L-STF preamble counts
+ *
+ * The capture is memory-mapped with sequential readahead and split into
+ * chunks of whole reduction blocks. Chunks run on a work-stealing pool:
+ * each worker owns a contiguous range of chunks and takes from the far
+ * end of another worker's range once its own is empty. Every chunk is
+ * reduced with the runtime kernels (nru_dsp.cpp) and bursts are
+ * classified with the runtime detector (nru_classifier.cpp).
+ *
+ * A burst that crosses chunk boundaries is stitched afterwards from each
+ * chunk's leading and trailing busy runs, so durations do not depend on
+ * the chunk size. Bursts are classified and counted by the chunk they
+ * start in (a worker looks one block back, and past its chunk end for
+ * the analysis span).
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 -DNRU_LBT_STANDALONE nru_trace_analyzer.cpp nru_dsp.cpp nru_classifier.cpp \
+ *       -lpthread -o nru_trace_analyzer
+ *
+ * Example:
+ *   ./nru_trace_analyzer --rate 23.04 --format sc16 --cal-offset -30 \
+ *       --ed-dbm -72 --bin-ms 100 -o capture1 capture1.dat
+ *
+ * Author: Integration for OAI NR-U Makhubela Innocent(MKHINN011)
+ * Date: 2025
+ */
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nru_dsp.h"
+#include "nru_classifier.h"
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+static const int HIST_BINS = 32;                   // Bin k holds [2^k, 2^(k+1)) us, bin 0 [0, 2)
+static const size_t CLS_MAX_SAMPLES = 16384;       // Matches NRU_CLS_MAX_SAMPLES
+
+struct AnalyzerParams {
+    std::string trace;
+    bool sc16 = true;
+    double rate_msps = 0.0;
+    double block_us = 1.0;
+    double cal_offset_db = 0.0;        // dBm = dBFS + offset
+    double ed_dbm = -72.0;             // Busy threshold
+    double bin_ms = 100.0;             // Time bin of the occupancy report
+    double chunk_mb = 64.0;
+    int threads = 0;
+    std::string output = "trace_analysis";
+};
+
+/* ============================================
+ *  MAPPED TRACE
+ * ============================================ */
+
+struct Trace {
+    const uint8_t *base = nullptr;
+    size_t bytes = 0;
+    size_t sample_bytes = 0;
+    size_t n_samples = 0;
+    size_t block_len = 1;
+    size_t n_blocks = 0;
+    bool sc16 = true;
+
+    const void *at(size_t sample) const { return base + sample * sample_bytes; }
+
+    size_t block_power(size_t first_block, size_t n, float *out) const {
+        const size_t s = first_block * block_len;
+        if (sc16)
+            return nru_block_power_sc16(static_cast<const int16_t *>(at(s)), n * block_len, block_len, out);
+        return nru_block_power_fc32(static_cast<const float *>(at(s)), n * block_len, block_len, out);
+    }
+
+    // Samples as float I/Q (sc16 converted into buf)
+    const float *fc32(size_t sample, size_t n, std::vector<float> &buf) const {
+        if (!sc16)
+            return static_cast<const float *>(at(sample));
+        buf.resize(2 * n);
+        const int16_t *iq = static_cast<const int16_t *>(at(sample));
+        for (size_t k = 0; k < 2 * n; k++)
+            buf[k] = iq[k] * (1.0f / 32768.0f);
+        return buf.data();
+    }
+};
+
+// Page-aligned madvise over a byte range of the mapping
+static void advise(const Trace &tr, size_t off, size_t len, int advice) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t a = off / page * page;
+    const size_t b = std::min(tr.bytes, off + len);
+    if (b > a)
+        madvise(const_cast<uint8_t *>(tr.base) + a, b - a, advice);
+}
+
+/* ============================================
+ *  CHUNK ANALYSIS
+ * ============================================ */
+
+struct ChunkResult {
+    size_t first_block = 0;
+    size_t n_blocks = 0;
+    bool all_busy = false;
+    size_t lead = 0;                   // Busy blocks at the chunk start
+    size_t trail = 0;                  // Busy blocks open at the chunk end
+    uint64_t hist[HIST_BINS] = {};     // Runs entirely inside the chunk
+
+    size_t first_bin = 0;
+    std::vector<uint64_t> busy;        // Per time bin
+    std::vector<double> idle_pow;
+    std::vector<uint64_t> idle_blocks;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> preambles;
+
+    uint64_t tech[NRU_TECH_COUNT] = {};
+};
+
+static int hist_bin(double us) {
+    int k = 0;
+    while (k < HIST_BINS - 1 && us >= static_cast<double>(2ULL << k))
+        k++;
+    return k;
+}
+
+struct Analyzer {
+    const AnalyzerParams &p;
+    const Trace &tr;
+    float thr_lin;
+    size_t bin_blocks;
+
+    Analyzer(const AnalyzerParams &params, const Trace &trace)
+        : p(params), tr(trace),
+          thr_lin(std::pow(10.0f, static_cast<float>((params.ed_dbm - params.cal_offset_db) / 10.0))),
+          bin_blocks(std::max<size_t>(1, static_cast<size_t>(std::llround(params.bin_ms * 1000.0 / params.block_us)))) {}
+
+    // Extend a busy run past the chunk end, up to the classifier's span
+    size_t open_run_blocks(size_t next_block, size_t have) const {
+        const size_t cap = (CLS_MAX_SAMPLES + tr.block_len - 1) / tr.block_len;
+        if (have >= cap || next_block >= tr.n_blocks)
+            return have;
+        const size_t n = std::min(cap - have, tr.n_blocks - next_block);
+        std::vector<float> pw(n);
+        tr.block_power(next_block, n, pw.data());
+        size_t k = 0;
+        while (k < n && pw[k] >= thr_lin)
+            k++;
+        return have + k;
+    }
+
+    void classify(ChunkResult &r, size_t g_start, size_t run_blocks, std::vector<float> &buf) const {
+        const size_t n = std::min(run_blocks * tr.block_len, CLS_MAX_SAMPLES);
+        bool preamble = false;
+        const nru_tech_t tech = nru_classify_burst(tr.fc32(g_start * tr.block_len, n, buf), n,
+                                                   g_start > 0, nullptr, &preamble);
+        r.tech[tech]++;
+        const size_t bin = g_start / bin_blocks - r.first_bin;
+        r.starts[bin]++;
+        if (preamble)
+            r.preambles[bin]++;
+    }
+
+    void run(size_t first_block, size_t n_blocks, ChunkResult &r) const {
+        static thread_local std::vector<float> power;
+        static thread_local std::vector<float> buf;
+        if (power.size() < n_blocks)
+            power.resize(n_blocks);
+
+        const size_t off = first_block * tr.block_len * tr.sample_bytes;
+        const size_t len = n_blocks * tr.block_len * tr.sample_bytes;
+        advise(tr, off, len, MADV_WILLNEED);
+        tr.block_power(first_block, n_blocks, power.data());
+
+        r.first_block = first_block;
+        r.n_blocks = n_blocks;
+        r.first_bin = first_block / bin_blocks;
+        const size_t n_bins = (first_block + n_blocks - 1) / bin_blocks - r.first_bin + 1;
+        r.busy.assign(n_bins, 0);
+        r.idle_pow.assign(n_bins, 0.0);
+        r.idle_blocks.assign(n_bins, 0);
+        r.starts.assign(n_bins, 0);
+        r.preambles.assign(n_bins, 0);
+
+        for (size_t b = 0; b < n_blocks; b++) {
+            const size_t bin = (first_block + b) / bin_blocks - r.first_bin;
+            if (power[b] >= thr_lin) {
+                r.busy[bin]++;
+            } else {
+                r.idle_pow[bin] += power[b];
+                r.idle_blocks[bin]++;
+            }
+        }
+
+        // Does a run at block 0 start here or continue from the previous chunk?
+        bool prev_busy = false;
+        if (first_block > 0) {
+            float pw;
+            tr.block_power(first_block - 1, 1, &pw);
+            prev_busy = pw >= thr_lin;
+        }
+
+        size_t b = 0;
+        while (b < n_blocks) {
+            if (power[b] < thr_lin) { b++; continue; }
+            const size_t a = b;
+            while (b < n_blocks && power[b] >= thr_lin)
+                b++;
+            const size_t len_blocks = b - a;
+
+            if (a == 0 && b == n_blocks) {
+                r.all_busy = true;
+                r.lead = r.trail = n_blocks;
+            } else if (a == 0) {
+                r.lead = len_blocks;
+            } else if (b == n_blocks) {
+                r.trail = len_blocks;
+            } else {
+                r.hist[hist_bin(len_blocks * p.block_us)]++;
+            }
+
+            if (a > 0 || !prev_busy) {
+                const size_t span = (b == n_blocks) ? open_run_blocks(first_block + b, len_blocks)
+                                                    : len_blocks;
+                classify(r, first_block + a, span, buf);
+            }
+        }
+
+        advise(tr, off, len, MADV_DONTNEED);
+    }
+};
+
+/* ============================================
+ *  WORK-STEALING POOL
+ * ============================================ */
+
+// Each worker pops its own range from the front and steals from the back
+// of others, so neighbouring chunks stay on one core while loads balance.
+class StealPool {
+public:
+    StealPool(size_t n_tasks, unsigned int n_workers) : queues_(n_workers) {
+        const size_t per = (n_tasks + n_workers - 1) / n_workers;
+        for (unsigned int w = 0; w < n_workers; w++)
+            for (size_t t = w * per; t < std::min(n_tasks, (w + 1) * per); t++)
+                queues_[w].tasks.push_back(t);
+    }
+
+    template <typename Fn>
+    void run(Fn fn) {
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < queues_.size(); w++)
+            threads.emplace_back([this, w, &fn]() {
+                size_t task;
+                while (next(w, task))
+                    fn(task);
+            });
+        for (auto &t : threads)
+            t.join();
+    }
+
+    size_t steals() const { return steals_.load(); }
+
+private:
+    struct Queue {
+        std::mutex mtx;
+        std::deque<size_t> tasks;
+    };
+
+    bool next(size_t self, size_t &task) {
+        {
+            std::lock_guard<std::mutex> lk(queues_[self].mtx);
+            if (!queues_[self].tasks.empty()) {
+                task = queues_[self].tasks.front();
+                queues_[self].tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues_.size(); k++) {
+            Queue &victim = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lk(victim.mtx);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<Queue> queues_;
+    std::atomic<size_t> steals_{0};
+};
+
+/* ============================================
+ *  COMMAND LINE
+ * ============================================ */
+
+static void usage(const char *prog) {
+    printf("Usage: %s [OPTIONS] TRACE\n"
+           "      --rate MSPS          Capture sample rate (required)\n"
+           "      --format sc16|fc32   Sample format (default sc16)\n"
+           "      --block-us X         Reduction block length (default 1)\n"
+           "      --cal-offset DB      dBm = dBFS + offset (default 0)\n"
+           "      --ed-dbm X           Busy threshold (default -72)\n"
+           "      --bin-ms X           Occupancy report bin (default 100)\n"
+           "      --chunk-mb X         Work unit size (default 64)\n"
+           "  -j, --threads N          Worker threads (default: all cores)\n"
+           "  -o, --output PREFIX      Writes PREFIX_occupancy.csv and PREFIX_bursts.csv\n"
+           "                           (default trace_analysis)\n", prog);
+}
+
+int main(int argc, char **argv) {
+    AnalyzerParams p;
+    enum { OPT_RATE = 256, OPT_FORMAT, OPT_BLOCK, OPT_CAL, OPT_ED, OPT_BIN, OPT_CHUNK };
+    static const struct option opts[] = {
+        {"rate", required_argument, nullptr, OPT_RATE},
+        {"format", required_argument, nullptr, OPT_FORMAT},
+        {"block-us", required_argument, nullptr, OPT_BLOCK},
+        {"cal-offset", required_argument, nullptr, OPT_CAL},
+        {"ed-dbm", required_argument, nullptr, OPT_ED},
+        {"bin-ms", required_argument, nullptr, OPT_BIN},
+        {"chunk-mb", required_argument, nullptr, OPT_CHUNK},
+        {"threads", required_argument, nullptr, 'j'},
+        {"output", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "j:o:h", opts, nullptr)) != -1) {
+        switch (c) {
+            case OPT_RATE: p.rate_msps = atof(optarg); break;
+            case OPT_FORMAT: p.sc16 = (std::string(optarg) != "fc32"); break;
+            case OPT_BLOCK: p.block_us = atof(optarg); break;
+            case OPT_CAL: p.cal_offset_db = atof(optarg); break;
+            case OPT_ED: p.ed_dbm = atof(optarg); break;
+            case OPT_BIN: p.bin_ms = atof(optarg); break;
+            case OPT_CHUNK: p.chunk_mb = atof(optarg); break;
+            case 'j': p.threads = atoi(optarg); break;
+            case 'o': p.output = optarg; break;
+            case 'h': usage(argv[0]); return 0;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind + 1 != argc || p.rate_msps <= 0.0 || p.block_us <= 0.0 ||
+        p.bin_ms <= 0.0 || p.chunk_mb <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+    p.trace = argv[optind];
+
+    int fd = open(p.trace.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror(p.trace.c_str());
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "[NRU][ANALYZE] %s: empty or unreadable\n", p.trace.c_str());
+        close(fd);
+        return 1;
+    }
+
+    Trace tr;
+    tr.bytes = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, tr.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    madvise(map, tr.bytes, MADV_SEQUENTIAL);
+
+    tr.base = static_cast<const uint8_t *>(map);
+    tr.sc16 = p.sc16;
+    tr.sample_bytes = p.sc16 ? 2 * sizeof(int16_t) : 2 * sizeof(float);
+    tr.n_samples = tr.bytes / tr.sample_bytes;
+    tr.block_len = std::max<size_t>(1, static_cast<size_t>(std::lround(p.rate_msps * p.block_us)));
+    tr.n_blocks = tr.n_samples / tr.block_len;
+    if (tr.n_blocks == 0) {
+        fprintf(stderr, "[NRU][ANALYZE] %s: shorter than one block\n", p.trace.c_str());
+        munmap(map, tr.bytes);
+        return 1;
+    }
+
+    nru_classifier_configure(p.rate_msps * 1e6);
+
+    const size_t chunk_blocks = std::max<size_t>(
+        1, static_cast<size_t>(p.chunk_mb * 1048576.0) / (tr.block_len * tr.sample_bytes));
+    const size_t n_chunks = (tr.n_blocks + chunk_blocks - 1) / chunk_blocks;
+    unsigned int nthreads = p.threads > 0 ? p.threads : std::thread::hardware_concurrency();
+    if (nthreads == 0) nthreads = 1;
+    nthreads = static_cast<unsigned int>(std::min<size_t>(nthreads, n_chunks));
+
+    printf("[NRU][ANALYZE] %s: %zu samples, %zu blocks of %zu, %zu chunks on %u threads\n",
+           p.trace.c_str(), tr.n_samples, tr.n_blocks, tr.block_len, n_chunks, nthreads);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    Analyzer an(p, tr);
+    std::vector<ChunkResult> chunks(n_chunks);
+    StealPool pool(n_chunks, nthreads);
+    pool.run([&](size_t i) {
+        const size_t b0 = i * chunk_blocks;
+        an.run(b0, std::min(chunk_blocks, tr.n_blocks - b0), chunks[i]);
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Stitch runs across chunk boundaries and merge per-bin counters
+    const size_t n_bins = (tr.n_blocks + an.bin_blocks - 1) / an.bin_blocks;
+    std::vector<uint64_t> busy(n_bins, 0), idle_blocks(n_bins, 0), starts(n_bins, 0), preambles(n_bins, 0);
+    std::vector<double> idle_pow(n_bins, 0.0);
+    uint64_t hist[HIST_BINS] = {};
+    uint64_t tech[NRU_TECH_COUNT] = {};
+    size_t carry = 0;
+    for (const ChunkResult &r : chunks) {
+        for (int k = 0; k < HIST_BINS; k++)
+            hist[k] += r.hist[k];
+        for (int t = 0; t < NRU_TECH_COUNT; t++)
+            tech[t] += r.tech[t];
+        for (size_t b = 0; b < r.busy.size(); b++) {
+            busy[r.first_bin + b] += r.busy[b];
+            idle_pow[r.first_bin + b] += r.idle_pow[b];
+            idle_blocks[r.first_bin + b] += r.idle_blocks[b];
+            starts[r.first_bin + b] += r.starts[b];
+            preambles[r.first_bin + b] += r.preambles[b];
+        }
+        if (r.all_busy) {
+            carry += r.n_blocks;
+            continue;
+        }
+        if (carry + r.lead > 0)
+            hist[hist_bin((carry + r.lead) * p.block_us)]++;
+        carry = r.trail;
+    }
+    if (carry > 0)
+        hist[hist_bin(carry * p.block_us)]++;      // Cut by the end of the capture
+
+    munmap(map, tr.bytes);
+
+    // Reports
+    const std::string occ_path = p.output + "_occupancy.csv";
+    FILE *f = fopen(occ_path.c_str(), "w");
+    if (!f) {
+        perror(occ_path.c_str());
+        return 1;
+    }
+    fprintf(f, "time_s,busy_frac,noise_floor_dbm,bursts,wifi_preambles\n");
+    uint64_t total_busy = 0, total_bursts = 0, total_preambles = 0;
+    for (size_t b = 0; b < n_bins; b++) {
+        const size_t blocks = std::min(an.bin_blocks, tr.n_blocks - b * an.bin_blocks);
+        const double nf = idle_blocks[b] ? nru_power_to_db(static_cast<float>(idle_pow[b] / idle_blocks[b])) + p.cal_offset_db
+                                         : NAN;
+        fprintf(f, "%.6f,%.6f,%.2f,%llu,%llu\n", b * an.bin_blocks * p.block_us / 1e6,
+                static_cast<double>(busy[b]) / blocks, nf,
+                (unsigned long long)starts[b], (unsigned long long)preambles[b]);
+        total_busy += busy[b];
+        total_bursts += starts[b];
+        total_preambles += preambles[b];
+    }
+    fclose(f);
+
+    const std::string hist_path = p.output + "_bursts.csv";
+    f = fopen(hist_path.c_str(), "w");
+    if (!f) {
+        perror(hist_path.c_str());
+        return 1;
+    }
+    fprintf(f, "duration_min_us,duration_max_us,bursts\n");
+    for (int k = 0; k < HIST_BINS; k++) {
+        if (!hist[k]) continue;
+        fprintf(f, "%llu,%llu,%llu\n", k ? (unsigned long long)(1ULL << k) : 0ULL,
+                (unsigned long long)(2ULL << k), (unsigned long long)hist[k]);
+    }
+    fclose(f);
+
+    printf("[NRU][ANALYZE] %.2f s of capture in %.2f s (%.0f MB/s, %zu steals)\n",
+           tr.n_blocks * p.block_us / 1e6, elapsed, tr.bytes / 1e6 / elapsed, pool.steals());
+    printf("[NRU][ANALYZE] Occupancy %.2f%% | %llu bursts | %llu Wi-Fi preambles\n",
+           100.0 * total_busy / tr.n_blocks, (unsigned long long)total_bursts,
+           (unsigned long long)total_preambles);
+    for (int t = 0; t < NRU_TECH_COUNT; t++)
+        printf("[NRU][ANALYZE]   %-8s %llu bursts\n", nru_tech_name(static_cast<nru_tech_t>(t)),
+               (unsigned long long)tech[t]);
+    printf("[NRU][ANALYZE] Wrote %s and %s\n", occ_path.c_str(), hist_path.c_str());
+    return 0;
+}
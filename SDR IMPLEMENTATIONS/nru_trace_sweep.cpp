@@ -0,0 +1,446 @@
+/*
+ * NR-U LBT Parameter Sweep over Recorded IQ Traces
+ * ------------------------------------------------
+ * Replays field captures against a grid of LBT configurations
+ * (ED threshold x sensing window x CW x mode).
+ *
+ * Each trace is memory-mapped once and reduced once to block powers with
+ * the runtime kernels (nru_dsp.cpp). Prefix sums over those blocks are
+ * shared read-only by every configuration, so any window mean or
+ * occupancy count is O(1). Configurations then run in parallel on a
+ * worker pool. For each configuration the tool reports:
+ *   - air time obtained
+ *   - would-be collisions (bursts overlapping energy above --truth-dbm)
+ *   - missed opportunities (idle gaps >= --opportunity-us with no TX start)
+ *
+ * Replay semantics follow nru_lbt.c: LBE defers one sensing window per
+ * busy read and counts a Cat-4 backoff in 9 us slots, drawn from [0, CW]
+ * every time (the window is not adapted). After mcot_ms / window busy
+ * reads it transmits anyway. FBE does no CCA: it transmits the TX window
+ * of every frame, so ED and window do not change its result. Duty caps
+ * and the RF turnaround are not replayed.
+ *
+ * Build:
+ *   g++ -O2 -std=c++17 nru_trace_sweep.cpp nru_dsp.cpp -lpthread -o nru_trace_sweep
+ *
+ * Example:
+ *   ./nru_trace_sweep --rate 23.04 --format sc16 --cal-offset -30 \
+ *       --ed -82:-62:2 --window 25,100,500 --cw 7,15,31,63 --mode LBE,FBE \
+ *       -o sweep.csv capture1.dat capture2.dat
+ *
+ * Author: Integration for OAI NR-U Makhubela Innocent(MKHINN011)
+ * Date: 2025
+ */
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nru_dsp.h"
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+static const double LBE_SLOT_US = 9.0;
+
+struct SweepParams {
+    std::vector<std::string> traces;
+    bool sc16 = true;
+    double rate_msps = 0.0;
+    double block_us = 1.0;
+    double cal_offset_db = 0.0;        // dBm = dBFS + offset
+    double truth_dbm = -72.0;          // ground-truth occupancy threshold
+    double opportunity_us = 1000.0;
+    int mcot_ms = 6;
+    int frame_period_ms = 10;
+    int tx_window_ms = 5;
+    int threads = 0;
+    std::string output = "trace_sweep.csv";
+
+    std::vector<int> ed_dbm{-72};
+    std::vector<int> window_us{100};
+    std::vector<int> cw{15};
+    std::vector<std::string> modes{"LBE"};
+};
+
+struct LbtConfig {
+    std::string mode;
+    int ed_dbm;
+    int window_us;
+    int cw;
+};
+
+/* ============================================
+ *  TRACE REDUCTION (once per trace)
+ * ============================================ */
+
+struct ReducedTrace {
+    std::string name;
+    size_t n_blocks = 0;
+    std::vector<double> pow_prefix;    // sum of block power, n_blocks + 1
+    std::vector<uint32_t> busy_prefix; // blocks above truth threshold, n_blocks + 1
+    std::vector<std::pair<size_t, size_t>> opportunities;  // idle runs [a, b)
+
+    double mean_power(size_t a, size_t b) const {
+        return (b > a) ? (pow_prefix[b] - pow_prefix[a]) / (b - a) : 0.0;
+    }
+    bool any_busy(size_t a, size_t b) const {
+        return busy_prefix[std::min(b, n_blocks)] != busy_prefix[std::min(a, n_blocks)];
+    }
+};
+
+static bool reduce_trace(const SweepParams &p, const std::string &path,
+                         unsigned int nthreads, ReducedTrace &out) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        perror(path.c_str());
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "[NRU][SWEEP] %s: empty or unreadable\n", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void *map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    // Advice values are not flags: one call each
+    madvise(map, bytes, MADV_SEQUENTIAL);
+    madvise(map, bytes, MADV_WILLNEED);
+
+    const size_t sample_bytes = p.sc16 ? 2 * sizeof(int16_t) : 2 * sizeof(float);
+    const size_t n_samples = bytes / sample_bytes;
+    const size_t block_len = std::max<size_t>(1, static_cast<size_t>(std::lround(p.rate_msps * p.block_us)));
+    const size_t n_blocks = n_samples / block_len;
+
+    // Parallel block-power reduction over contiguous block ranges
+    std::vector<float> power(n_blocks);
+    std::vector<std::thread> workers;
+    const size_t per = (n_blocks + nthreads - 1) / nthreads;
+    for (unsigned int t = 0; t < nthreads; t++) {
+        size_t b0 = t * per;
+        size_t b1 = std::min(n_blocks, b0 + per);
+        if (b0 >= b1) break;
+        workers.emplace_back([&, b0, b1]() {
+            size_t n = (b1 - b0) * block_len;
+            if (p.sc16)
+                nru_block_power_sc16(static_cast<const int16_t *>(map) + 2 * b0 * block_len,
+                                     n, block_len, &power[b0]);
+            else
+                nru_block_power_fc32(static_cast<const float *>(map) + 2 * b0 * block_len,
+                                     n, block_len, &power[b0]);
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+    munmap(map, bytes);
+
+    // Prefix sums shared by every configuration
+    const double truth_lin = std::pow(10.0, (p.truth_dbm - p.cal_offset_db) / 10.0);
+    out.name = path;
+    out.n_blocks = n_blocks;
+    out.pow_prefix.assign(n_blocks + 1, 0.0);
+    out.busy_prefix.assign(n_blocks + 1, 0);
+    for (size_t b = 0; b < n_blocks; b++) {
+        out.pow_prefix[b + 1] = out.pow_prefix[b] + power[b];
+        out.busy_prefix[b + 1] = out.busy_prefix[b] + (power[b] >= truth_lin ? 1u : 0u);
+    }
+
+    // Idle runs long enough to carry a transmission
+    const size_t min_run = static_cast<size_t>(std::ceil(p.opportunity_us / p.block_us));
+    size_t run_start = 0;
+    for (size_t b = 0; b <= n_blocks; b++) {
+        bool busy = (b == n_blocks) || power[b] >= truth_lin;
+        if (!busy) continue;
+        if (b - run_start >= min_run)
+            out.opportunities.emplace_back(run_start, b);
+        run_start = b + 1;
+    }
+
+    printf("[NRU][SWEEP] %s: %zu samples -> %zu blocks of %zu (%.2f s), %zu idle opportunities\n",
+           path.c_str(), n_samples, n_blocks, block_len,
+           n_blocks * p.block_us / 1e6, out.opportunities.size());
+    return true;
+}
+
+/* ============================================
+ *  CONFIGURATION REPLAY
+ * ============================================ */
+
+struct SweepResult {
+    size_t trace = 0;
+    LbtConfig cfg;
+    double airtime_us = 0;
+    uint64_t bursts = 0;
+    uint64_t collisions = 0;
+    uint64_t opportunities = 0;
+    uint64_t missed = 0;
+    double duration_us = 0;
+};
+
+static SweepResult replay(const SweepParams &p, const ReducedTrace &tr, const LbtConfig &cfg,
+                          size_t trace_idx, uint64_t seed) {
+    SweepResult r;
+    r.trace = trace_idx;
+    r.cfg = cfg;
+    r.duration_us = tr.n_blocks * p.block_us;
+
+    auto blocks = [&](double us) {
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(us / p.block_us)));
+    };
+    const double thr_lin = std::pow(10.0, (cfg.ed_dbm - p.cal_offset_db) / 10.0);
+    const size_t win = blocks(cfg.window_us);
+    const size_t n = tr.n_blocks;
+    std::vector<size_t> tx_starts;
+
+    auto transmit = [&](size_t t, size_t len) {
+        tx_starts.push_back(t);
+        r.bursts++;
+        r.airtime_us += len * p.block_us;
+        if (tr.any_busy(t, t + len))
+            r.collisions++;
+    };
+
+    if (cfg.mode == "FBE") {
+        const size_t frame = blocks(p.frame_period_ms * 1000.0);
+        const size_t on = blocks(p.tx_window_ms * 1000.0);
+        for (size_t s = 0; s + on <= n; s += frame)
+            transmit(s, on);
+    } else {
+        std::mt19937_64 rng(seed);
+        const size_t mcot = blocks(p.mcot_ms * 1000.0);
+        const size_t slot = blocks(LBE_SLOT_US);
+        const int max_retries = std::max(1, p.mcot_ms * 1000 / cfg.window_us);
+        size_t t = win;
+        while (t + mcot <= n) {
+            bool free = tr.mean_power(t - win, t) < thr_lin;
+            int backoff = static_cast<int>(rng() % static_cast<uint64_t>(cfg.cw + 1));
+            int retries = 0;
+            while (retries < max_retries && !(free && backoff == 0) && t + mcot <= n) {
+                if (!free) {
+                    t += win;
+                    retries++;
+                } else {
+                    t += slot;
+                    backoff--;
+                }
+                free = tr.mean_power(t - win, t) < thr_lin;
+            }
+            if (t + mcot > n) break;
+            transmit(t, mcot);
+            t += mcot;
+        }
+    }
+
+    // Opportunities with no TX start inside them (both lists are sorted)
+    size_t k = 0;
+    for (const auto &opp : tr.opportunities) {
+        while (k < tx_starts.size() && tx_starts[k] < opp.first) k++;
+        r.opportunities++;
+        if (k >= tx_starts.size() || tx_starts[k] >= opp.second)
+            r.missed++;
+    }
+    return r;
+}
+
+/* ============================================
+ *  COMMAND LINE
+ * ============================================ */
+
+static std::vector<std::string> split(const char *arg) {
+    std::vector<std::string> out;
+    std::string s(arg);
+    size_t pos = 0;
+    while (true) {
+        size_t comma = s.find(',', pos);
+        out.push_back(s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos));
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    return out;
+}
+
+// "a,b,c" or "start:stop[:step]" (inclusive)
+static std::vector<int> parse_list(const char *arg) {
+    std::vector<int> out;
+    for (const auto &tok : split(arg)) {
+        int a, b, step = 1;
+        int n = sscanf(tok.c_str(), "%d:%d:%d", &a, &b, &step);
+        if (n >= 2) {
+            if (step == 0) step = 1;
+            if ((b - a) * step < 0) step = -step;
+            for (int v = a; step > 0 ? v <= b : v >= b; v += step)
+                out.push_back(v);
+        } else if (n == 1) {
+            out.push_back(a);
+        }
+    }
+    return out;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [OPTIONS] TRACE...\n"
+           "      --rate MSPS          Capture sample rate (required)\n"
+           "      --format sc16|fc32   Sample format (default sc16)\n"
+           "      --block-us X         Reduction block length (default 1)\n"
+           "      --cal-offset DB      dBm = dBFS + offset (default 0)\n"
+           "      --truth-dbm X        Occupancy ground truth threshold (default -72)\n"
+           "      --opportunity-us X   Minimum idle gap counted as opportunity (default 1000)\n"
+           "      --ed LIST            ED thresholds in dBm (default -72)\n"
+           "      --window LIST        Sensing windows in us (default 100)\n"
+           "      --cw LIST            Contention windows (default 15)\n"
+           "      --mode LBE,FBE       Modes (default LBE)\n"
+           "      --mcot-ms N          LBE burst length (default 6)\n"
+           "      --frame-ms N         FBE frame period (default 10)\n"
+           "      --tx-window-ms N     FBE TX window (default 5)\n"
+           "  -j, --threads N          Worker threads (default: all cores)\n"
+           "  -o, --output FILE        CSV output (default trace_sweep.csv)\n"
+           "LIST is a,b,c or start:stop[:step]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    SweepParams p;
+    enum {
+        OPT_RATE = 256, OPT_FORMAT, OPT_BLOCK, OPT_CAL, OPT_TRUTH, OPT_OPP, OPT_ED, OPT_WINDOW,
+        OPT_CW, OPT_MODE, OPT_MCOT, OPT_FRAME, OPT_TXWIN
+    };
+    static const struct option opts[] = {
+        {"rate", required_argument, nullptr, OPT_RATE},
+        {"format", required_argument, nullptr, OPT_FORMAT},
+        {"block-us", required_argument, nullptr, OPT_BLOCK},
+        {"cal-offset", required_argument, nullptr, OPT_CAL},
+        {"truth-dbm", required_argument, nullptr, OPT_TRUTH},
+        {"opportunity-us", required_argument, nullptr, OPT_OPP},
+        {"ed", required_argument, nullptr, OPT_ED},
+        {"window", required_argument, nullptr, OPT_WINDOW},
+        {"cw", required_argument, nullptr, OPT_CW},
+        {"mode", required_argument, nullptr, OPT_MODE},
+        {"mcot-ms", required_argument, nullptr, OPT_MCOT},
+        {"frame-ms", required_argument, nullptr, OPT_FRAME},
+        {"tx-window-ms", required_argument, nullptr, OPT_TXWIN},
+        {"threads", required_argument, nullptr, 'j'},
+        {"output", required_argument, nullptr, 'o'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "j:o:h", opts, nullptr)) != -1) {
+        switch (c) {
+            case OPT_RATE: p.rate_msps = atof(optarg); break;
+            case OPT_FORMAT: p.sc16 = (std::string(optarg) != "fc32"); break;
+            case OPT_BLOCK: p.block_us = atof(optarg); break;
+            case OPT_CAL: p.cal_offset_db = atof(optarg); break;
+            case OPT_TRUTH: p.truth_dbm = atof(optarg); break;
+            case OPT_OPP: p.opportunity_us = atof(optarg); break;
+            case OPT_ED: p.ed_dbm = parse_list(optarg); break;
+            case OPT_WINDOW: p.window_us = parse_list(optarg); break;
+            case OPT_CW: p.cw = parse_list(optarg); break;
+            case OPT_MODE: p.modes = split(optarg); break;
+            case OPT_MCOT: p.mcot_ms = atoi(optarg); break;
+            case OPT_FRAME: p.frame_period_ms = atoi(optarg); break;
+            case OPT_TXWIN: p.tx_window_ms = atoi(optarg); break;
+            case 'j': p.threads = atoi(optarg); break;
+            case 'o': p.output = optarg; break;
+            case 'h': usage(argv[0]); return 0;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    for (int i = optind; i < argc; i++)
+        p.traces.push_back(argv[i]);
+
+    if (p.traces.empty() || p.rate_msps <= 0.0 || p.block_us <= 0.0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // FBE ignores CW, so it contributes one point per (threshold, window)
+    std::vector<LbtConfig> configs;
+    for (const auto &mode : p.modes) {
+        if (mode != "LBE" && mode != "FBE") {
+            fprintf(stderr, "[NRU][SWEEP] Unknown mode %s\n", mode.c_str());
+            return 1;
+        }
+        for (int ed : p.ed_dbm)
+            for (int w : p.window_us) {
+                if (w <= 0) continue;
+                if (mode == "FBE") {
+                    configs.push_back({mode, ed, w, 0});
+                    continue;
+                }
+                for (int cw : p.cw)
+                    configs.push_back({mode, ed, w, std::max(0, cw)});
+            }
+    }
+
+    unsigned int nthreads = p.threads > 0 ? p.threads : std::thread::hardware_concurrency();
+    if (nthreads == 0) nthreads = 1;
+
+    // Expensive part: read and reduce every trace exactly once
+    std::vector<ReducedTrace> traces;
+    for (const auto &path : p.traces) {
+        ReducedTrace tr;
+        if (reduce_trace(p, path, nthreads, tr))
+            traces.push_back(std::move(tr));
+    }
+    if (traces.empty())
+        return 1;
+
+    const size_t jobs = traces.size() * configs.size();
+    printf("[NRU][SWEEP] %zu configurations x %zu traces on %u threads\n",
+           configs.size(), traces.size(), nthreads);
+
+    std::vector<SweepResult> results(jobs);
+    std::atomic<size_t> next_job{0};
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < std::min<size_t>(nthreads, jobs); i++) {
+        workers.emplace_back([&]() {
+            size_t j;
+            while ((j = next_job.fetch_add(1, std::memory_order_relaxed)) < jobs) {
+                size_t ti = j / configs.size();
+                size_t ci = j % configs.size();
+                results[j] = replay(p, traces[ti], configs[ci], ti, 0x5EEDULL + ci);
+            }
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+
+    FILE *f = fopen(p.output.c_str(), "w");
+    if (!f) {
+        perror(p.output.c_str());
+        return 1;
+    }
+    fprintf(f, "trace,mode,ed_threshold_dbm,window_us,cw,duration_s,airtime_s,airtime_frac,"
+               "bursts,would_be_collisions,collision_frac,opportunities,missed_opportunities\n");
+    for (const auto &r : results) {
+        fprintf(f, "%s,%s,%d,%d,%d,%.6f,%.6f,%.6f,%llu,%llu,%.6f,%llu,%llu\n",
+                traces[r.trace].name.c_str(), r.cfg.mode.c_str(), r.cfg.ed_dbm,
+                r.cfg.window_us, r.cfg.cw, r.duration_us / 1e6, r.airtime_us / 1e6,
+                r.duration_us > 0 ? r.airtime_us / r.duration_us : 0.0,
+                (unsigned long long)r.bursts, (unsigned long long)r.collisions,
+                r.bursts ? static_cast<double>(r.collisions) / r.bursts : 0.0,
+                (unsigned long long)r.opportunities, (unsigned long long)r.missed);
+    }
+    fclose(f);
+    printf("[NRU][SWEEP] Wrote %zu rows to %s\n", results.size(), p.output.c_str());
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * NR-U Per-UE Throughput Estimator
+ * --------------------------------
+ * State is indexed by UE uid. Each entry keeps the last cumulative
+ * byte counters, a ring of time buckets with running sums, and the
+ * published estimate behind a per-entry seqlock (single writer: the
+ * scheduler thread).
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_ue_rate.c
+ */
+
+#include <string.h>
+#include "common/utils/nru_seqlock.h"
+#include "NR_MAC_gNB/nru_ue_rate.h"
+
+typedef struct {
+    // Writer-only state
+    bool active;
+    uint64_t seen_round;               // Update round the UE was last seen in
+    uint64_t last_dl_bytes;
+    uint64_t last_ul_bytes;
+    uint64_t first_us;
+    uint64_t last_us;
+    uint64_t bucket_idx;               // Absolute index of the current bucket
+    uint64_t dl_bucket[NRU_UE_RATE_BUCKETS];
+    uint64_t ul_bucket[NRU_UE_RATE_BUCKETS];
+    uint64_t dl_sum;
+    uint64_t ul_sum;
+
+    // Published estimate
+    uint32_t seq;
+    nru_ue_rate_t pub;
+} ue_rate_entry_t;
+
+static ue_rate_entry_t rate_table[MAX_MOBILES_PER_GNB];
+static uint64_t update_round;
+
+// ---------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------
+static void reset_entry(ue_rate_entry_t *e, const NR_UE_info_t *UE, uint64_t now_us) {
+    e->active = true;
+    e->last_dl_bytes = UE->mac_stats.dl.total_bytes;
+    e->last_ul_bytes = UE->mac_stats.ul.total_bytes;
+    e->first_us = now_us;
+    e->last_us = now_us;
+    e->bucket_idx = now_us / NRU_UE_RATE_BUCKET_US;
+    memset(e->dl_bucket, 0, sizeof(e->dl_bucket));
+    memset(e->ul_bucket, 0, sizeof(e->ul_bucket));
+    e->dl_sum = 0;
+    e->ul_sum = 0;
+
+    nru_seq_write_begin(&e->seq);
+    memset(&e->pub, 0, sizeof(e->pub));
+    e->pub.rnti = UE->rnti;
+    e->pub.updated_us = now_us;
+    nru_seq_write_end(&e->seq);
+}
+
+// Retire buckets that fell out of the window (at most NRU_UE_RATE_BUCKETS)
+static void advance_buckets(ue_rate_entry_t *e, uint64_t now_us) {
+    uint64_t idx = now_us / NRU_UE_RATE_BUCKET_US;
+    if (idx <= e->bucket_idx)
+        return;
+    uint64_t steps = idx - e->bucket_idx;
+    if (steps > NRU_UE_RATE_BUCKETS)
+        steps = NRU_UE_RATE_BUCKETS;
+    for (uint64_t k = 1; k <= steps; k++) {
+        int b = (int)((e->bucket_idx + k) % NRU_UE_RATE_BUCKETS);
+        e->dl_sum -= e->dl_bucket[b];
+        e->ul_sum -= e->ul_bucket[b];
+        e->dl_bucket[b] = 0;
+        e->ul_bucket[b] = 0;
+    }
+    e->bucket_idx = idx;
+}
+
+static inline double ewma(double prev, double sample, uint64_t dt_us) {
+    double alpha = (double)dt_us / (double)(NRU_UE_RATE_TAU_US + dt_us);
+    return prev + alpha * (sample - prev);
+}
+
+static bool read_entry(const ue_rate_entry_t *e, nru_ue_rate_t *out) {
+    uint32_t seq;
+    do {
+        seq = nru_seq_read_begin(&e->seq);
+        *out = e->pub;
+    } while (nru_seq_read_retry(&e->seq, seq));
+    return out->rnti != 0;
+}
+
+// ---------------------------------------------------------------------
+// Update (scheduler thread)
+// ---------------------------------------------------------------------
+void nru_ue_rate_update(gNB_MAC_INST *gNB, uint64_t now_us) {
+    update_round++;
+
+    UE_iterator(gNB->UE_info.connected_ue_list, UE) {
+        if (UE->uid < 0 || UE->uid >= MAX_MOBILES_PER_GNB)
+            continue;
+        ue_rate_entry_t *e = &rate_table[UE->uid];
+        e->seen_round = update_round;
+
+        const NR_mac_stats_t *stats = &UE->mac_stats;
+        if (!e->active || e->pub.rnti != UE->rnti ||
+            stats->dl.total_bytes < e->last_dl_bytes ||
+            stats->ul.total_bytes < e->last_ul_bytes) {
+            reset_entry(e, UE, now_us);
+            continue;
+        }
+
+        uint64_t dt = now_us - e->last_us;
+        if (dt == 0)
+            continue;
+        uint64_t d_dl = stats->dl.total_bytes - e->last_dl_bytes;
+        uint64_t d_ul = stats->ul.total_bytes - e->last_ul_bytes;
+        e->last_dl_bytes = stats->dl.total_bytes;
+        e->last_ul_bytes = stats->ul.total_bytes;
+        e->last_us = now_us;
+
+        advance_buckets(e, now_us);
+        int b = (int)(e->bucket_idx % NRU_UE_RATE_BUCKETS);
+        e->dl_bucket[b] += d_dl;
+        e->ul_bucket[b] += d_ul;
+        e->dl_sum += d_dl;
+        e->ul_sum += d_ul;
+
+        // Window = full retired buckets + elapsed part of the current one
+        uint64_t span = (NRU_UE_RATE_BUCKETS - 1) * (uint64_t)NRU_UE_RATE_BUCKET_US +
+                        now_us % NRU_UE_RATE_BUCKET_US;
+        if (span > now_us - e->first_us)
+            span = now_us - e->first_us;
+
+        nru_seq_write_begin(&e->seq);
+        e->pub.dl_ewma_mbps = ewma(e->pub.dl_ewma_mbps, d_dl * 8.0 / dt, dt);
+        e->pub.ul_ewma_mbps = ewma(e->pub.ul_ewma_mbps, d_ul * 8.0 / dt, dt);
+        e->pub.dl_window_mbps = span ? e->dl_sum * 8.0 / span : 0.0;
+        e->pub.ul_window_mbps = span ? e->ul_sum * 8.0 / span : 0.0;
+        e->pub.window_us = span;
+        e->pub.updated_us = now_us;
+        nru_seq_write_end(&e->seq);
+    }
+
+    // UEs that left the connected list stop being reported
+    for (int i = 0; i < MAX_MOBILES_PER_GNB; i++) {
+        ue_rate_entry_t *e = &rate_table[i];
+        if (e->active && e->seen_round != update_round) {
+            nru_seq_write_begin(&e->seq);
+            e->active = false;
+            e->pub.rnti = 0;
+            nru_seq_write_end(&e->seq);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------
+// Readers (any thread)
+// ---------------------------------------------------------------------
+int nru_ue_rate_get(int uid, rnti_t rnti, nru_ue_rate_t *out) {
+    nru_ue_rate_t r;
+    if (uid < 0 || uid >= MAX_MOBILES_PER_GNB)
+        return -1;
+    if (!read_entry(&rate_table[uid], &r) || r.rnti != rnti)
+        return -1;
+    *out = r;
+    return 0;
+}
+
+int nru_ue_rate_snapshot(nru_ue_rate_t *out, int max) {
+    int n = 0;
+    for (int i = 0; i < MAX_MOBILES_PER_GNB && n < max; i++) {
+        if (read_entry(&rate_table[i], &out[n]))
+            n++;
+    }
+    return n;
+}
+
+void nru_ue_rate_total_mbps(double *dl_mbps, double *ul_mbps) {
+    double dl = 0.0, ul = 0.0;
+    nru_ue_rate_t r;
+    for (int i = 0; i < MAX_MOBILES_PER_GNB; i++) {
+        if (read_entry(&rate_table[i], &r)) {
+            dl += r.dl_window_mbps;
+            ul += r.ul_window_mbps;
+        }
+    }
+    if (dl_mbps) *dl_mbps = dl;
+    if (ul_mbps) *ul_mbps = ul;
+}
@@ -0,0 +1,81 @@
+/*
+ * NR-U Per-UE Throughput Estimator Header
+ * ---------------------------------------
+ * Turns the cumulative MAC byte counters into DL/UL rates once per slot:
+ * an EWMA for fast reaction and a 1 s bucketed sliding window for a
+ * stable figure. Updates are O(1) per UE; reads are lock-free and may
+ * come from any thread (coexistence control, stats, operators).
+ *
+ * Location: openair2/LAYER2/NR_MAC_gNB/nru_ue_rate.h
+ */
+
+#ifndef NRU_UE_RATE_H
+#define NRU_UE_RATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "NR_MAC_gNB/nr_mac_gNB.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================
+ *  CONFIGURATION
+ * ============================================ */
+
+#define NRU_UE_RATE_BUCKETS    20        // Sliding window buckets
+#define NRU_UE_RATE_BUCKET_US  50000     // 20 x 50 ms = 1 s window
+#define NRU_UE_RATE_TAU_US     100000    // EWMA time constant
+
+/**
+ * Published rate estimate of one UE
+ */
+typedef struct {
+    rnti_t rnti;
+    double dl_ewma_mbps;               // EWMA of per-update rate
+    double ul_ewma_mbps;
+    double dl_window_mbps;             // Bytes over the sliding window
+    double ul_window_mbps;
+    uint64_t window_us;                // Span the window rates cover
+    uint64_t updated_us;               // nru_clock time of last update
+} nru_ue_rate_t;
+
+/* ============================================
+ *  API
+ * ============================================ */
+
+/**
+ * Fold this slot's byte counters into every connected UE's estimate
+ * Call once per slot from the scheduler (NR_SCHED_LOCK held).
+ * @param gNB: MAC instance
+ * @param now_us: Current nru_clock time
+ */
+void nru_ue_rate_update(gNB_MAC_INST *gNB, uint64_t now_us);
+
+/**
+ * Read one UE's estimate
+ * @param uid: UE slot (NR_UE_info_t uid), indexes the table directly
+ * @param rnti: Expected owner of the slot
+ * @param out: Filled on success
+ * @return: 0 on success, -1 if the slot holds no estimate for rnti
+ */
+int nru_ue_rate_get(int uid, rnti_t rnti, nru_ue_rate_t *out);
+
+/**
+ * Read all tracked UEs
+ * @param out: Array of max entries
+ * @return: Number of entries written
+ */
+int nru_ue_rate_snapshot(nru_ue_rate_t *out, int max);
+
+/**
+ * Cell-wide sliding-window totals (sum over tracked UEs)
+ */
+void nru_ue_rate_total_mbps(double *dl_mbps, double *ul_mbps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRU_UE_RATE_H */
@@ -21,17 +21,23 @@
 #include <iostream>
 #include <mutex>
 #include <atomic>
-#include <deque>
 #include <complex>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
 #include <array>
-#include <chrono>
 #include <thread>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include "common/utils/nru_clock.h"
+#include "common/utils/nru_classifier.h"
+#include "common/utils/nru_dsp.h"
+#include "common/utils/nru_channelizer.h"
+#include "common/utils/nru_sample_ring.h"
+#include "common/utils/nru_spectrum.h"
+#include "common/utils/nru_airtime.h"
+#include "common/utils/nru_coord.h"
 // ----------------------------------------------------------------------
 // [NRU integration] External scheduler linkage to OAI gNB
 // ----------------------------------------------------------------------
@@ -47,9 +53,14 @@ extern "C" {
  *  CONFIGURATION CONSTANTS
  * ============================================ */
 
-// Buffer size optimized for 15.36 MSPS (OAI standard rate)
-// 65536 samples = ~4.3ms buffer at 15.36 MSPS
-static const size_t MAX_BUFFER_SIZE = 65536;
+// Sensing windows are durations; sample counts follow the buffer rate
+// (derive_windows(), at attach and whenever the channelizer changes it)
+static const double ED_FAST_WINDOW_US = 32.0;       // Cached energy reading
+static const double ED_ACCURATE_WINDOW_US = 130.0;  // Forced reading
+static const double ED_MIN_WINDOW_US = 6.5;         // Less buffered than this reads as the floor
+static const double BUFFER_HISTORY_US = 4300.0;     // Sample buffer depth
+static const double RECV_BLOCK_US = 67.0;           // Sensing stream recv() size
+static const double DEFAULT_RATE_HZ = 15.36e6;      // Until the RX rate is known
 
 // Cache validity for ultra-fast LBT checks
 static const uint64_t CACHE_VALIDITY_US = 500;  // 0.5ms
@@ -57,6 +68,45 @@ static const uint64_t CACHE_VALIDITY_US = 500;  // 0.5ms
 // Default calibration offset (adjust based on hardware)
 static constexpr float DEFAULT_CALIBRATION_OFFSET_DB = .0f;
 
+// Own-TX masking: settling tail after each of our bursts
+static const uint32_t TX_SETTLE_DEFAULT_US = 100;   // Until the first measurement
+static const uint32_t TX_SETTLE_MAX_US = 2000;      // Longest decay we try to measure
+static const uint32_t TX_SETTLE_MARGIN_US = 10;     // Added to the measured decay
+static const uint64_t TX_MERGE_GAP_NS = 2000;       // Writes closer than this form one burst
+static const size_t TX_BURST_LOG = 32;
+static const size_t MAX_MASK_RANGES = 8;
+
+// Noise floor calibration: stop once the 95% CI half-width is this tight
+static const int CAL_MIN_MEASUREMENTS = 20;
+static const double CAL_CI_HALF_WIDTH_DB = 0.25;
+static const uint64_t CAL_INTERVAL_US = 5000;           // Fresh samples between readings
+static const uint64_t CAL_STREAM_TIMEOUT_US = 5000000;  // Give up if RX never starts
+
+// Sequential CCA (SPRT over ~1 us block powers)
+static const float SPRT_DEFAULT_FALSE_FREE = 1e-3f;     // P(FREE | power at threshold)
+static const float SPRT_DEFAULT_FALSE_BUSY = 1e-2f;     // P(BUSY | threshold - zone)
+static const int SPRT_DEFAULT_MIN_US = 9;               // One observation slot
+static const double SPRT_ZONE_DB = 2.0;                 // Indifference zone below the threshold
+
+// Ingest conditioning
+static const double DC_TRACK_MS = 10.0;                 // DC estimate time constant
+static const float CLIP_LEVEL_FS = 0.99f;               // Raw |I| or |Q| counted as clipped
+static const double IQ_BALANCE_ALPHA = 0.02;            // Moment smoothing per update
+static const uint64_t IQ_MIN_SAMPLES = 16384;           // Samples per IQ balance update
+static const float ED_MARGIN_DEFAULT_DB = 8.0f;         // ED threshold above the noise floor
+
+// Spectrum monitor (PSD frames to shared memory)
+static const double SPECTRUM_DEFAULT_RATE_HZ = 10.0;    // Frames per second
+static const size_t SPECTRUM_READ_CHUNK = 4096;         // Samples per ring read
+
+// Technology classifier (sample ring reader)
+static const uint64_t CLASSIFIER_POLL_US = 1000;
+static const size_t CLASSIFIER_READ_CHUNK = 16384;      // Samples per ring read
+
+// RX-to-TX turnaround (grant to first sample on air), sets the LBT guards
+static const uint32_t RF_TURNAROUND_DEFAULT_US = 500;  // Until the first measurement
+static const uint32_t RF_TURNAROUND_MAX_US = 4000;     // Longer gaps are not a turnaround
+
 // LBT timing constants (ETSI EN 301 893 compliance)
 static const int DEFAULT_FBE_SENSING_US = 25;   // Frame-Based Equipment
 static const int DEFAULT_LBE_SENSING_US = 100;  // Load-Based Equipment
@@ -67,9 +117,13 @@ static const int DEFAULT_LBE_SENSING_US = 100;  // Load-Based Equipment
 
 static uhd::usrp::multi_usrp::sptr global_usrp = nullptr;
 
-// Thread-safe sample buffer
-static std::deque<std::complex<float>> sample_buffer;
-static std::mutex buffer_mutex;
+// Sensing sample ring: the ingest thread writes, ED windows, the sequential
+// CCA and nru_read_samples() each read with their own cursor. Created once
+// (attach, or the first ingest) and never replaced; a clear moves ring_floor.
+static std::atomic<nru_sample_ring_t*> sample_ring{nullptr};
+static std::atomic<uint64_t> ring_floor{0};       // Samples before this index were cleared
+static std::atomic<int> read_samples_reader{-1};  // Reader of nru_read_samples()
+static std::mutex reader_open_mutex;
 
 // Energy detection state
 static std::atomic<float> cached_energy_dbm{-90.0f};
@@ -87,19 +141,361 @@ static std::atomic<uint64_t> total_samples_dropped{0};
 static std::atomic<uint64_t> buffer_overflow_count{0};
 static std::atomic<uint64_t> lbt_checks_performed{0};
 static std::atomic<uint64_t> channel_busy_count{0};
+static std::atomic<uint64_t> cca_sprt_early{0};
+static std::atomic<uint64_t> cca_sprt_full{0};
+static std::atomic<uint64_t> cca_sprt_window_us{0};
+
+// Sequential CCA parameters
+static std::atomic<bool> sprt_enabled{false};
+static std::atomic<float> sprt_false_free{SPRT_DEFAULT_FALSE_FREE};
+static std::atomic<float> sprt_false_busy{SPRT_DEFAULT_FALSE_BUSY};
+static std::atomic<int> sprt_min_us{SPRT_DEFAULT_MIN_US};
+
+// ED channelizer: configured by nru_set_ed_bandwidth(), rebuilt by the
+// ingest thread when dirty. sample_ring holds its output, at buffer_rate_hz.
+static std::atomic<double> ed_bw_hz{20e6};
+static std::atomic<double> ed_offset_hz{0.0};
+static std::atomic<bool> channelizer_dirty{true};
+static std::atomic<double> buffer_rate_hz{0.0};
+
+// Window lengths in samples at buffer_rate_hz (defaults: DEFAULT_RATE_HZ)
+static std::atomic<size_t> win_fast{492};
+static std::atomic<size_t> win_accurate{1997};
+static std::atomic<size_t> win_min{100};
+static std::atomic<size_t> buffer_capacity{66048};
+static std::atomic<int> channelizer_decim{1};
+static std::atomic<int> channelizer_taps{0};
+static nru_channelizer_t *channelizer = nullptr;   // Ingest thread only
+static uint64_t channelizer_next_ns = 0;           // Ingest thread: expected next block start
+static std::vector<std::complex<float>> channelizer_out;
+
+// Ingest conditioning: configured by nru_set_ingest_conditioning(), applied
+// by the ingest thread to every batch before anything else looks at it
+static std::atomic<bool> cond_dc_removal{true};
+static std::atomic<bool> cond_iq_balance{true};
+static std::atomic<bool> cond_clip_check{true};
+static std::atomic<bool> cond_dirty{true};
+static std::atomic<float> ed_margin_db{ED_MARGIN_DEFAULT_DB};
+static std::atomic<float> ed_threshold_cap_dbm{-82.0f};  // Configured (regulatory) maximum
+static nru_cond_t ingest_cond;                      // Ingest thread only
+static double iq_moments[3] = {0.0, 0.0, 0.0};      // Ingest thread: smoothed E[II], E[QQ], E[IQ]
+static std::vector<std::complex<float>> cond_out;
+static std::atomic<float> ingest_dc_dbfs{-120.0f};  // Published for nru_print_stats()
+static std::atomic<float> ingest_iq_gain_db{0.0f};
+static std::atomic<float> ingest_iq_phase_deg{0.0f};
+static std::atomic<uint64_t> total_samples_clipped{0};
+
+// Spectrum monitor: configured by nru_set_spectrum_monitor(), runs on its
+// own thread with a sample ring reader while a USRP is attached
+static std::atomic<int> spectrum_fft_size{0};        // 0 = off
+static std::atomic<int> spectrum_avg{0};             // FFTs per frame, 0 = all samples
+static std::atomic<double> spectrum_rate_hz{SPECTRUM_DEFAULT_RATE_HZ};
+static std::atomic<bool> spectrum_running{false};
+static std::atomic<uint64_t> spectrum_frames{0};
+static std::atomic<double> rx_center_hz{0.0};
+static std::thread spectrum_thread;
+
+// Technology classifier: own thread and sample ring reader while a USRP
+// is attached, so burst analysis never runs on the RX path
+static std::atomic<bool> classifier_running{false};
+static std::thread classifier_thread;
+
+// Own TX bursts in host time, published by the TX thread (single writer);
+// a contiguous write extends the newest entry. Readers only look at the
+// last few entries, far from the slot being overwritten.
+struct nru_tx_burst_t {
+    std::atomic<uint64_t> start_ns{0};
+    std::atomic<uint64_t> end_ns{0};
+};
+static nru_tx_burst_t tx_bursts[TX_BURST_LOG];
+static std::atomic<uint64_t> tx_burst_head{0};
+static std::atomic<double> tx_rate_hz{0.0};
+static std::atomic<double> rx_rate_hz{0.0};       // Cached at attach (trx_usrp_read path)
+static std::atomic<uint64_t> total_samples_masked{0};
+
+// Settling tail: measured decay (EWMA) unless overridden
+static std::atomic<uint32_t> tx_settle_override_us{0};
+static std::atomic<uint32_t> tx_settle_est_us{TX_SETTLE_DEFAULT_US};
+static uint64_t settle_probe_end_ns = 0;     // Ingest thread: burst end being measured
+static uint64_t settle_probed_end_ns = 0;    // Ingest thread: last burst end taken
+static uint64_t settle_probe_next_ns = 0;    // Ingest thread: expected next block start
+
+// Latest LBT grant not yet matched to a TX burst, and the turnaround estimate
+static std::atomic<uint64_t> tx_grant_ns{0};
+static std::atomic<uint32_t> rf_turnaround_est_us{RF_TURNAROUND_DEFAULT_US};
+
+// Start of the RX block last seen by nru_observe_rx_timestamp()
+static std::atomic<uint64_t> rx_block_start_ns{0};
+static std::atomic<size_t> rx_block_count{0};
 
 // Direct streaming control
 static std::atomic<bool> sensing_thread_running{false};
-static std::thread sensing_thread;
+static std::thread sensing_thread;             // Sensing worker (noise calibration)
+static std::atomic<bool> calibration_running{false};
+static std::atomic<bool> calibration_cancel{false};
 
 /* ============================================
  *  TIME HELPERS
  * ============================================ */
 
+// All module timing goes through the NR-U clock service so that cache
+// ages and sensing windows share one (CLOCK_MONOTONIC) domain with nru_lbt.c
 static inline uint64_t get_time_us() {
-    auto now = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::microseconds>(
-        now.time_since_epoch()).count();
+    return nru_clock_now_us();
+}
+
+// Samples spanning us microseconds at rate_hz (at least one)
+static inline size_t samples_for_us(double us, double rate_hz) {
+    return std::max<size_t>(1, static_cast<size_t>(std::lround(us * rate_hz * 1e-6)));
+}
+
+/**
+ * Size the sensing windows and the buffer for the rate of sample_ring
+ */
+static void derive_windows(double rate_hz) {
+    if (rate_hz <= 0.0) rate_hz = DEFAULT_RATE_HZ;
+    win_fast.store(samples_for_us(ED_FAST_WINDOW_US, rate_hz), std::memory_order_relaxed);
+    win_accurate.store(samples_for_us(ED_ACCURATE_WINDOW_US, rate_hz), std::memory_order_relaxed);
+    win_min.store(samples_for_us(ED_MIN_WINDOW_US, rate_hz), std::memory_order_relaxed);
+    buffer_capacity.store(samples_for_us(BUFFER_HISTORY_US, rate_hz), std::memory_order_relaxed);
+}
+
+/* ============================================
+ *  SAMPLE RING ACCESS
+ * ============================================ */
+
+/**
+ * Sample ring, created on first use with room for min_samples
+ * Readers keep the pointer, so it is never replaced; a later rate change
+ * only changes how much history fits.
+ */
+static nru_sample_ring_t *get_sample_ring(size_t min_samples) {
+    nru_sample_ring_t *ring = sample_ring.load(std::memory_order_acquire);
+    if (ring || min_samples == 0)
+        return ring;
+    nru_sample_ring_t *created = nru_ring_create(min_samples);
+    if (!sample_ring.compare_exchange_strong(ring, created, std::memory_order_acq_rel)) {
+        nru_ring_destroy(created);
+        return ring;
+    }
+    return created;
+}
+
+/**
+ * Samples in the ring since the last clear
+ */
+static size_t ring_fill(const nru_sample_ring_t *ring) {
+    if (!ring) return 0;
+    const uint64_t head = nru_ring_head(ring);
+    const uint64_t floor = std::max(ring_floor.load(std::memory_order_relaxed),
+                                    head - std::min<uint64_t>(head, nru_ring_capacity(ring)));
+    return static_cast<size_t>(head > floor ? head - floor : 0);
+}
+
+/**
+ * Mean power of the latest n samples (fewer if the ring holds fewer)
+ * @return: false if fewer than min_n samples are available
+ */
+static bool latest_mean_power(size_t n, size_t min_n, double *power) {
+    thread_local std::vector<std::complex<float>> window;
+    nru_sample_ring_t *ring = get_sample_ring(0);
+    n = std::min(n, ring_fill(ring));
+    if (n == 0 || n < min_n)
+        return false;
+    if (window.size() < n)
+        window.resize(n);
+    n = nru_ring_read_latest(ring, reinterpret_cast<float*>(window.data()), n, nullptr);
+    if (n == 0 || n < min_n)
+        return false;
+    *power = nru_mean_power_fc32(reinterpret_cast<const float*>(window.data()), n);
+    return true;
+}
+
+// Periodic TSC refinement, rate-limited to once per second
+static void clock_housekeeping(uint64_t now_us) {
+    static std::atomic<uint64_t> last_recal_us{0};
+    uint64_t last = last_recal_us.load(std::memory_order_relaxed);
+    if (now_us - last < 1000000ULL) return;
+    if (last_recal_us.compare_exchange_strong(last, now_us, std::memory_order_relaxed))
+        nru_clock_recalibrate();
+}
+
+/**
+ * Map an RX timestamp onto the device clock
+ * Called from trx_usrp_read() with OAI's sample-count timestamp of the
+ * first sample in the block just received.
+ * @param sample_ts: Device time in samples
+ * @param count: Number of samples in the block
+ */
+void nru_observe_rx_timestamp(uint64_t sample_ts, size_t count) {
+    double rate = rx_rate_hz.load(std::memory_order_relaxed);
+    if (rate <= 0.0) return;
+
+    uint64_t now_ns = nru_clock_now_ns();
+    uint64_t block_ns = static_cast<uint64_t>(count * 1e9 / rate);
+    int64_t device_ns = static_cast<int64_t>(sample_ts * (1e9 / rate));
+    nru_clock_observe_device_time(device_ns, now_ns - block_ns);
+
+    rx_block_start_ns.store(nru_clock_device_to_host_ns(device_ns), std::memory_order_relaxed);
+    rx_block_count.store(count, std::memory_order_release);
+}
+
+/* ============================================
+ *  OWN-TX MASKING
+ * ============================================ */
+
+/**
+ * Publish one transmitted block
+ * Called from trx_usrp_write() with the TX timestamp of the block; mapped
+ * to host time through the same device clock mapping as RX.
+ * @param sample_ts: Device time of the first sample (in samples)
+ * @param count: Number of samples written
+ */
+void nru_observe_tx_burst(uint64_t sample_ts, size_t count) {
+    double rate = tx_rate_hz.load(std::memory_order_relaxed);
+    if (rate <= 0.0 || count == 0) return;
+
+    uint64_t start = nru_clock_device_to_host_ns(static_cast<int64_t>(sample_ts * (1e9 / rate)));
+    uint64_t end = start + static_cast<uint64_t>(count * 1e9 / rate);
+    nru_airtime_record(start / 1000ULL, (end + 999ULL) / 1000ULL);
+
+    uint64_t head = tx_burst_head.load(std::memory_order_relaxed);
+    if (head > 0) {
+        nru_tx_burst_t &last = tx_bursts[(head - 1) % TX_BURST_LOG];
+        uint64_t last_end = last.end_ns.load(std::memory_order_relaxed);
+        if (start >= last.start_ns.load(std::memory_order_relaxed) &&
+            start <= last_end + TX_MERGE_GAP_NS) {
+            if (end > last_end)
+                last.end_ns.store(end, std::memory_order_release);
+            return;
+        }
+    }
+    // First block of a new burst closes the turnaround measurement
+    uint64_t grant = tx_grant_ns.exchange(0, std::memory_order_relaxed);
+    if (grant && start > grant && start - grant < RF_TURNAROUND_MAX_US * 1000ULL) {
+        int32_t measured = static_cast<int32_t>((start - grant) / 1000ULL);
+        int32_t est = static_cast<int32_t>(rf_turnaround_est_us.load(std::memory_order_relaxed));
+        rf_turnaround_est_us.store(static_cast<uint32_t>(est + (measured - est) / 8),
+                                   std::memory_order_relaxed);
+    }
+
+    nru_tx_burst_t &b = tx_bursts[head % TX_BURST_LOG];
+    b.start_ns.store(start, std::memory_order_relaxed);
+    b.end_ns.store(end, std::memory_order_relaxed);
+    tx_burst_head.store(head + 1, std::memory_order_release);
+}
+
+void nru_note_tx_grant(uint64_t grant_us) {
+    tx_grant_ns.store(grant_us * 1000ULL, std::memory_order_relaxed);
+}
+
+uint32_t nru_get_rf_turnaround_us(void) {
+    return rf_turnaround_est_us.load(std::memory_order_relaxed);
+}
+
+void nru_set_tx_settling_us(uint32_t settle_us) {
+    tx_settle_override_us.store(settle_us, std::memory_order_relaxed);
+}
+
+uint32_t nru_get_tx_settling_us(void) {
+    uint32_t fixed = tx_settle_override_us.load(std::memory_order_relaxed);
+    return fixed ? fixed : tx_settle_est_us.load(std::memory_order_relaxed) + TX_SETTLE_MARGIN_US;
+}
+
+bool nru_own_tx_masked(void) {
+    return tx_burst_head.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * Sample ranges of a block covered by our own TX plus its settling tail
+ * @param t0_ns: Host time of the first sample
+ * @return: Number of sorted, disjoint [lo, hi) ranges written
+ */
+static size_t own_tx_mask(uint64_t t0_ns, size_t count, double rate,
+                          size_t *lo, size_t *hi) {
+    uint64_t head = tx_burst_head.load(std::memory_order_acquire);
+    if (head == 0) return 0;
+
+    const double samples_per_ns = rate * 1e-9;
+    const uint64_t t1_ns = t0_ns + static_cast<uint64_t>(count / samples_per_ns);
+    const uint64_t tail_ns = static_cast<uint64_t>(nru_get_tx_settling_us()) * 1000ULL;
+
+    size_t n = 0;
+    for (uint64_t i = head - std::min<uint64_t>(head, TX_BURST_LOG); i < head; i++) {
+        const nru_tx_burst_t &b = tx_bursts[i % TX_BURST_LOG];
+        uint64_t s = b.start_ns.load(std::memory_order_relaxed);
+        uint64_t e = b.end_ns.load(std::memory_order_acquire) + tail_ns;
+        if (e <= t0_ns || s >= t1_ns) continue;
+
+        size_t i0 = (s <= t0_ns) ? 0 : static_cast<size_t>((s - t0_ns) * samples_per_ns);
+        size_t i1 = std::min(count, static_cast<size_t>(std::ceil((e - t0_ns) * samples_per_ns)));
+        if (n > 0 && i0 <= hi[n - 1]) {
+            hi[n - 1] = std::max(hi[n - 1], i1);
+        } else if (n < MAX_MASK_RANGES) {
+            lo[n] = i0;
+            hi[n] = i1;
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * Measure how long RX stays above the ED threshold after our last burst
+ * Only bursts whose end and decay are seen in consecutive blocks count;
+ * bursts followed by other traffic never decay within TX_SETTLE_MAX_US
+ * and are dropped from the estimate.
+ */
+static void probe_tx_settling(const std::complex<float>* samples, size_t count,
+                              uint64_t t0_ns, double rate) {
+    const uint64_t t1_ns = t0_ns + static_cast<uint64_t>(count * 1e9 / rate);
+
+    if (settle_probe_end_ns == 0) {
+        uint64_t head = tx_burst_head.load(std::memory_order_acquire);
+        if (head == 0) return;
+        uint64_t end = tx_bursts[(head - 1) % TX_BURST_LOG].end_ns.load(std::memory_order_acquire);
+        if (end <= settle_probed_end_ns || end >= t1_ns) return;
+        settle_probed_end_ns = end;
+        if (end < t0_ns) return;                 // End fell in a block we did not see
+        settle_probe_end_ns = end;
+    } else if (t0_ns > settle_probe_next_ns + 1000ULL) {
+        settle_probe_end_ns = 0;                 // Gap in the stream, decay not observable
+        return;
+    }
+    settle_probe_next_ns = t1_ns;
+
+    const uint64_t end = settle_probe_end_ns;
+    const uint64_t limit = end + TX_SETTLE_MAX_US * 1000ULL;
+    if (t0_ns >= limit) {
+        settle_probe_end_ns = 0;
+        return;
+    }
+
+    const size_t block_len = std::max<size_t>(1, static_cast<size_t>(rate * 1e-6));
+    const size_t first = (end <= t0_ns) ? 0 : static_cast<size_t>((end - t0_ns) * rate * 1e-9);
+    if (first >= count) return;
+
+    static thread_local std::vector<float> power;
+    const size_t n_blocks = (count - first) / block_len;
+    if (power.size() < n_blocks)
+        power.resize(n_blocks);
+    nru_block_power_fc32(reinterpret_cast<const float*>(samples + first),
+                         count - first, block_len, power.data());
+
+    const float thr = std::pow(10.0f, (nru_config_ed_threshold_dbm - calibration_offset_db) / 10.0f);
+    for (size_t b = 0; b < n_blocks; b++) {
+        if (power[b] >= thr) continue;
+        uint64_t t = t0_ns + static_cast<uint64_t>((first + b * block_len) * 1e9 / rate);
+        if (t < limit) {
+            uint32_t measured = static_cast<uint32_t>((t - std::min(t, end)) / 1000ULL);
+            uint32_t est = tx_settle_est_us.load(std::memory_order_relaxed);
+            int32_t delta = static_cast<int32_t>(measured) - static_cast<int32_t>(est);
+            tx_settle_est_us.store(static_cast<uint32_t>(static_cast<int32_t>(est) + delta / 8),
+                                   std::memory_order_relaxed);
+        }
+        settle_probe_end_ns = 0;
+        return;
+    }
 }
 
 /* ============================================
@@ -107,49 +503,204 @@ static inline uint64_t get_time_us() {
  * ============================================ */
 
 /**
- * Feed samples from external source
+ * Apply the conditioning settings (ingest thread)
+ */
+static void configure_conditioning(double rate, size_t block_len) {
+    nru_cond_init(&ingest_cond);
+    if (cond_dc_removal.load(std::memory_order_relaxed) && rate > 0.0)
+        ingest_cond.dc_alpha = static_cast<float>(block_len / (rate * DC_TRACK_MS * 1e-3));
+    if (cond_clip_check.load(std::memory_order_relaxed))
+        ingest_cond.clip_level = CLIP_LEVEL_FS;
+    iq_moments[0] = iq_moments[1] = iq_moments[2] = 0.0;
+    ingest_iq_gain_db.store(0.0f, std::memory_order_relaxed);
+    ingest_iq_phase_deg.store(0.0f, std::memory_order_relaxed);
+}
+
+/**
+ * Fold the moments of the last batches into the IQ balance correction
+ * Imbalance leaves a gain error and part of I in the Q branch; removing the
+ * I component of Q (c = -E[IQ] / E[II]) and rescaling to E[II] makes the
+ * output branches orthogonal and of equal power.
+ */
+static void update_conditioning(void) {
+    nru_cond_t &c = ingest_cond;
+    if (c.clipped) {
+        total_samples_clipped.fetch_add(c.clipped, std::memory_order_relaxed);
+        c.clipped = 0;
+    }
+    const float dc_power = c.dc[0] * c.dc[0] + c.dc[1] * c.dc[1];
+    ingest_dc_dbfs.store(nru_power_to_db(dc_power), std::memory_order_relaxed);
+
+    if (c.n_moments < IQ_MIN_SAMPLES) return;
+    const double n = static_cast<double>(c.n_moments);
+    const double m[3] = { c.sum_ii / n, c.sum_qq / n, c.sum_iq / n };
+    c.sum_ii = c.sum_qq = c.sum_iq = 0.0;
+    c.n_moments = 0;
+    if (!cond_iq_balance.load(std::memory_order_relaxed) || m[0] <= 0.0 || m[1] <= 0.0) return;
+
+    const double a = (iq_moments[0] > 0.0) ? IQ_BALANCE_ALPHA : 1.0;
+    for (int k = 0; k < 3; k++)
+        iq_moments[k] += a * (m[k] - iq_moments[k]);
+
+    const double ii = iq_moments[0], qq = iq_moments[1], iq = iq_moments[2];
+    const double cross = -iq / ii;
+    const double q_orth = qq - iq * iq / ii;
+    if (q_orth <= 0.0) return;
+    const double gain = std::sqrt(ii / q_orth);
+    if (std::fabs(cross) > 0.3 || gain < 0.5 || gain > 2.0) return;   // Not an imbalance
+
+    c.gain_q = static_cast<float>(gain);
+    c.cross_q = static_cast<float>(gain * cross);
+    ingest_iq_gain_db.store(static_cast<float>(10.0 * std::log10(qq / ii)), std::memory_order_relaxed);
+    ingest_iq_phase_deg.store(static_cast<float>(std::asin(std::clamp(iq / std::sqrt(ii * qq), -1.0, 1.0)) * 180.0 / M_PI),
+                              std::memory_order_relaxed);
+}
+
+/**
+ * Ingest one RX batch (fc32 or sc16, exactly one non-NULL)
  * Non-blocking to prevent thread stalls
  */
-void nru_feed_samples(const std::complex<float>* samples, size_t count) {
-    if (!samples || count == 0) return;
+static void ingest_samples(const std::complex<float>* fc32, const int16_t* sc16, size_t count) {
+    if ((!fc32 && !sc16) || count == 0) return;
     
+    uint64_t now_us = get_time_us();
+    clock_housekeeping(now_us);
     total_samples_received.fetch_add(count, std::memory_order_relaxed);
-    
-    // Non-blocking lock - if busy, skip this batch
-    std::unique_lock<std::mutex> lock(buffer_mutex, std::defer_lock);
-    if (!lock.try_lock()) {
-        total_samples_dropped.fetch_add(count, std::memory_order_relaxed);
+
+    // Host time of the first sample: the RX timestamp of this block when
+    // nru_observe_rx_timestamp() saw it, arrival time otherwise
+    double rate = rx_rate_hz.load(std::memory_order_relaxed);
+    size_t mask_lo[MAX_MASK_RANGES], mask_hi[MAX_MASK_RANGES];
+    size_t n_mask = 0;
+    uint64_t t0_ns = 0;
+    if (rate > 0.0) {
+        if (rx_block_count.load(std::memory_order_acquire) == count) {
+            t0_ns = rx_block_start_ns.load(std::memory_order_relaxed);
+        } else {
+            uint64_t now_ns = now_us * 1000ULL;
+            uint64_t span_ns = static_cast<uint64_t>(count * 1e9 / rate);
+            t0_ns = now_ns - std::min(now_ns, span_ns);
+        }
+        n_mask = own_tx_mask(t0_ns, count, rate, mask_lo, mask_hi);
+    }
+
+    // Unmasked segments [seg_lo[k], seg_hi[k]) of the batch
+    size_t seg_lo[MAX_MASK_RANGES + 1], seg_hi[MAX_MASK_RANGES + 1];
+    size_t n_seg = 0, pos = 0, masked = 0;
+    for (size_t k = 0; k < n_mask; k++) {
+        if (mask_lo[k] > pos) {
+            seg_lo[n_seg] = pos;
+            seg_hi[n_seg++] = mask_lo[k];
+        }
+        masked += mask_hi[k] - mask_lo[k];
+        pos = mask_hi[k];
+    }
+    if (pos < count) {
+        seg_lo[n_seg] = pos;
+        seg_hi[n_seg++] = count;
+    }
+    if (masked)
+        total_samples_masked.fetch_add(masked, std::memory_order_relaxed);
+
+    // One pass over the raw batch: DC removal, gain/IQ balance, clip check.
+    // Masked ranges (our own TX) are corrected for the settling probe but
+    // do not move the estimates.
+    const size_t block_len = (rate > 0.0) ? samples_for_us(1.0, rate) : 64;
+    if (cond_dirty.exchange(false, std::memory_order_acq_rel))
+        configure_conditioning(rate, block_len);
+    if (cond_out.size() < count)
+        cond_out.resize(count);
+    auto condition = [&](size_t lo, size_t n, int track) {
+        float *out = reinterpret_cast<float*>(cond_out.data() + lo);
+        if (fc32)
+            nru_condition_fc32(&ingest_cond, reinterpret_cast<const float*>(fc32 + lo),
+                               n, block_len, out, nullptr, track);
+        else
+            nru_condition_sc16(&ingest_cond, sc16 + 2 * lo, n, block_len, out, nullptr, track);
+    };
+    pos = 0;
+    for (size_t k = 0; k < n_seg; k++) {
+        if (seg_lo[k] > pos)
+            condition(pos, seg_lo[k] - pos, 0);
+        condition(seg_lo[k], seg_hi[k] - seg_lo[k], 1);
+        pos = seg_hi[k];
+    }
+    if (pos < count)
+        condition(pos, count - pos, 0);
+    update_conditioning();
+    const std::complex<float> *samples = cond_out.data();
+
+    if (rate > 0.0)
+        probe_tx_settling(samples, count, t0_ns, rate);
+    if (n_seg == 0) {
+        nru_channelizer_reset(channelizer);
         return;
     }
-    
-    // Make room if needed (FIFO buffer)
-    if (sample_buffer.size() + count > MAX_BUFFER_SIZE) {
-        size_t to_remove = sample_buffer.size() + count - MAX_BUFFER_SIZE;
-        sample_buffer.erase(sample_buffer.begin(), 
-                           sample_buffer.begin() + to_remove);
-        buffer_overflow_count.fetch_add(1, std::memory_order_relaxed);
+
+    // Restrict the buffered samples to the LBT channel. The filter history
+    // must not span a gap: a new block that does not follow the previous
+    // one, or a masked range (our own TX), restarts it.
+    if (rate > 0.0 && channelizer_dirty.exchange(false, std::memory_order_acq_rel)) {
+        nru_channelizer_destroy(channelizer);
+        channelizer = nru_channelizer_create(rate, ed_bw_hz.load(std::memory_order_relaxed),
+                                             ed_offset_hz.load(std::memory_order_relaxed));
+        channelizer_decim.store(nru_channelizer_decimation(channelizer), std::memory_order_relaxed);
+        channelizer_taps.store(nru_channelizer_taps(channelizer), std::memory_order_relaxed);
+        buffer_rate_hz.store(channelizer ? nru_channelizer_out_rate(channelizer) : rate,
+                             std::memory_order_relaxed);
+        derive_windows(buffer_rate_hz.load(std::memory_order_relaxed));
+    }
+    size_t out_lo[MAX_MASK_RANGES + 1], out_hi[MAX_MASK_RANGES + 1];
+    const std::complex<float> *src = samples;
+    if (channelizer) {
+        const uint64_t period_ns = static_cast<uint64_t>(1e9 / rate) + 1;
+        if (t0_ns > channelizer_next_ns + period_ns || t0_ns + period_ns < channelizer_next_ns)
+            nru_channelizer_reset(channelizer);
+        channelizer_next_ns = t0_ns + static_cast<uint64_t>(count * 1e9 / rate);
+
+        channelizer_out.resize(count + n_seg);
+        size_t n_out = 0;
+        for (size_t k = 0; k < n_seg; k++) {
+            if (seg_lo[k] > 0)
+                nru_channelizer_reset(channelizer);
+            out_lo[k] = n_out;
+            n_out += nru_channelizer_process(channelizer,
+                                             reinterpret_cast<const float*>(samples + seg_lo[k]),
+                                             seg_hi[k] - seg_lo[k],
+                                             reinterpret_cast<float*>(channelizer_out.data() + n_out));
+            out_hi[k] = n_out;
+        }
+        if (seg_hi[n_seg - 1] < count)
+            nru_channelizer_reset(channelizer);
+        src = channelizer_out.data();
+    } else {
+        for (size_t k = 0; k < n_seg; k++) {
+            out_lo[k] = seg_lo[k];
+            out_hi[k] = seg_hi[k];
+        }
     }
     
-    // Add new samples
-    sample_buffer.insert(sample_buffer.end(), samples, samples + count);
+    // Publish to the ring (never blocks; readers that fall behind lose
+    // their oldest samples). Our own TX and its settling tail never enter.
+    nru_sample_ring_t *ring = get_sample_ring(buffer_capacity.load(std::memory_order_relaxed));
+    for (size_t k = 0; k < n_seg; k++)
+        nru_ring_write(ring, reinterpret_cast<const float*>(src + out_lo[k]), out_hi[k] - out_lo[k]);
+}
+
+/**
+ * Feed samples from external source
+ */
+void nru_feed_samples(const std::complex<float>* samples, size_t count) {
+    ingest_samples(samples, nullptr, count);
 }
 
 /**
  * Alternative: Feed from int16_t samples (OAI standard format)
- * Converts from 12-bit shifted format to normalized float
+ * Conversion to normalized float happens in the conditioning pass
+ * @param count: Number of int16 values (2 per complex sample)
  */
 void nru_feed_samples_int16(const int16_t* samples, size_t count) {
-    if (!samples || count == 0) return;
-    
-    // Convert to complex float (I/Q interleaved)
-    std::vector<std::complex<float>> float_samples(count / 2);
-    for (size_t i = 0; i < count / 2; i++) {
-        float i_val = static_cast<float>(samples[2*i]) / 32768.0f;
-        float q_val = static_cast<float>(samples[2*i + 1]) / 32768.0f;
-        float_samples[i] = std::complex<float>(i_val, q_val);
-    }
-    
-    nru_feed_samples(float_samples.data(), float_samples.size());
+    ingest_samples(nullptr, samples, count / 2);
 }
 /**
  * Feed samples from OAI's main RX path
@@ -182,30 +733,16 @@ void nru_feed_from_main_rx(const void* samples, size_t count, bool is_int16) {
 
 /**
  * Fast software energy calculation
- * Uses last 500 samples for ~32μs measurement at 15.36 MSPS
+ * Mean power over the latest ED_FAST_WINDOW_US of samples
  */
 static float calculate_energy_from_samples_fast() {
-    std::unique_lock<std::mutex> lock(buffer_mutex, std::defer_lock);
-    
-    // Non-blocking - return cached if busy
-    if (!lock.try_lock()) {
-        return cached_energy_dbm.load(std::memory_order_relaxed);
-    }
-    
-    if (sample_buffer.size() < 100) {
+    // Latest window only, for speed
+    double mean_power = 0.0;
+    if (!latest_mean_power(win_fast.load(std::memory_order_relaxed),
+                           win_min.load(std::memory_order_relaxed), &mean_power)) {
         return noise_floor_dbm;
     }
     
-    // Use last 500 samples for speed
-    size_t n = std::min(sample_buffer.size(), static_cast<size_t>(500));
-    size_t start = sample_buffer.size() - n;
-    
-    double sum_power = 0.0;
-    for (size_t i = start; i < sample_buffer.size(); ++i) {
-        sum_power += std::norm(sample_buffer[i]);
-    }
-    
-    double mean_power = sum_power / n;
     double dbfs = 10.0 * std::log10(std::max(mean_power, 1e-12));
     float energy_dbm = static_cast<float>(dbfs + calibration_offset_db);
     
@@ -214,25 +751,16 @@ static float calculate_energy_from_samples_fast() {
 
 /**
  * Accurate energy calculation (more samples)
- * Uses up to 2000 samples for better accuracy
+ * Mean power over up to ED_ACCURATE_WINDOW_US of samples
  */
 static float calculate_energy_from_samples_accurate() {
-    std::lock_guard<std::mutex> lock(buffer_mutex);
-    
-    if (sample_buffer.size() < 100) {
-        return noise_floor_dbm;
-    }
-    
     // Use more samples for accuracy
-    size_t n = std::min(sample_buffer.size(), static_cast<size_t>(2000));
-    size_t start = sample_buffer.size() - n;
-    
-    double sum_power = 0.0;
-    for (size_t i = start; i < sample_buffer.size(); ++i) {
-        sum_power += std::norm(sample_buffer[i]);
+    double mean_power = 0.0;
+    if (!latest_mean_power(win_accurate.load(std::memory_order_relaxed),
+                           win_min.load(std::memory_order_relaxed), &mean_power)) {
+        return noise_floor_dbm;
     }
     
-    double mean_power = sum_power / n;
     double dbfs = 10.0 * std::log10(std::max(mean_power, 1e-12));
     float energy_dbm = static_cast<float>(dbfs + calibration_offset_db);
     
@@ -258,8 +786,6 @@ float nru_get_current_energy_dbm(void) {
     
     // Compute fresh measurement
     float energy = calculate_energy_from_samples_fast();
-    std::cout << "[NRU][DEBUG] Energy reading = " << energy 
-          << " dBm | Buffer size = " << sample_buffer.size() << std::endl;
 
     // Update cache
     cached_energy_dbm.store(energy, std::memory_order_relaxed);
@@ -281,8 +807,128 @@ float nru_get_current_energy_dbm_no_cache(void) {
  *  LBT IMPLEMENTATION (ETSI EN 301 893)
  * ============================================ */
 
+/**
+ * Sequential CCA (Wald SPRT) over the block-power stream
+ * H0: power SPRT_ZONE_DB below the ED threshold, H1: power at it, so a
+ * signal at or above the threshold is called FREE with at most the
+ * configured false-free probability.
+ * With complex Gaussian samples the log-likelihood ratio of one L-sample
+ * block of mean power P is L*ln(mu0/mu1) + L*P*(1/mu0 - 1/mu1), so clear
+ * cases (noise floor, strong bursts) cross a bound within a few blocks
+ * while powers near the threshold run the full window. Evidence starts
+ * with the latest min_us of buffered samples and continues with new ones.
+ * BUSY may be declared at any time; FREE only after min_us of evidence.
+ * At max_us the fixed-window rule (mean power vs threshold) decides.
+ * @return: 1 FREE, 0 BUSY, -1 if not applicable (rate unknown, no samples)
+ */
+static int sequential_cca(int min_us, int max_us) {
+    const double rate = buffer_rate_hz.load(std::memory_order_relaxed);
+    if (rate <= 0.0)
+        return -1;
+
+    const double thr_dbfs = nru_config_ed_threshold_dbm - calibration_offset_db;
+    const double mu_thr = std::pow(10.0, thr_dbfs / 10.0);
+    const double mu0 = std::pow(10.0, (thr_dbfs - SPRT_ZONE_DB) / 10.0);
+    const double mu1 = mu_thr;
+    const size_t L = std::max<size_t>(1, static_cast<size_t>(rate * 1e-6));
+    const double llr_bias = L * std::log(mu0 / mu1);
+    const double llr_gain = L * (1.0 / mu0 - 1.0 / mu1);
+
+    // Wald bounds with H1 = BUSY: alpha = P(BUSY | H0) is the false-busy
+    // rate, beta = P(FREE | H1) the false-free rate
+    const double alpha = sprt_false_busy.load(std::memory_order_relaxed);
+    const double beta = sprt_false_free.load(std::memory_order_relaxed);
+    const double upper = std::log((1.0 - beta) / alpha);
+    const double lower = std::log(beta / (1.0 - alpha));
+
+    const double us_per_block = L * 1e6 / rate;
+    const size_t min_blocks = static_cast<size_t>(std::ceil(min_us / us_per_block));
+    const size_t max_blocks = std::max(min_blocks, static_cast<size_t>(max_us / us_per_block));
+
+    nru_sample_ring_t *ring = get_sample_ring(0);
+    if (!ring)
+        return -1;
+    uint64_t seq = nru_ring_head(ring) - std::min<uint64_t>(ring_fill(ring), min_blocks * L);
+    thread_local std::vector<std::complex<float>> chunk;
+    thread_local std::vector<float> chunk_power;
+
+    const uint64_t start_us = get_time_us();
+    const uint64_t poll_us = static_cast<uint64_t>(std::max(1, min_us / 4));
+    double llr = 0.0, power_sum = 0.0;
+    size_t blocks = 0;
+    int decision = -1;
+
+    while (decision < 0) {
+        // Whole blocks only; a partial block is read again next round.
+        // Samples the producer overwrote before we got to them are skipped.
+        const uint64_t avail = nru_ring_head(ring) - seq;
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(avail / L, max_blocks - blocks)) * L;
+        if (want > 0) {
+            if (chunk.size() < want)
+                chunk.resize(want);
+            if (chunk_power.size() < want / L)
+                chunk_power.resize(want / L);
+            size_t got = nru_ring_read_from(ring, &seq, reinterpret_cast<float*>(chunk.data()),
+                                            want, nullptr);
+            const size_t n_blocks = nru_block_power_fc32(reinterpret_cast<const float*>(chunk.data()),
+                                                         got, L, chunk_power.data());
+            seq -= got - n_blocks * L;
+            for (size_t b = 0; b < n_blocks && decision < 0; b++) {
+                const double p = chunk_power[b];
+                power_sum += p;
+                llr += llr_bias + llr_gain * p;
+                blocks++;
+                if (llr >= upper)
+                    decision = 0;
+                else if (llr <= lower && blocks >= min_blocks)
+                    decision = 1;
+                else if (blocks >= max_blocks)
+                    break;
+            }
+        }
+        if (decision >= 0 || blocks >= max_blocks ||
+            get_time_us() - start_us >= static_cast<uint64_t>(max_us))
+            break;
+        nru_clock_sleep_us(poll_us);
+    }
+
+    cca_sprt_window_us.fetch_add(static_cast<uint64_t>(blocks * us_per_block), std::memory_order_relaxed);
+    if (decision >= 0) {
+        cca_sprt_early.fetch_add(1, std::memory_order_relaxed);
+        return decision;
+    }
+    if (blocks == 0)
+        return -1;
+    cca_sprt_full.fetch_add(1, std::memory_order_relaxed);
+    return (power_sum / blocks < mu_thr) ? 1 : 0;
+}
+
+void nru_set_cca_sequential(bool enabled, float false_free, float false_busy, int min_us) {
+    sprt_false_free.store((false_free > 0.0f && false_free < 0.5f) ? false_free : SPRT_DEFAULT_FALSE_FREE,
+                          std::memory_order_relaxed);
+    sprt_false_busy.store((false_busy > 0.0f && false_busy < 0.5f) ? false_busy : SPRT_DEFAULT_FALSE_BUSY,
+                          std::memory_order_relaxed);
+    sprt_min_us.store(min_us > 0 ? min_us : SPRT_DEFAULT_MIN_US, std::memory_order_relaxed);
+    sprt_enabled.store(enabled, std::memory_order_release);
+}
+
+void nru_set_ingest_conditioning(bool dc_removal, bool iq_balance, bool clip_check, float margin_db) {
+    cond_dc_removal.store(dc_removal, std::memory_order_relaxed);
+    cond_iq_balance.store(iq_balance, std::memory_order_relaxed);
+    cond_clip_check.store(clip_check, std::memory_order_relaxed);
+    ed_margin_db.store(margin_db > 0.0f ? margin_db : ED_MARGIN_DEFAULT_DB, std::memory_order_relaxed);
+    cond_dirty.store(true, std::memory_order_release);
+}
+
+void nru_set_ed_bandwidth(double bw_hz, double offset_hz) {
+    ed_bw_hz.store(bw_hz > 0.0 ? bw_hz : 0.0, std::memory_order_relaxed);
+    ed_offset_hz.store(offset_hz, std::memory_order_relaxed);
+    channelizer_dirty.store(true, std::memory_order_release);
+}
+
 /**
  * Generic LBT check with configurable sensing time
+ * Uses the sequential test when enabled, the fixed window otherwise
  * 
  * @param sensing_time_us: Sensing duration in microseconds
  * @return: 1 if channel FREE, 0 if BUSY, -1 on error
@@ -293,6 +939,16 @@ int nru_lbt_check_timed(int sensing_time_us) {
     }
     
     lbt_checks_performed.fetch_add(1, std::memory_order_relaxed);
+
+    if (sprt_enabled.load(std::memory_order_acquire)) {
+        int min_us = std::min(sprt_min_us.load(std::memory_order_relaxed), sensing_time_us);
+        int result = sequential_cca(min_us, sensing_time_us);
+        if (result >= 0) {
+            if (result == 0)
+                channel_busy_count.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+    }
     
     uint64_t start_time = get_time_us();
     float max_energy = noise_floor_dbm;
@@ -322,13 +978,9 @@ int nru_lbt_check_timed(int sensing_time_us) {
             return 0;  // BUSY
         }
         
-        // Sleep to avoid CPU starvation
-        int remaining_us = sensing_time_us - elapsed;
-        if (remaining_us > measurement_interval_us) {
-            std::this_thread::sleep_for(
-                std::chrono::microseconds(measurement_interval_us / 2)
-            );
-        }
+        // Sleep to avoid CPU starvation (always, so a simulated clock advances)
+        int remaining_us = sensing_time_us - static_cast<int>(elapsed);
+        nru_clock_sleep_us(std::max(1, std::min(remaining_us, measurement_interval_us / 2)));
     }
     
     // Final decision
@@ -383,9 +1035,7 @@ int nru_lbt_extended_cca(int defer_duration_us, int max_attempts) {
     
     for (int attempt = 0; attempt < max_attempts; attempt++) {
         // Initial defer period
-        std::this_thread::sleep_for(
-            std::chrono::microseconds(defer_duration_us)
-        );
+        nru_clock_sleep_us(defer_duration_us);
         
         // Check channel
         int result = nru_lbt_check_lbe();
@@ -395,7 +1045,7 @@ int nru_lbt_extended_cca(int defer_duration_us, int max_attempts) {
         
         // Random backoff (exponential)
         int backoff_us = (rand() % (1 << std::min(attempt, 5))) * 9;  // 9μs slots
-        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+        nru_clock_sleep_us(backoff_us);
     }
     
     return 0;  // Channel remained busy
@@ -406,83 +1056,172 @@ int nru_lbt_extended_cca(int defer_duration_us, int max_attempts) {
  * ============================================ */
 
 /**
- * Calibrate noise floor
- * Should be done with no signal present
+ * Busy airtime the classifier has attributed so far (all technologies)
  */
-void nru_calibrate_noise_floor(int samples) {
-    if (samples <= 0) samples = 100;
-
-    std::cout << "[NRU][UHD] Calibrating noise floor (" << samples
-              << " measurements)...\n";
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+static uint64_t classified_airtime_us(void) {
+    nru_tech_stats_t stats[NRU_TECH_COUNT];
+    nru_classifier_get_stats(stats);
+    uint64_t total = 0;
+    for (int t = 0; t < NRU_TECH_COUNT; t++)
+        total += stats[t].airtime_us;
+    return total;
+}
 
-    double sum = 0.0;
-    int valid_count = 0;
-    last_measurement_time_us.store(0, std::memory_order_relaxed);
+/**
+ * Early-stopping noise floor estimate
+ * Welford mean/variance over energy readings taken on fresh, burst-free
+ * samples below the configured threshold; stops
+ * once the 95% confidence half-width drops below CAL_CI_HALF_WIDTH_DB.
+ * @param max_measurements: Upper bound on readings
+ * @param mean_dbm, ci_db: Estimate and its 95% half-width
+ * @return: Readings used (0 if no samples arrived or cancelled)
+ */
+static int estimate_noise_floor(int max_measurements, double *mean_dbm, double *ci_db) {
+    int n = 0;
+    double mean = 0.0, m2 = 0.0, ci = INFINITY;
+    uint64_t last_received = total_samples_received.load(std::memory_order_relaxed);
+    uint64_t last_airtime = classified_airtime_us();
+    uint64_t idle_since = get_time_us();
+
+    while (n < max_measurements && !calibration_cancel.load(std::memory_order_relaxed)) {
+        nru_clock_sleep_us(CAL_INTERVAL_US);
+
+        // Only count readings that saw new samples
+        uint64_t received = total_samples_received.load(std::memory_order_relaxed);
+        if (received == last_received) {
+            if (get_time_us() - idle_since > CAL_STREAM_TIMEOUT_US) break;
+            continue;
+        }
+        last_received = received;
+        idle_since = get_time_us();
 
-    for (int i = 0; i < samples; i++) {
+        // A reading at or above the configured threshold, or one during
+        // which the classifier segmented a burst, is not noise
         float energy = nru_get_current_energy_dbm_no_cache();
-        if (std::isfinite(energy) && energy > -120.0f && energy < -50.0f) {
-            sum += energy;
-            valid_count++;
+        uint64_t airtime = classified_airtime_us();
+        bool burst = (airtime != last_airtime);
+        last_airtime = airtime;
+        if (!std::isfinite(energy) || energy <= -120.0f ||
+            energy >= ed_threshold_cap_dbm.load(std::memory_order_relaxed) || burst)
+            continue;
+
+        n++;
+        double delta = energy - mean;
+        mean += delta / n;
+        m2 += delta * (energy - mean);
+        if (n >= CAL_MIN_MEASUREMENTS) {
+            ci = 1.96 * std::sqrt(m2 / (n - 1) / n);
+            if (ci < CAL_CI_HALF_WIDTH_DB) break;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
-    if (valid_count > samples / 2) {
-        noise_floor_dbm = static_cast<float>(sum / valid_count);
-        noise_calibrated = true;
-        nru_config_ed_threshold_dbm = noise_floor_dbm + 8.0f;
-        std::cout << "[NRU][UHD]  Noise floor: " << noise_floor_dbm
-                  << " dBm (from " << valid_count << " valid samples)\n";
-        std::cout << "[NRU][UHD]  ED threshold: "
-                  << nru_config_ed_threshold_dbm << " dBm\n";
-    } else {
-        std::cerr << "[NRU][UHD]   Calibration failed (only "
-                  << valid_count << " valid samples)\n";
-        return;
-    }
+    *mean_dbm = mean;
+    *ci_db = ci;
+    return (n >= CAL_MIN_MEASUREMENTS) ? n : 0;
+}
 
-    // ------------------------------------------------------------
-    // 🔧 AUTO-CALIBRATION against laptop Wi-Fi RSSI
-    // ------------------------------------------------------------
+/**
+ * Swap in a new noise floor and the threshold derived from it
+ * The threshold never rises above the configured one. Readers of the
+ * plain float globals (nru_lbt.c via nru_get_ed_threshold(), the ED
+ * checks) see either the old or the new value, never a torn one.
+ */
+static void publish_noise_floor(float floor_dbm) {
+    float threshold_dbm = std::min(floor_dbm + ed_margin_db.load(std::memory_order_relaxed),
+                                   ed_threshold_cap_dbm.load(std::memory_order_relaxed));
+    __atomic_store(&noise_floor_dbm, &floor_dbm, __ATOMIC_RELAXED);
+    __atomic_store(&nru_config_ed_threshold_dbm, &threshold_dbm, __ATOMIC_RELEASE);
+    __atomic_store_n(&noise_calibrated, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Derive the dBFS -> dBm offset from the laptop's Wi-Fi link RSSI
+ */
+static void calibrate_offset_from_wifi_rssi(void) {
     FILE *pipe = popen(
         "iw dev wlp0s20f3 link | grep 'signal:' | awk '{print $2}'", "r");
-    if (pipe) {
-        float wifi_rssi_dbm = NAN;
-        fscanf(pipe, "%f", &wifi_rssi_dbm);
-        pclose(pipe);
-
-        if (std::isfinite(wifi_rssi_dbm)) {
-            // Measure current mean in dBFS (before offset)
-            std::unique_lock<std::mutex> lock(buffer_mutex, std::defer_lock);
-            if (lock.try_lock() && sample_buffer.size() > 500) {
-                size_t n = std::min((size_t)500, sample_buffer.size());
-                size_t start = sample_buffer.size() - n;
-                double sum_power = 0.0;
-                for (size_t j = start; j < sample_buffer.size(); ++j)
-                    sum_power += std::norm(sample_buffer[j]);
-                double dbfs = 10.0 * std::log10(std::max(sum_power / n, 1e-12));
-                calibration_offset_db = wifi_rssi_dbm - dbfs;
-
-                std::cout << "[NRU][CAL]  Auto-calibration from Wi-Fi RSSI\n"
-                          << "    Wi-Fi RSSI : " << wifi_rssi_dbm << " dBm\n"
-                          << "    Measured   : " << dbfs << " dBFS\n"
-                          << "    Offset     : " << calibration_offset_db
-                          << " dB\n";
-            }
-        } else {
-            std::cerr << "[NRU][CAL]   Could not parse Wi-Fi RSSI\n";
-        }
-    } else {
+    if (!pipe) {
         std::cerr << "[NRU][CAL]   Failed to execute iw command\n";
+        return;
+    }
+    float wifi_rssi_dbm = NAN;
+    fscanf(pipe, "%f", &wifi_rssi_dbm);
+    pclose(pipe);
+
+    if (!std::isfinite(wifi_rssi_dbm)) {
+        std::cerr << "[NRU][CAL]   Could not parse Wi-Fi RSSI\n";
+        return;
     }
 
+    // Measure current mean in dBFS (before offset)
+    const size_t window = win_fast.load(std::memory_order_relaxed);
+    double mean_power = 0.0;
+    if (latest_mean_power(window, window, &mean_power)) {
+        double dbfs = 10.0 * std::log10(std::max(mean_power, 1e-12));
+        calibration_offset_db = wifi_rssi_dbm - dbfs;
+
+        std::cout << "[NRU][CAL]  Auto-calibration from Wi-Fi RSSI\n"
+                  << "    Wi-Fi RSSI : " << wifi_rssi_dbm << " dBm\n"
+                  << "    Measured   : " << dbfs << " dBFS\n"
+                  << "    Offset     : " << calibration_offset_db
+                  << " dB\n";
+    }
+}
+
+/**
+ * Calibrate noise floor (blocking)
+ * Should be done with no signal present
+ * @param samples: Maximum number of readings (stops early once converged)
+ */
+void nru_calibrate_noise_floor(int samples) {
+    if (samples <= 0) samples = 100;
+
+    std::cout << "[NRU][UHD] Calibrating noise floor (up to " << samples
+              << " measurements)...\n";
+
+    uint64_t t0 = get_time_us();
+    double mean = 0.0, ci = 0.0;
+    int used = estimate_noise_floor(samples, &mean, &ci);
+    if (used == 0) {
+        std::cerr << "[NRU][UHD]   Calibration failed (no valid samples)\n";
+        return;
+    }
+
+    publish_noise_floor(static_cast<float>(mean));
+    std::cout << "[NRU][UHD]  Noise floor: " << noise_floor_dbm << " ± " << ci
+              << " dBm (" << used << " readings, " << (get_time_us() - t0) / 1000 << " ms)\n";
+    std::cout << "[NRU][UHD]  ED threshold: "
+              << nru_config_ed_threshold_dbm << " dBm\n";
+
+    calibrate_offset_from_wifi_rssi();
+
     std::cout << "[NRU][UHD]  Final calibration offset: "
               << calibration_offset_db << " dB\n";
 }
 
+/**
+ * Run nru_calibrate_noise_floor() on the sensing worker
+ * Returns at once; the configured threshold applies until the estimate
+ * converges and is swapped in.
+ */
+void nru_start_noise_calibration(int max_measurements) {
+    bool expected = false;
+    if (!calibration_running.compare_exchange_strong(expected, true))
+        return;
+    if (sensing_thread.joinable())
+        sensing_thread.join();
+
+    calibration_cancel.store(false, std::memory_order_relaxed);
+    sensing_thread = std::thread([max_measurements]() {
+        nru_calibrate_noise_floor(max_measurements);
+        calibration_running.store(false, std::memory_order_release);
+    });
+}
+
+bool nru_calibration_in_progress(void) {
+    return calibration_running.load(std::memory_order_acquire);
+}
+
 /**
  * Set manual calibration offset
  */
@@ -490,14 +1229,40 @@ void nru_set_calibration_offset(float offset_db) {
     calibration_offset_db = offset_db;
     std::cout << "[NRU][UHD] Calibration offset: " << offset_db << " dB\n";
 }
+/**
+ * Copy buffered samples in stream order
+ * Has its own ring reader (opened on the first call, starting from the
+ * buffered history), so it no longer takes samples away from the ED.
+ * @return: Samples copied (single consumer)
+ */
 int nru_read_samples(std::complex<float>* dst, int max_count) {
-    std::lock_guard<std::mutex> lock(buffer_mutex);
-    int n = std::min<int>(max_count, sample_buffer.size());
-    for (int i = 0; i < n; ++i) {
-        dst[i] = sample_buffer.front();
-        sample_buffer.pop_front();
+    nru_sample_ring_t *ring = get_sample_ring(0);
+    if (!ring || !dst || max_count <= 0) return 0;
+    int id = read_samples_reader.load(std::memory_order_acquire);
+    if (id < 0) {
+        std::lock_guard<std::mutex> lock(reader_open_mutex);
+        id = read_samples_reader.load(std::memory_order_relaxed);
+        if (id < 0) {
+            id = nru_ring_reader_open(ring, ring_fill(ring), "read_samples");
+            if (id < 0) return 0;
+            read_samples_reader.store(id, std::memory_order_release);
+        }
     }
-    return n;
+    return static_cast<int>(nru_ring_read(ring, id, reinterpret_cast<float*>(dst),
+                                          static_cast<size_t>(max_count)));
+}
+
+/**
+ * Sample ring shared by the ED and any other detector
+ * Register a reader with nru_ring_reader_open(); NULL before the first
+ * attach or ingest.
+ */
+struct nru_sample_ring *nru_get_sample_ring(void) {
+    return get_sample_ring(0);
+}
+
+size_t nru_get_buffer_size(void) {
+    return ring_fill(get_sample_ring(0));
 }
 
 /**
@@ -507,31 +1272,20 @@ void nru_auto_calibrate_offset(float known_power_dbm) {
     std::cout << "[NRU][UHD] Auto-calibrating with " << known_power_dbm 
               << " dBm reference...\n";
     
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    nru_clock_sleep_us(200000);
     
     double sum_dbfs = 0.0;
     int count = 0;
     
     for (int i = 0; i < 50; i++) {
-        std::unique_lock<std::mutex> lock(buffer_mutex, std::defer_lock);
-        if (!lock.try_lock()) continue;
-        
-        if (sample_buffer.size() < 500) continue;
-        
-        size_t n = std::min(static_cast<size_t>(500), sample_buffer.size());
-        size_t start = sample_buffer.size() - n;
-        
-        double sum_power = 0.0;
-        for (size_t j = start; j < sample_buffer.size(); ++j) {
-            sum_power += std::norm(sample_buffer[j]);
+        const size_t n = win_fast.load(std::memory_order_relaxed);
+        double mean_power = 0.0;
+        if (latest_mean_power(n, n, &mean_power)) {
+            double dbfs = 10.0 * std::log10(std::max(mean_power, 1e-12));
+            sum_dbfs += dbfs;
+            count++;
         }
-        
-        double dbfs = 10.0 * std::log10(std::max(sum_power / n, 1e-12));
-        sum_dbfs += dbfs;
-        count++;
-        
-        lock.unlock();
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        nru_clock_sleep_us(10000);
     }
     
     if (count > 0) {
@@ -552,12 +1306,15 @@ void nru_auto_calibrate_offset(float known_power_dbm) {
  * ============================================ */
 
 void nru_set_ed_threshold(float threshold_dbm) {
-    nru_config_ed_threshold_dbm = threshold_dbm;
+    ed_threshold_cap_dbm.store(threshold_dbm, std::memory_order_relaxed);
+    __atomic_store(&nru_config_ed_threshold_dbm, &threshold_dbm, __ATOMIC_RELEASE);
     std::cout << "[NRU][UHD] ED threshold: " << threshold_dbm << " dBm\n";
 }
 
 float nru_get_ed_threshold(void) {
-    return nru_config_ed_threshold_dbm;
+    float threshold_dbm;
+    __atomic_load(&nru_config_ed_threshold_dbm, &threshold_dbm, __ATOMIC_ACQUIRE);
+    return threshold_dbm;
 }
 
 float nru_get_noise_floor(void) {
@@ -587,8 +1344,8 @@ static void sensing_stream_worker() {
         
         uhd::rx_streamer::sptr sensing_rx_stream = global_usrp->get_rx_stream(stream_args);
         
-        // Buffer for receiving samples (optimized size)
-        const size_t samps_per_buff = 1024;  // ~67μs at 15.36 MSPS
+        // Buffer for receiving samples (RECV_BLOCK_US at the RX rate)
+        const size_t samps_per_buff = samples_for_us(RECV_BLOCK_US, global_usrp->get_rx_rate(0));
         std::vector<std::complex<float>> buff(samps_per_buff);
         
         // Metadata for stream control
@@ -607,7 +1364,7 @@ static void sensing_stream_worker() {
         
         uint64_t total_received = 0;
         uint64_t error_count = 0;
-        auto last_report = std::chrono::steady_clock::now();
+        uint64_t last_report_us = get_time_us();
         
         // Main sensing loop
         while (sensing_thread_running.load(std::memory_order_relaxed)) {
@@ -645,13 +1402,13 @@ static void sensing_stream_worker() {
             }
             
             // Periodic status report (every 10 seconds)
-            auto now = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::seconds>(now - last_report).count() >= 10) {
+            uint64_t now = get_time_us();
+            if (now - last_report_us >= 10000000ULL) {
                 float mbytes = (total_received * sizeof(std::complex<float>)) / (1024.0f * 1024.0f);
                 std::cout << "[NRU][STREAM]  Received " << total_received 
                           << " samples (" << std::fixed << std::setprecision(2) 
                           << mbytes << " MB) | Errors: " << error_count << "\n";
-                last_report = now;
+                last_report_us = now;
             }
         }
         
@@ -713,6 +1470,189 @@ bool nru_is_sensing_active(void) {
     return sensing_thread_running.load(std::memory_order_relaxed);
 }
 
+/* ============================================
+ *  SPECTRUM MONITOR
+ * ============================================ */
+
+/**
+ * PSD frames from the sample ring to shared memory
+ * Reads with its own ring reader, so it never holds up the ingest thread
+ * or the ED; if it falls behind it loses samples, not the other way round.
+ * With spectrum_avg set only the newest spectrum_avg FFTs of each frame
+ * period are computed (bounded CPU at any RX rate).
+ */
+static void spectrum_worker() {
+    nru_sample_ring_t *ring = get_sample_ring(buffer_capacity.load(std::memory_order_relaxed));
+    nru_spectrum_t *spec = nru_spectrum_create(nullptr, spectrum_fft_size.load(std::memory_order_relaxed));
+    if (!spec) {
+        std::cerr << "[NRU][SPECTRUM]  Cannot create shared memory " << NRU_SPECTRUM_SHM_NAME << "\n";
+        spectrum_running.store(false, std::memory_order_relaxed);
+        return;
+    }
+    const int id = nru_ring_reader_open(ring, 0, "spectrum");
+    if (id < 0) {
+        std::cerr << "[NRU][SPECTRUM]  No free sample ring reader\n";
+        nru_spectrum_destroy(spec);
+        spectrum_running.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t n = static_cast<size_t>(nru_spectrum_fft_size(spec));
+    const double rate = spectrum_rate_hz.load(std::memory_order_relaxed);
+    const uint64_t period_us = static_cast<uint64_t>(1e6 / rate);
+    std::vector<std::complex<float>> chunk(SPECTRUM_READ_CHUNK);
+    uint64_t last_overrun = 0;
+    std::cout << "[NRU][SPECTRUM]  " << n << "-point PSD at " << rate << " Hz -> /dev/shm"
+              << NRU_SPECTRUM_SHM_NAME << "\n";
+
+    while (spectrum_running.load(std::memory_order_relaxed)) {
+        nru_clock_sleep_us(period_us);
+
+        // Centre of the analysed stream: the channelizer moves the LBT channel to DC
+        double center = rx_center_hz.load(std::memory_order_relaxed);
+        if (channelizer_taps.load(std::memory_order_relaxed) > 0)
+            center += ed_offset_hz.load(std::memory_order_relaxed);
+        nru_spectrum_set_stream(spec, buffer_rate_hz.load(std::memory_order_relaxed), center,
+                                calibration_offset_db, nru_config_ed_threshold_dbm);
+
+        // Skip to the newest spectrum_avg FFTs
+        uint64_t lag = 0, overrun = 0;
+        nru_ring_reader_stats(ring, id, &lag, &overrun);
+        const size_t avg = static_cast<size_t>(spectrum_avg.load(std::memory_order_relaxed));
+        if (avg > 0 && lag > avg * n) {
+            nru_ring_span_t span;
+            nru_ring_peek(ring, id, static_cast<size_t>(lag - avg * n), &span);
+            nru_ring_release(ring, id, &span);
+            nru_spectrum_restart(spec);
+        }
+
+        // What was there at the frame boundary only, so a producer faster
+        // than the FFTs cannot keep this loop from publishing
+        uint64_t budget = (avg > 0) ? std::min<uint64_t>(lag, avg * n) : lag;
+        size_t got;
+        while (budget > 0 &&
+               (got = nru_ring_read(ring, id, reinterpret_cast<float*>(chunk.data()),
+                                    static_cast<size_t>(std::min<uint64_t>(budget, chunk.size())))) > 0) {
+            budget -= std::min<uint64_t>(budget, got);
+            nru_ring_reader_stats(ring, id, nullptr, &overrun);
+            if (overrun != last_overrun) {
+                nru_spectrum_restart(spec);        // Not contiguous with the partial FFT
+                last_overrun = overrun;
+            }
+            nru_spectrum_feed(spec, reinterpret_cast<const float*>(chunk.data()), got);
+        }
+        if (nru_spectrum_publish(spec, get_time_us()))
+            spectrum_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    nru_ring_reader_close(ring, id);
+    nru_spectrum_destroy(spec);
+}
+
+static void start_spectrum_monitor(void) {
+    if (spectrum_fft_size.load(std::memory_order_relaxed) <= 0 || !global_usrp)
+        return;
+    bool expected = false;
+    if (!spectrum_running.compare_exchange_strong(expected, true))
+        return;
+    if (spectrum_thread.joinable())
+        spectrum_thread.join();
+    spectrum_thread = std::thread(spectrum_worker);
+}
+
+static void stop_spectrum_monitor(void) {
+    spectrum_running.store(false, std::memory_order_relaxed);
+    if (spectrum_thread.joinable())
+        spectrum_thread.join();
+}
+
+void nru_set_spectrum_monitor(int fft_size, int n_avg, double frame_rate_hz) {
+    stop_spectrum_monitor();
+    spectrum_fft_size.store(std::max(fft_size, 0), std::memory_order_relaxed);
+    spectrum_avg.store(std::max(n_avg, 0), std::memory_order_relaxed);
+    spectrum_rate_hz.store(frame_rate_hz > 0.0 ? frame_rate_hz : SPECTRUM_DEFAULT_RATE_HZ,
+                           std::memory_order_relaxed);
+    start_spectrum_monitor();
+}
+
+/**
+ * Technology classification from the sample ring
+ * The ring holds the channelized stream without our own TX, so bursts are
+ * attributed on the LBT channel only. Runs carry across reads; a gap in
+ * the stream (overrun, a masked range) or a rate change ends the open run.
+ * Sample times are estimated from the reader lag at the time of the read.
+ */
+static void classifier_worker() {
+    nru_sample_ring_t *ring = get_sample_ring(buffer_capacity.load(std::memory_order_relaxed));
+    const int id = nru_ring_reader_open(ring, 0, "classifier");
+    if (id < 0) {
+        std::cerr << "[NRU][CLASSIFIER]  No free sample ring reader\n";
+        classifier_running.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    std::vector<std::complex<float>> chunk(CLASSIFIER_READ_CHUNK);
+    double rate = 0.0;
+    uint64_t last_overrun = 0;
+    uint64_t last_masked = total_samples_masked.load(std::memory_order_relaxed);
+
+    while (classifier_running.load(std::memory_order_relaxed)) {
+        nru_clock_sleep_us(CLASSIFIER_POLL_US);
+
+        const double r = buffer_rate_hz.load(std::memory_order_relaxed);
+        if (r <= 0.0) continue;
+        if (r != rate) {
+            nru_classifier_configure(r);
+            rate = r;
+        }
+        const uint64_t masked = total_samples_masked.load(std::memory_order_relaxed);
+        if (masked != last_masked) {
+            nru_classifier_flush();        // Our TX was cut out of the stream
+            last_masked = masked;
+        }
+
+        const float cal = calibration_offset_db;
+        const float busy_dbfs = nru_get_ed_threshold() - cal;
+        uint64_t lag = 0, overrun = 0;
+        nru_ring_reader_stats(ring, id, &lag, &overrun);
+        const uint64_t now_us = get_time_us();
+        size_t got;
+        while (lag > 0 &&
+               (got = nru_ring_read(ring, id, reinterpret_cast<float*>(chunk.data()),
+                                    static_cast<size_t>(std::min<uint64_t>(lag, chunk.size())))) > 0) {
+            nru_ring_reader_stats(ring, id, nullptr, &overrun);
+            if (overrun != last_overrun) {
+                nru_classifier_flush();    // Not contiguous with the open run
+                last_overrun = overrun;
+            }
+            const uint64_t ago_us = static_cast<uint64_t>(lag * 1e6 / rate);
+            nru_classify_block(reinterpret_cast<const float*>(chunk.data()), got,
+                               now_us - std::min(now_us, ago_us), busy_dbfs, cal);
+            lag -= std::min<uint64_t>(lag, got);
+        }
+    }
+
+    nru_classifier_flush();
+    nru_ring_reader_close(ring, id);
+}
+
+static void start_classifier(void) {
+    if (!global_usrp)
+        return;
+    bool expected = false;
+    if (!classifier_running.compare_exchange_strong(expected, true))
+        return;
+    if (classifier_thread.joinable())
+        classifier_thread.join();
+    classifier_thread = std::thread(classifier_worker);
+}
+
+static void stop_classifier(void) {
+    classifier_running.store(false, std::memory_order_relaxed);
+    if (classifier_thread.joinable())
+        classifier_thread.join();
+}
+
 /* ============================================
  *  INITIALIZATION & CLEANUP
  * ============================================ */
@@ -727,6 +1667,8 @@ void nru_attach_usrp(void *priv) {
         return;
     }
     
+    nru_clock_init();
+
     global_usrp = *static_cast<uhd::usrp::multi_usrp::sptr*>(priv);
     std::cout << "[NRU][UHD]  Attached to USRP device\n";
     
@@ -744,11 +1686,26 @@ void nru_attach_usrp(void *priv) {
         std::cout << "[NRU][UHD] RX gain: " << rx_gain << " dB\n";
     } catch (...) {}
     
-    // Initialize buffer
-    {
-        std::lock_guard<std::mutex> lock(buffer_mutex);
-        sample_buffer.clear();
-    }
+    // Technology classifier follows the RX rate
+    try {
+        double rx_rate = global_usrp->get_rx_rate(0);
+        nru_classifier_reset_stats();
+        buffer_rate_hz.store(rx_rate, std::memory_order_relaxed);
+        derive_windows(rx_rate);
+        nru_sample_ring_t *ring = get_sample_ring(buffer_capacity.load(std::memory_order_relaxed));
+        ring_floor.store(nru_ring_head(ring), std::memory_order_relaxed);
+        const size_t block_len = samples_for_us(1.0, rx_rate);
+        std::cout << "[NRU][UHD] Sensing windows at " << (rx_rate / 1e6) << " MSps: ED "
+                  << win_fast.load() << "/" << win_accurate.load() << " samples, buffer "
+                  << nru_ring_capacity(ring)
+                  << " samples, 1 us block " << block_len
+                  << (nru_dsp_block_len_specialized(block_len) ? " (specialized)\n" : " (generic)\n");
+        channelizer_dirty.store(true, std::memory_order_release);
+        cond_dirty.store(true, std::memory_order_release);
+        tx_rate_hz.store(global_usrp->get_tx_rate(0), std::memory_order_relaxed);
+        rx_rate_hz.store(rx_rate, std::memory_order_relaxed);
+        rx_center_hz.store(global_usrp->get_rx_freq(0), std::memory_order_relaxed);
+    } catch (...) {}
     
     // Reset state
     cached_energy_dbm.store(noise_floor_dbm, std::memory_order_relaxed);
@@ -756,6 +1713,8 @@ void nru_attach_usrp(void *priv) {
     total_samples_received.store(0, std::memory_order_relaxed);
     total_samples_dropped.store(0, std::memory_order_relaxed);
     buffer_overflow_count.store(0, std::memory_order_relaxed);
+    total_samples_masked.store(0, std::memory_order_relaxed);
+    total_samples_clipped.store(0, std::memory_order_relaxed);
     lbt_checks_performed.store(0, std::memory_order_relaxed);
     channel_busy_count.store(0, std::memory_order_relaxed);
     
@@ -763,6 +1722,8 @@ void nru_attach_usrp(void *priv) {
     
     // Auto-start sensing stream
     nru_start_sensing_stream();
+    start_spectrum_monitor();
+    start_classifier();
 }
 
 /**
@@ -773,12 +1734,15 @@ void nru_cleanup(void) {
     
     // Stop sensing stream first
     nru_stop_sensing_stream();
+    stop_spectrum_monitor();
+    stop_classifier();
+    nru_coord_detach();                 // Co-located peers stop counting on us
+    calibration_cancel.store(true, std::memory_order_relaxed);
+    if (sensing_thread.joinable())
+        sensing_thread.join();
     
-    // Clear buffer
-    {
-        std::lock_guard<std::mutex> lock(buffer_mutex);
-        sample_buffer.clear();
-    }
+    // Clear buffer (the ring itself stays: readers may hold it)
+    ring_floor.store(nru_ring_head(get_sample_ring(0)), std::memory_order_relaxed);
     
     global_usrp = nullptr;
     std::cout << "[NRU][UHD]  Cleanup complete\n";
@@ -827,6 +1791,55 @@ void nru_print_stats(void) {
               << " | Busy count: " << busy_count
               << " (" << busy_rate << "% busy)\n";
     std::cout << "[NRU][STATS] Drop rate: " << drop_rate << "%\n";
+    std::cout << "[NRU][STATS] Own-TX masked: " << total_samples_masked.load()
+              << " samples | Settling tail: " << nru_get_tx_settling_us()
+              << " µs | RF turnaround: " << nru_get_rf_turnaround_us() << " µs\n";
+    std::cout << "[NRU][STATS] Ingest: DC " << ingest_dc_dbfs.load() << " dBFS"
+              << " | IQ imbalance " << ingest_iq_gain_db.load() << " dB / "
+              << ingest_iq_phase_deg.load() << " deg | Clipped: " << total_samples_clipped.load()
+              << " samples\n";
+    if (nru_sample_ring_t *ring = get_sample_ring(0)) {
+        std::cout << "[NRU][STATS] Sample ring: " << ring_fill(ring) << "/"
+                  << nru_ring_capacity(ring) << " samples";
+        for (int id = 0; id < NRU_RING_MAX_READERS; id++) {
+            uint64_t lag = 0, overrun = 0;
+            if (const char *name = nru_ring_reader_stats(ring, id, &lag, &overrun))
+                std::cout << " | " << name << " lag " << lag << " overrun " << overrun;
+        }
+        std::cout << "\n";
+    }
+    if (channelizer_taps.load() > 0)
+        std::cout << "[NRU][STATS] ED channelizer: " << (ed_bw_hz.load() / 1e6) << " MHz | "
+                  << channelizer_taps.load() << " taps | decimation " << channelizer_decim.load()
+                  << " | " << (buffer_rate_hz.load() / 1e6) << " MSps\n";
+    if (spectrum_running.load())
+        std::cout << "[NRU][STATS] Spectrum monitor: " << spectrum_frames.load() << " frames ("
+                  << spectrum_fft_size.load() << " bins) -> /dev/shm" << NRU_SPECTRUM_SHM_NAME << "\n";
+    nru_airtime_t air;
+    nru_airtime_get(&air);
+    if (air.n_horizons > 0) {
+        std::cout << "[NRU][STATS] Airtime:";
+        for (uint32_t k = 0; k < air.n_horizons; k++) {
+            std::cout << " " << (100.0 * air.duty[k]) << "% / " << air.horizon_ms[k] << " ms";
+            if (air.max_duty[k] > 0.0 && air.max_duty[k] < 1.0)
+                std::cout << " (cap " << (100.0 * air.max_duty[k]) << "%)";
+        }
+        std::cout << " | Grants " << air.granted << " full / " << air.shortened << " shortened / "
+                  << air.denied << " denied\n";
+    }
+    uint64_t sprt_early = cca_sprt_early.load(), sprt_full = cca_sprt_full.load();
+    if (sprt_early + sprt_full > 0)
+        std::cout << "[NRU][STATS] Sequential CCA: " << sprt_early << " early / "
+                  << sprt_full << " full window | mean window "
+                  << (cca_sprt_window_us.load() / (sprt_early + sprt_full)) << " µs\n";
+
+    nru_tech_stats_t tech[NRU_TECH_COUNT];
+    nru_classifier_get_stats(tech);
+    std::cout << "[NRU][STATS] Occupancy:";
+    for (int t = 0; t < NRU_TECH_COUNT; t++)
+        std::cout << " " << nru_tech_name(static_cast<nru_tech_t>(t)) << " "
+                  << (100.0 * tech[t].occupancy) << "% (" << tech[t].bursts << ")";
+    std::cout << "\n";
     std::cout << "[NRU][STATS] ==========================================\n\n";
 }
    
@@ -840,6 +1853,11 @@ void nru_reset_stats(void) {
     buffer_overflow_count.store(0);
     lbt_checks_performed.store(0);
     channel_busy_count.store(0);
+    total_samples_masked.store(0);
+    cca_sprt_early.store(0);
+    cca_sprt_full.store(0);
+    cca_sprt_window_us.store(0);
+    nru_classifier_reset_stats();
     std::cout << "[NRU][UHD]  Statistics counters reset\n";
 }
 
@@ -847,8 +1865,7 @@ void nru_reset_stats(void) {
  * Force flush of buffered samples
  */
 void nru_clear_buffer(void) {
-    std::lock_guard<std::mutex> lock(buffer_mutex);
-    sample_buffer.clear();
+    ring_floor.store(nru_ring_head(get_sample_ring(0)), std::memory_order_relaxed);
     std::cout << "[NRU][UHD]  Buffer cleared\n";
 }
 
@@ -861,7 +1878,7 @@ void nru_debug_energy_probe(int count) {
     for (int i = 0; i < count; i++) {
         float e = nru_get_current_energy_dbm_no_cache();
         std::cout << "  [" << i << "] " << e << " dBm\n";
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        nru_clock_sleep_us(100000);
     }
 }
 